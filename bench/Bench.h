@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace JCore::Bench {
+    using BenchFunc = void(*)();
+
+    struct BenchCase {
+        const char* name;
+        BenchFunc func;
+    };
+
+    std::vector<BenchCase>& getBenchmarks();
+
+    struct BenchRegistrar {
+        BenchRegistrar(const char* name, BenchFunc func) { getBenchmarks().push_back({ name, func }); }
+    };
+
+    template<typename Func>
+    double timeMs(Func&& func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<typename Func>
+    double timeNs(Func&& func, size_t ops) {
+        return timeMs(func) * 1000000.0 / double(ops > 0 ? ops : 1);
+    }
+
+    //Keeps results the optimizer would otherwise drop along with the work that produced them
+    inline void keep(uint64_t value) {
+        static volatile uint64_t sink{ 0 };
+        sink = sink + value;
+    }
+}
+
+//Defines a benchmark that prints its own results, benchmarks register themselves before main runs
+#define JCORE_BENCH(NAME) \
+    static void NAME(); \
+    static ::JCore::Bench::BenchRegistrar NAME##_registrar(#NAME, NAME); \
+    static void NAME()
@@ -0,0 +1,25 @@
+#include "Bench.h"
+#include <J-Core/Log.h>
+#include <cstring>
+
+namespace JCore::Bench {
+    std::vector<BenchCase>& getBenchmarks() {
+        static std::vector<BenchCase> benchmarks{};
+        return benchmarks;
+    }
+}
+
+//Runs every benchmark, or only the ones whose name contains the first argument
+int main(int argc, char** argv) {
+    JCore::Log::init();
+
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    for (const auto& bench : JCore::Bench::getBenchmarks()) {
+        if (filter && !strstr(bench.name, filter)) { continue; }
+
+        printf("== %s\n", bench.name);
+        bench.func();
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "Bench.h"
+#include <J-Core/IO/BitStream.h>
+#include <J-Core/IO/MemoryStream.h>
+#include <random>
+
+namespace {
+    static constexpr size_t SYMBOLS = 40000000;
+    static constexpr uint32_t PEEK_BITS = 12;
+
+    struct Symbol {
+        uint32_t value;
+        uint32_t bits;
+    };
+}
+
+JCORE_BENCH(bitStreamThroughput) {
+    //Symbols of 1-16 bits, the range Huffman coded data lives in
+    std::mt19937 rng(46);
+    std::vector<Symbol> symbols(SYMBOLS);
+    uint64_t totalBits = 0, valueSum = 0;
+    for (auto& symbol : symbols) {
+        symbol.bits = 1 + rng() % 16;
+        symbol.value = rng() & ((1U << symbol.bits) - 1);
+        totalBits += symbol.bits;
+        valueSum += symbol.value;
+    }
+
+    printf("%zu symbols of 1-16 bits (%.1f MB) through a MemoryStream\n", SYMBOLS, totalBits / 8.0 / 1000000.0);
+    for (const auto order : { BitStream::BitOrder::MSBFirst, BitStream::BitOrder::LSBFirst }) {
+        MemoryStream stream(size_t(totalBits / 8 + 16), true);
+
+        const double putMs = JCore::Bench::timeMs([&]() {
+            BitStream bits(stream, order);
+            for (const auto& symbol : symbols) {
+                bits.putBits(symbol.value, symbol.bits);
+            }
+            bits.flush();
+        });
+
+        stream.seek(0, SEEK_SET);
+        uint64_t readSum = 0;
+        const double getMs = JCore::Bench::timeMs([&]() {
+            BitStream bits(stream, order);
+            for (const auto& symbol : symbols) {
+                readSum += bits.getBits(symbol.bits);
+            }
+        });
+
+        //Table driven decoding peeks a fixed window & only consumes the length of the code it found
+        stream.seek(0, SEEK_SET);
+        const double peekMs = JCore::Bench::timeMs([&]() {
+            BitStream bits(stream, order);
+            uint64_t sum = 0;
+            for (const auto& symbol : symbols) {
+                sum += bits.peekBits(PEEK_BITS);
+                bits.consumeBits(symbol.bits);
+            }
+            JCore::Bench::keep(sum);
+        });
+
+        printf("  %s: putBits %.2f Gbit/s, getBits %.2f Gbit/s, peek%u/consume %.0f M symbols/s\n",
+            order == BitStream::BitOrder::MSBFirst ? "MSB" : "LSB",
+            totalBits / putMs / 1000000.0, totalBits / getMs / 1000000.0, PEEK_BITS, SYMBOLS / peekMs / 1000.0);
+        if (readSum != valueSum) {
+            printf("  Read back different values than were written!\n");
+        }
+    }
+}
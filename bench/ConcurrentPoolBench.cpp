@@ -0,0 +1,91 @@
+#include "Bench.h"
+#include <J-Core/Util/ConcurrentPoolAllocator.h>
+#include <J-Core/Util/PoolAllocator.h>
+#include <mutex>
+#include <thread>
+
+using namespace JCore;
+
+namespace {
+    struct BenchNode {
+        uint64_t values[5]{};
+    };
+
+    static constexpr size_t TOTAL_PAIRS = 1 << 23;
+    static constexpr size_t WINDOW = 64;
+    static constexpr size_t REMOTE_OBJECTS = 1 << 20;
+
+    //Starts 'threadCount' threads running func(thread) & returns the wall time until all of them are done
+    template<typename Func>
+    double runThreads(size_t threadCount, Func&& func) {
+        return Bench::timeMs([&]() {
+            std::vector<std::thread> threads{};
+            threads.reserve(threadCount);
+            for (size_t t = 0; t < threadCount; t++) {
+                threads.emplace_back([&func, t]() { func(t); });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        });
+    }
+
+    //Every thread keeps a small window of live objects & replaces the oldest one each step, one alloc/free pair per step
+    template<typename Alloc, typename Free>
+    double timePairs(size_t threadCount, Alloc&& alloc, Free&& free) {
+        const size_t steps = TOTAL_PAIRS / threadCount;
+        const double ms = runThreads(threadCount, [&](size_t) {
+            BenchNode* window[WINDOW]{};
+            for (size_t i = 0; i < steps; i++) {
+                BenchNode*& slot = window[i % WINDOW];
+                if (slot) { free(slot); }
+                slot = alloc();
+            }
+            for (auto* node : window) {
+                if (node) { free(node); }
+            }
+        });
+        return ms * 1000000.0 / double(steps * threadCount);
+    }
+}
+
+JCORE_BENCH(concurrentPoolContention) {
+    printf("%zu alloc/free pairs split between the threads, %zu hardware threads\n", TOTAL_PAIRS, size_t(std::thread::hardware_concurrency()));
+    printf("wall ns per pair, remote is ns per object freed by another thread than the one that allocated it\n");
+    printf("%8s %16s %16s %12s %12s\n", "threads", "ConcurrentPool", "mutex+Pool", "new/delete", "remote");
+
+    for (size_t threadCount = 1; threadCount <= 64; threadCount *= 2) {
+        ConcurrentPoolAllocator<BenchNode> pool{};
+        const double concurrent = timePairs(threadCount,
+            [&pool]() { return pool.allocate(); },
+            [&pool](BenchNode* node) { pool.deallocate(node); });
+
+        std::mutex mutex{};
+        PoolAllocator<BenchNode> locked{};
+        const double mutexed = timePairs(threadCount,
+            [&]() { std::lock_guard<std::mutex> lock(mutex); return locked.allocate(); },
+            [&](BenchNode* node) { std::lock_guard<std::mutex> lock(mutex); locked.deallocate(node); });
+
+        const double heap = timePairs(threadCount,
+            []() { return new BenchNode(); },
+            [](BenchNode* node) { delete node; });
+
+        //Each thread allocates a batch, then frees the batch of the next thread, every free goes through a remote list
+        ConcurrentPoolAllocator<BenchNode> remotePool{};
+        const size_t perThread = REMOTE_OBJECTS / threadCount;
+        std::vector<std::vector<BenchNode*>> batches(threadCount, std::vector<BenchNode*>(perThread));
+        runThreads(threadCount, [&](size_t t) {
+            for (auto& node : batches[t]) {
+                node = remotePool.allocate();
+            }
+        });
+        const double remoteMs = runThreads(threadCount, [&](size_t t) {
+            for (auto* node : batches[(t + 1) % threadCount]) {
+                remotePool.deallocate(node);
+            }
+        });
+        const double remote = remoteMs * 1000000.0 / double(perThread * threadCount);
+
+        printf("%8zu %16.1f %16.1f %12.1f %12.1f\n", threadCount, concurrent, mutexed, heap, remote);
+    }
+}
@@ -0,0 +1,66 @@
+#include "Bench.h"
+#include <J-Core/Util/FlatMap.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace JCore;
+
+namespace {
+    //Inserts every key, then looks them all up in shuffled order & finally looks up keys that aren't in the map
+    template<typename Map, typename Key>
+    void runMap(const char* name, const std::vector<Key>& keys, const std::vector<Key>& misses) {
+        Map map{};
+        const double insert = Bench::timeNs([&]() {
+            for (size_t i = 0; i < keys.size(); i++) {
+                map[keys[i]] = uint32_t(i);
+            }
+        }, keys.size());
+
+        std::vector<Key> shuffled = keys;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(37));
+        const double hit = Bench::timeNs([&]() {
+            uint64_t sum = 0;
+            for (const auto& key : shuffled) {
+                sum += map.find(key)->second;
+            }
+            Bench::keep(sum);
+        }, shuffled.size());
+
+        const double miss = Bench::timeNs([&]() {
+            uint64_t found = 0;
+            for (const auto& key : misses) {
+                found += map.find(key) != map.end() ? 1 : 0;
+            }
+            Bench::keep(found);
+        }, misses.size());
+
+        printf("  %-26s %8.1f %8.1f %8.1f\n", name, insert, hit, miss);
+    }
+}
+
+JCORE_BENCH(flatMapLookup) {
+    printf("ns per op, hits in shuffled order\n");
+    printf("  %-26s %8s %8s %8s\n", "", "insert", "hit", "miss");
+
+    std::mt19937_64 rng(7);
+    for (size_t count : { size_t(1000), size_t(100000), size_t(2000000) }) {
+        printf("%zu keys\n", count);
+
+        std::vector<uint64_t> keys(count), misses(count);
+        for (auto& key : keys) { key = rng(); }
+        for (auto& key : misses) { key = rng(); }
+        runMap<FlatMap<uint64_t, uint32_t>>("FlatMap<u64>", keys, misses);
+        runMap<std::unordered_map<uint64_t, uint32_t>>("unordered_map<u64>", keys, misses);
+
+        //Shaped like the uniform & sprite names the engine maps hold
+        std::vector<std::string> names(count), missNames(count);
+        for (size_t i = 0; i < count; i++) {
+            names[i] = "u_uniform_" + std::to_string(rng() % 100000000);
+            missNames[i] = "miss_" + std::to_string(rng());
+        }
+        runMap<FlatMap<std::string, uint32_t>>("FlatMap<string>", names, missNames);
+        runMap<std::unordered_map<std::string, uint32_t>>("unordered_map<string>", names, missNames);
+    }
+}
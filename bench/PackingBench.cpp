@@ -0,0 +1,75 @@
+#include "Bench.h"
+#include <J-Core/Rendering/Atlas.h>
+#include <random>
+
+using namespace JCore;
+
+namespace {
+    struct BenchSprite {
+        int32_t width{ 0 };
+        int32_t height{ 0 };
+
+        int32_t getWidth() const { return width; }
+        int32_t getHeight() const { return height; }
+    };
+
+    struct SpriteSet {
+        const char* name;
+        size_t count;
+        int32_t maxWidth;
+        int32_t maxHeight;
+    };
+
+    const char* getMethodName(PackingMethod method) {
+        switch (method) {
+            case PackingMethod::Guillotine: return "Guillotine";
+            case PackingMethod::MaxRects: return "MaxRects";
+            case PackingMethod::Skyline: return "Skyline";
+            case PackingMethod::Search: return "Search";
+        }
+        return "Unknown";
+    }
+}
+
+JCORE_BENCH(packingOccupancy) {
+    static constexpr SpriteSet SETS[]{
+        { "400 small", 400, 124, 94 },
+        { "400 tall", 400, 124, 304 },
+        { "3000 small", 3000, 124, 94 },
+    };
+    static constexpr PackingMethod METHODS[]{ PackingMethod::Guillotine, PackingMethod::MaxRects, PackingMethod::Skyline, PackingMethod::Search };
+
+    //Occupancy is the area of every region (padding included) over the area of every page
+    printf("%-12s %-11s %6s %10s %10s\n", "sprites", "method", "pages", "occupancy", "time ms");
+    for (const auto& set : SETS) {
+        std::mt19937 rng(31);
+        std::vector<BenchSprite> sprites(set.count);
+        for (auto& sprite : sprites) {
+            sprite.width = 4 + int32_t(rng() % (set.maxWidth - 3));
+            sprite.height = 4 + int32_t(rng() % (set.maxHeight - 3));
+        }
+
+        for (PackingMethod method : METHODS) {
+            TexturePackingSpecs<BenchSprite> specs{};
+            specs.sprites = sprites.data();
+            specs.spriteCount = sprites.size();
+            specs.padding = 2;
+            specs.maxSize = 2048;
+            specs.method = method;
+
+            std::vector<AtlasDefiniton> pages{};
+            bool packed = false;
+            const double ms = Bench::timeMs([&]() { packed = packSprites(specs, pages); });
+
+            double used = 0, total = 0;
+            for (const auto& page : pages) {
+                total += double(page.width) * page.height;
+                for (const auto& region : page.atlas) {
+                    used += double(region.rect.width) * region.rect.height;
+                }
+            }
+            printf("%-12s %-11s %6zu %10.3f %10.2f%s\n", set.name, getMethodName(method), pages.size(),
+                total > 0 ? used / total : 0.0, ms, packed ? "" : " (failed)");
+        }
+    }
+}
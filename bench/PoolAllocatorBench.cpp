@@ -0,0 +1,61 @@
+#include "Bench.h"
+#include <J-Core/Util/PoolAllocator.h>
+#include <algorithm>
+#include <random>
+
+using namespace JCore;
+
+namespace {
+    struct BenchNode {
+        uint64_t values[5]{};
+    };
+
+    struct Timings {
+        double allocate{ 0 };
+        double deallocate{ 0 };
+    };
+
+    //Objects are freed in shuffled order, the worst case for finding their chunk
+    template<typename Alloc, typename Free>
+    void timeRound(std::vector<BenchNode*>& nodes, std::mt19937& rng, Alloc&& alloc, Free&& free, Timings& timings) {
+        timings.allocate += Bench::timeMs([&]() {
+            for (auto& node : nodes) {
+                node = alloc();
+            }
+        });
+
+        std::shuffle(nodes.begin(), nodes.end(), rng);
+        timings.deallocate += Bench::timeMs([&]() {
+            for (auto* node : nodes) {
+                free(node);
+            }
+        });
+    }
+}
+
+JCORE_BENCH(poolAllocator) {
+    printf("%zu byte objects, ns per op\n", sizeof(BenchNode));
+    printf("%10s %18s %18s\n", "objects", "PoolAllocator", "new/delete");
+    printf("%10s %9s %8s %9s %8s\n", "", "alloc", "free", "alloc", "free");
+
+    for (size_t count = 1000; count <= 10000000; count *= 10) {
+        const size_t rounds = std::max<size_t>(1000000 / count, 1);
+        std::vector<BenchNode*> nodes(count);
+        std::mt19937 rng(35);
+
+        //Every round starts from an empty allocator, so creating chunks is part of the allocation cost
+        Timings pooled{}, heap{};
+        for (size_t r = 0; r < rounds; r++) {
+            PoolAllocator<BenchNode> pool{};
+            timeRound(nodes, rng, [&pool]() { return pool.allocate(); }, [&pool](BenchNode* node) { pool.deallocate(node); }, pooled);
+        }
+
+        for (size_t r = 0; r < rounds; r++) {
+            timeRound(nodes, rng, []() { return new BenchNode(); }, [](BenchNode* node) { delete node; }, heap);
+        }
+
+        const double toNs = 1000000.0 / double(count * rounds);
+        printf("%10zu %9.1f %8.1f %9.1f %8.1f\n", count,
+            pooled.allocate * toNs, pooled.deallocate * toNs, heap.allocate * toNs, heap.deallocate * toNs);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <J-Core/IO/Image.h>
+#include <J-Core/IO/AudioUtils.h>
+#include <J-Core/Util/FlatMap.h>
+#include <J-Core/Util/StringId.h>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace JCore {
+    /// <summary>
+    /// In memory cache of decoded assets shared between everything that loads the same file.
+    /// Assets are keyed by the StringId of their absolute, normalized path combined with the decode parameters & handed out as shared pointers,
+    /// so evicting an entry only drops the cache's reference and never frees data someone is still using.
+    /// Concurrent requests for an asset that's still being decoded wait for that decode instead of starting their own.
+    /// Completed entries are kept under a byte budget by evicting the least recently used ones.
+    /// </summary>
+    class AssetCache {
+    public:
+        static constexpr size_t DEFAULT_MAX_BYTES = 512ULL * 1024 * 1024;
+
+        enum AssetType : uint8_t {
+            ASSET_Image,
+            ASSET_Audio,
+        };
+
+        struct Stats {
+            uint64_t hits{ 0 };
+            uint64_t misses{ 0 };
+            //Requests that found the asset still decoding & waited for it, also counted as hits
+            uint64_t sharedLoads{ 0 };
+            uint64_t evictions{ 0 };
+            uint64_t failures{ 0 };
+            size_t entryCount{ 0 };
+            size_t bytes{ 0 };
+            size_t maxBytes{ 0 };
+        };
+
+        AssetCache(size_t maxBytes = DEFAULT_MAX_BYTES);
+        ~AssetCache();
+
+        AssetCache(const AssetCache&) = delete;
+        AssetCache& operator=(const AssetCache&) = delete;
+
+        static AssetCache& getGlobal();
+
+        /// <summary>
+        /// Decoded image of 'path', decoded through Image::tryDecode (and so the ImageCache when it's open) on a miss.
+        /// Returns null if decoding failed, failures aren't cached so the next request tries again.
+        /// </summary>
+        std::shared_ptr<const ImageData> getImage(std::string_view path, const ImageDecodeParams& params = {});
+
+        /// <summary>
+        /// Decoded audio of 'path', only WAV files can be decoded for now.
+        /// </summary>
+        std::shared_ptr<const AudioData> getAudio(std::string_view path);
+
+        static StringId getPathId(std::string_view path);
+
+        /// <summary>
+        /// Drops every entry of 'path' regardless of the parameters it was decoded with, e.g. after the file changed on disk.
+        /// </summary>
+        void invalidate(std::string_view path);
+        void trim(size_t targetBytes);
+        void clear();
+
+        size_t getMaxBytes() const;
+        void setMaxBytes(size_t maxBytes);
+
+        Stats getStats() const;
+        void resetStats();
+
+    private:
+        using AssetPtr = std::shared_ptr<const void>;
+        using Loader = bool (*)(std::string_view path, uint8_t flags, AssetPtr& asset, size_t& size);
+
+        struct CacheEntry {
+            std::shared_future<AssetPtr> result{};
+            StringId pathId{};
+            size_t size{ 0 };
+            //Tells a finishing load apart from a newer one started after its entry was dropped
+            uint64_t loadId{ 0 };
+            bool loaded{ false };
+            std::list<uint64_t>::iterator lruPos{};
+        };
+
+        mutable std::mutex _mutex;
+        size_t _maxBytes;
+        size_t _totalBytes;
+        uint64_t _loadCounter;
+        Stats _stats;
+        FlatMap<uint64_t, CacheEntry> _entries;
+
+        //Keys of loaded entries, most recently used first
+        std::list<uint64_t> _lru;
+
+        AssetPtr getAsset(AssetType type, std::string_view path, uint8_t flags, Loader loader);
+        void removeLocked(uint64_t key, CacheEntry& entry);
+        void trimLocked(size_t targetBytes);
+    };
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <J-Core/IO/MemoryStream.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace JCore {
+    /// <summary>
+    /// Bytes of a finished async read. The buffer comes from the global BufferPool & goes back to it when the result is destroyed.
+    /// </summary>
+    class AsyncReadResult {
+    public:
+        AsyncReadResult() : _path(), _offset(0), _data(nullptr), _size(0), _capacity(0), _ok(false) {}
+        AsyncReadResult(AsyncReadResult&& other) noexcept;
+        AsyncReadResult& operator=(AsyncReadResult&& other) noexcept;
+        ~AsyncReadResult() { release(); }
+
+        AsyncReadResult(const AsyncReadResult&) = delete;
+        AsyncReadResult& operator=(const AsyncReadResult&) = delete;
+
+        bool isValid() const { return _ok; }
+        const std::string& getPath() const { return _path; }
+        size_t getOffset() const { return _offset; }
+        const uint8_t* getData() const { return _data; }
+        size_t getSize() const { return _size; }
+
+        /// <summary>
+        /// Read only stream over the data so it can be handed straight to the decoders, must not outlive the result.
+        /// </summary>
+        MemoryStream asStream() const { return MemoryStream(_data, _size, _size); }
+
+        void release();
+
+    private:
+        friend class AsyncIO;
+
+        std::string _path;
+        size_t _offset;
+        uint8_t* _data;
+        size_t _size;
+        size_t _capacity;
+        bool _ok;
+
+        bool allocate(size_t size);
+    };
+
+    using AsyncReadCB = std::function<void(AsyncReadResult&)>;
+
+    struct AsyncReadRequest {
+        std::string path{};
+        size_t offset{ 0 };
+        size_t size{ SIZE_MAX };
+        AsyncReadCB onComplete{};
+    };
+
+    /// <summary>
+    /// Batched asynchronous file reads. On Linux requests go through io_uring when the kernel allows it,
+    /// otherwise a set of I/O threads does positional reads (pread/ReadFile with an offset).
+    /// Completion callbacks run on a separate worker pool as soon as their bytes land,
+    /// so decoding overlaps with the reads still in flight and never stalls the submission side.
+    /// </summary>
+    class AsyncIO {
+    public:
+        static constexpr size_t WHOLE_FILE = SIZE_MAX;
+        static constexpr uint32_t DEFAULT_QUEUE_DEPTH = 64;
+
+        AsyncIO(size_t workers = 0, uint32_t queueDepth = DEFAULT_QUEUE_DEPTH);
+        ~AsyncIO();
+
+        AsyncIO(const AsyncIO&) = delete;
+        AsyncIO& operator=(const AsyncIO&) = delete;
+
+        static AsyncIO& getGlobal();
+
+        bool isUsingIoUring() const { return _ring != nullptr; }
+        size_t getPendingCount() const { return _outstanding.load(std::memory_order_acquire); }
+
+        void readAsync(std::string_view path, size_t offset, size_t size, AsyncReadCB onComplete);
+        std::future<AsyncReadResult> readAsync(std::string_view path, size_t offset = 0, size_t size = WHOLE_FILE);
+
+        /// <summary>
+        /// Reads from a stream on the worker pool. Streams aren't positional,
+        /// so the stream must not be used by anything else (including other requests) until the callback has run.
+        /// </summary>
+        void readAsync(const Stream& stream, size_t offset, size_t size, AsyncReadCB onComplete);
+
+        /// <summary>
+        /// Queues every request at once, moving their paths & callbacks out of 'requests'.
+        /// </summary>
+        void readBatch(AsyncReadRequest* requests, size_t count);
+        void readBatch(std::vector<AsyncReadRequest>& requests) { readBatch(requests.data(), requests.size()); }
+
+        /// <summary>
+        /// Blocks until every queued read has completed & its callback has returned.
+        /// </summary>
+        void waitIdle();
+
+    private:
+        struct Ring;
+        struct Op {
+            AsyncReadRequest request{};
+            AsyncReadResult result{};
+            size_t done{ 0 };
+            int32_t file{ -1 };
+        };
+
+        struct Pool {
+            std::mutex mutex{};
+            std::condition_variable cv{};
+            std::deque<std::function<void()>> jobs{};
+            std::vector<std::thread> threads{};
+            bool stop{ false };
+        };
+
+        Pool _workers;
+        Pool _io;
+        Ring* _ring;
+        std::thread _ringThread;
+        std::mutex _ringMutex;
+        std::deque<Op*> _ringPending;
+        std::atomic<bool> _stopping;
+
+        std::atomic<size_t> _outstanding;
+        std::mutex _idleMutex;
+        std::condition_variable _idleCv;
+
+        void complete(Op* op);
+        void finishOne();
+
+        static void startPool(Pool& pool, size_t threads);
+        static void stopPool(Pool& pool);
+        static void push(Pool& pool, std::function<void()>&& job);
+
+        static bool prepareRange(Op& op, size_t fileSize);
+        static bool readDirect(Op& op);
+
+        bool initRing(uint32_t queueDepth);
+        void runRing();
+    };
+}
@@ -1,55 +1,181 @@
 #pragma once
 #include <J-Core/IO/Stream.h>
-
-//TODO: Finish writing this bitstream class.
-
+#include <cstring>
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+/// <summary>
+/// Bit level reader/writer on top of another stream, for entropy coded data (LZW, Huffman, custom codecs).
+/// Bits go through a 64 bit register that is refilled/flushed 8 bytes at a time from an internal byte buffer,
+/// so peekBits/consumeBits (table driven Huffman decoding) & getBits/putBits are a couple of shifts in the common case.
+/// tell/seek/read/write work in bytes like every other stream & byte align first, tellBits/seekBits work in bits.
+/// Use it either for reading or for writing, switching between the two flushes/re-syncs with the wrapped stream.
+/// Reads past the end return zero bits, hasOverrun() tells if that happened.
+/// </summary>
 class BitStream : public Stream {
 public:
+    enum class BitOrder : uint8_t {
+        //First bit is the highest bit of each byte (JPEG, most Huffman formats)
+        MSBFirst,
+        //First bit is the lowest bit of each byte (Deflate, GIF LZW)
+        LSBFirst,
+    };
+
+    //Most bits a single peekBits/putBits call can handle, getBits handles up to 64
+    static constexpr uint32_t MAX_PEEK_BITS = 56;
 
     BitStream();
-    BitStream(const Stream& stream);
+    BitStream(const Stream& stream, const BitOrder order = BitOrder::MSBFirst);
     ~BitStream();
 
-    void setStream(const Stream* stream) const {
-        _stream = stream;
+    BitStream(const BitStream&) = delete;
+    BitStream& operator=(const BitStream&) = delete;
 
-        if (_stream) {
-            _capacity = _stream->capacity();
-            _length = _stream->size();
-            _position = _stream->tell();
-            return;
+    void setStream(const Stream* stream) const;
+    const Stream* getStream() const { return _stream; }
+
+    BitOrder getBitOrder() const { return _order; }
+    void setBitOrder(const BitOrder order) const;
+
+    size_t tell() const override { return size_t(tellBits() >> 3); }
+    size_t size() const override;
+    uint64_t tellBits() const { return _writing ? (_bufferStart + _bufferPos) * 8 + _bitCount : (_bufferStart + _bufferPos) * 8 - _bitCount; }
+
+    bool isEOF() const override { return tellBits() >= uint64_t(size()) * 8; }
+    bool hasOverrun() const { return !_writing && tellBits() > uint64_t(size()) * 8; }
+
+    bool isOpen() const override { return _stream && _stream->isOpen(); }
+    bool canWrite() const override { return _stream && _stream->canWrite(); }
+    bool canRead() const override { return _stream && _stream->canRead(); }
+
+    /// <summary>
+    /// Next 'count' (0-56) bits without consuming them. In LSBFirst order the first bit is bit 0 of the result, in MSBFirst it's the highest of the 'count' bits.
+    /// </summary>
+    uint64_t peekBits(const uint32_t count) const {
+        //Refill also takes care of switching over from writing, the write buffer never looks like it has 8 bytes to load
+        if (_bitCount < count || _writing) { refill(); }
+        return _order == BitOrder::MSBFirst ? (_bits >> 1) >> (63 - count) : _bits & ((uint64_t(1) << count) - 1);
+    }
+
+    void consumeBits(const uint32_t count) const {
+        _bits = _order == BitOrder::MSBFirst ? _bits << count : _bits >> count;
+        _bitCount -= count;
+    }
+
+    uint64_t getBits(const uint32_t count) const {
+        if (count > MAX_PEEK_BITS) {
+            const uint64_t first = getBits(32);
+            const uint64_t second = getBits(count - 32);
+            return _order == BitOrder::MSBFirst ? (first << (count - 32)) | second : first | (second << 32);
         }
 
-        _capacity = 0;
-        _length = 0;
-        _position = 0;
+        const uint64_t value = peekBits(count);
+        consumeBits(count);
+        return value;
     }
 
-    void byteAlign() const;
+    bool getBit() const { return getBits(1) != 0; }
+
+    /// <summary>
+    /// Appends the low 'count' (0-64) bits of 'value' in the stream's bit order.
+    /// </summary>
+    void putBits(uint64_t value, const uint32_t count) const {
+        if (count > MAX_PEEK_BITS) {
+            if (_order == BitOrder::MSBFirst) {
+                putBits(value >> 32, count - 32);
+                putBits(value, 32);
+            }
+            else {
+                putBits(value, 32);
+                putBits(value >> 32, count - 32);
+            }
+            return;
+        }
 
-    const Stream* getStream() const { return _stream; }
+        if (count < 1) { return; }
+        if (!_writing) { beginWrite(); }
+        if (_bitCount + count > 64) { flushBits(); }
 
-    size_t tell() const override { return _bitPos; }
+        value &= (uint64_t(1) << count) - 1;
+        _bits |= _order == BitOrder::MSBFirst ? value << (64 - _bitCount - count) : value << _bitCount;
+        _bitCount += count;
+    }
 
-    virtual bool isOpen() const override { return _stream && _stream->isOpen(); }
-    virtual size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override;
-    virtual size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override;
+    void putBit(const bool bit) const { putBits(bit ? 1 : 0, 1); }
 
+    /// <summary>
+    /// Reads/writes 'bits' bits as consecutive bytes, the last partial byte holds its bits in the low end. Returns the number of bits moved.
+    /// </summary>
     size_t readBits(void* buffer, size_t bits) const;
     size_t writeBits(const void* buffer, const size_t bits) const;
 
-    virtual bool flush() const override;
-    virtual bool close() const override;
+    /// <summary>
+    /// Skips to the next byte boundary when reading, pads with zero bits when writing.
+    /// </summary>
+    void byteAlign() const;
+
+    using Stream::read;
+    using Stream::write;
+    size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override;
+    size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override;
+
+    /// <summary>
+    /// Writes out pending bits (padding the last byte) or, when reading, leaves the wrapped stream at the first byte not fully consumed.
+    /// </summary>
+    bool flush() const override;
+    bool close() const override;
 
-    virtual size_t seek(int64_t offset, int origin) const override;
+    size_t seek(int64_t offset, int origin) const override;
+    uint64_t seekBits(const uint64_t bit) const;
 
 private:
     static constexpr uint32_t BIT_BUFFER_SIZE = 8192;
-    static constexpr uint8_t FLAG_NEED_READ = 0x80;
 
-    mutable size_t _bitPos;
-    mutable uint8_t _bitBuffer[BIT_BUFFER_SIZE]{0};
     mutable const Stream* _stream;
+    mutable BitOrder _order;
+    mutable bool _writing;
+    //Set once the wrapped stream has no more bytes to give, the buffer is zero padded past its end from then on
+    mutable bool _exhausted;
+
+    mutable uint64_t _bits;
+    mutable uint32_t _bitCount;
+
+    //Position in the wrapped stream that _bitBuffer[0] corresponds to
+    mutable size_t _bufferStart;
+    //Reading: next byte to load into _bits. Writing: bytes waiting to be written out
+    mutable size_t _bufferPos;
+    mutable size_t _bufferLength;
+    mutable uint8_t _bitBuffer[BIT_BUFFER_SIZE + 8]{ 0 };
+
+    static uint64_t byteSwap(const uint64_t value) {
+#ifdef _MSC_VER
+        return _byteswap_uint64(value);
+#else
+        return __builtin_bswap64(value);
+#endif
+    }
+
+    void refill() const {
+        if (_bufferPos + 8 > _bufferLength) {
+            refillSlow();
+            return;
+        }
+
+        //Loads 8 bytes but only advances by the whole bytes that fit, the extra bits are the same ones the next refill loads again
+        uint64_t next{};
+        memcpy(&next, _bitBuffer + _bufferPos, 8);
+        _bits |= _order == BitOrder::MSBFirst ? byteSwap(next) >> _bitCount : next << _bitCount;
+        _bufferPos += (63 - _bitCount) >> 3;
+        _bitCount |= 56;
+    }
+
+    void refillSlow() const;
+    void flushBits() const;
+    void flushBuffer() const;
 
-    void checkBitBuffer() const;
+    void beginRead() const;
+    void beginWrite() const;
+    void sync() const;
+    void reset(const size_t position) const;
 };
@@ -0,0 +1,60 @@
+#pragma once
+#include <J-Core/IO/Stream.h>
+
+/// <summary>
+/// Decorator that puts a user space buffer in front of another stream.
+/// Small reads, peeks, readLine/readCString & seeks that land inside the buffer are served from memory without touching the wrapped stream,
+/// reads larger than the buffer go straight through. Consecutive writes are coalesced & written out on flush/close/destruction or when a read or a non-contiguous write needs the buffer.
+/// The wrapped stream must outlive the decorator and shouldn't be used directly while it's wrapped.
+/// </summary>
+class BufferedStream : public Stream {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+    //For parsing just the headers of a file
+    static constexpr size_t HEADER_BUFFER_SIZE = 4 * 1024;
+
+    BufferedStream(const Stream& stream, const size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~BufferedStream();
+
+    BufferedStream(const BufferedStream&) = delete;
+    BufferedStream& operator=(const BufferedStream&) = delete;
+
+    const Stream& getStream() const { return _stream; }
+    size_t getBufferSize() const { return _bufferSize; }
+
+    bool isOpen() const override { return _buffer && _stream.isOpen(); }
+    bool canWrite() const override { return _buffer && _stream.canWrite(); }
+    bool canRead() const override { return _buffer && _stream.canRead(); }
+
+    size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override;
+    size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override;
+
+    /// <summary>
+    /// Reads up to 'size' bytes without moving the stream position.
+    /// </summary>
+    size_t peek(void* buffer, const size_t size) const;
+
+    bool flush() const override;
+    bool close() const override;
+
+    size_t seek(int64_t offset, int origin) const override;
+    bool tryReserve(const size_t bytes) const override { return _stream.tryReserve(bytes); }
+
+    const uint8_t* tryGetView(const size_t size) const override;
+
+private:
+    const Stream& _stream;
+    uint8_t* _buffer;
+    size_t _bufferSize;
+    size_t _bufferCapacity;
+
+    //Position in the wrapped stream that _buffer[0] corresponds to
+    mutable size_t _bufferStart;
+    mutable size_t _bufferLength;
+    //Bytes written into the buffer but not yet into the wrapped stream, the buffer holds no read data while this is non-zero
+    mutable size_t _pendingWrite;
+
+    bool fill(const size_t position) const;
+    bool flushWrites() const;
+    void seekStream(const size_t position) const;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <J-Core/IO/Stream.h>
+#include <zlib.h>
+
+/// <summary>
+/// Write only decorator that zlib compresses everything written to it into the wrapped stream.
+/// Input is fed to zlib straight from the caller's buffer, only the compressed output goes through an internal pooled buffer.
+/// The stream has to be finished (finish/close/destruction) for the output to be complete, the wrapped stream must outlive the decorator.
+/// </summary>
+class DeflateStream : public Stream {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    DeflateStream(const Stream& stream, const int32_t level = Z_DEFAULT_COMPRESSION, const size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~DeflateStream();
+
+    DeflateStream(const DeflateStream&) = delete;
+    DeflateStream& operator=(const DeflateStream&) = delete;
+
+    const Stream& getStream() const { return _stream; }
+
+    //Bytes written into the wrapped stream so far
+    size_t getCompressedSize() const { return _compressed; }
+
+    bool isOpen() const override { return _initialized; }
+    bool canWrite() const override { return _initialized && _stream.canWrite(); }
+    bool canRead() const override { return false; }
+
+    size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override { return 0; }
+    using Stream::write;
+    size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override;
+
+    /// <summary>
+    /// Sync flush, everything written so far can be decompressed from the wrapped stream afterwards. Costs some compression, don't call it per write.
+    /// </summary>
+    bool flush() const override;
+
+    /// <summary>
+    /// Writes out the end of the compressed data, the wrapped stream is left open.
+    /// </summary>
+    bool finish() const;
+    bool close() const override;
+
+    //Compressed output can't be rewritten, only reports the position
+    size_t seek(int64_t offset, int origin) const override { return _position; }
+
+private:
+    const Stream& _stream;
+    mutable z_stream _zStream;
+    mutable bool _initialized;
+    mutable size_t _compressed;
+
+    uint8_t* _buffer;
+    size_t _bufferSize;
+    size_t _bufferCapacity;
+
+    bool deflateInput(const uint8_t* input, const size_t size, const int32_t flush) const;
+};
@@ -6,6 +6,7 @@
 #include <functional>
 #include <nlohmann/json.hpp>
 #include <J-Core/Util/StringUtils.h>
+#include <J-Core/IO/Stream.h>
 
 using json = nlohmann::basic_json<nlohmann::ordered_map>;
 namespace fs = std::filesystem;
@@ -85,14 +86,43 @@ namespace JCore::IO {
         return getAll(path, F_TYPE_FOLDER, paths, recursive, check);
     }
 
-    void moveFile(std::string_view src, std::string_view dst, bool overwrite);
+    using OnPathBatch = std::function<void(const fs::path* paths, size_t count)>;
+
+    struct WalkParams {
+        uint8_t flags{ F_TYPE_FILE };
+        bool recursive{ true };
+        //Only applies to files. Filter in the same format openFile takes ("PNG\0*.png\0JPEG\0*.jpg\0\0"), checked with matchFilter
+        const char* filter{ nullptr };
+        //Only applies to files. Extensions without the dot ("png"), compared case insensitively
+        std::vector<std::string> extensions{};
+        //Called from the worker threads, possibly several at once, so it must not touch unsynchronized state
+        CheckPath check{ nullptr };
+        //Sorts everything found by path before handing it out, so the output doesn't depend on thread timing
+        bool sorted{ false };
+        size_t batchSize{ 256 };
+        //0 uses Parallel::getWorkerCount(), more can help on network shares where threads mostly wait on the server
+        size_t threads{ 0 };
+    };
+
+    /// <summary>
+    /// Parallel version of getAll, directories are handed out to threads from a shared queue as they're found so it scales with the directory count.
+    /// Results come in batches of up to 'batchSize' paths, the callback is never called from two threads at once.
+    /// Unsorted batches come from the worker threads as they fill up, sorted ones from the calling thread once the walk is done.
+    /// </summary>
+    bool walk(const fs::path& path, const WalkParams& params, const OnPathBatch& callback);
+    bool walk(const fs::path& path, const WalkParams& params, std::vector<fs::path>& paths);
+
+    /// <summary>
+    /// Renames when possible, otherwise (e.g. across volumes) copies with progress & removes the source once the copy is complete.
+    /// </summary>
+    bool moveFile(std::string_view src, std::string_view dst, bool overwrite, const CopyProgressCB& onProgress = nullptr);
 
     bool exists(const char* path);
     bool exists(const fs::path& path);
     void createDirectory(const char* path);
 
-    bool copyTo(const char* src, const char* dest);
-    bool copyTo(const fs::path& src, const fs::path& dest);
+    bool copyTo(const char* src, const char* dest, const CopyProgressCB& onProgress = nullptr);
+    bool copyTo(const fs::path& src, const fs::path& dest, const CopyProgressCB& onProgress = nullptr);
 
     void fixPath(char* path);
     void fixPath(char* path, size_t len);
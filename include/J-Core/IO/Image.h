@@ -6,6 +6,8 @@
 #include <J-Core/IO/ImageUtils.h>
 #include <J-Core/Util/DataFormatUtils.h>
 static constexpr uint8_t F_IMG_BUILD_PALETTE = 0x1;
+//Image::tryDecode won't read from or write to the ImageCache
+static constexpr uint8_t F_IMG_SKIP_CACHE = 0x2;
 
 namespace JCore {
     struct ImageDecodeParams {
@@ -24,8 +26,8 @@ namespace JCore {
         bool getInfo(std::string_view path, ImageData& imgData);
         bool getInfo(const Stream& stream, ImageData& imgData);
 
-        bool encode(std::string_view path, const ImageData& imgData, const uint32_t compression = 6);
-        bool encode(const Stream& stream, const ImageData& imgData, const uint32_t compression = 6);
+        bool encode(std::string_view path, const ImageView& imgData, const uint32_t compression = 6);
+        bool encode(const Stream& stream, const ImageView& imgData, const uint32_t compression = 6);
     }
 
     namespace Bmp {
@@ -35,8 +37,8 @@ namespace JCore {
         bool getInfo(std::string_view path, ImageData& imgData);
         bool getInfo(const Stream& stream, ImageData& imgData);
 
-        bool encode(std::string_view path, const ImageData& imgData, uint32_t dpi = 96);
-        bool encode(const Stream& stream, const ImageData& imgData, uint32_t dpi = 96);
+        bool encode(std::string_view path, const ImageView& imgData, uint32_t dpi = 96);
+        bool encode(const Stream& stream, const ImageView& imgData, uint32_t dpi = 96);
     }
 
     namespace ICO {
@@ -46,22 +48,22 @@ namespace JCore {
         bool decode(std::string_view path, ImageData& imgData, const ImageDecodeParams params = {});
         bool decode(const Stream& stream, ImageData& imgData, const ImageDecodeParams params = {});
 
-        bool encode(std::string_view path, const ImageData& imgData, bool compressed = false);
-        bool encode(const Stream& stream, const ImageData& imgData, bool compressed = false);
+        bool encode(std::string_view path, const ImageView& imgData, bool compressed = false);
+        bool encode(const Stream& stream, const ImageView& imgData, bool compressed = false);
     }
 
     namespace DXT {
         bool decodeDxt1(std::string_view path, ImageData& imgData, const ImageDecodeParams params = {});
         bool decodeDxt1(const Stream& stream, ImageData& imgData, const ImageDecodeParams params = {});
                       
-        bool encodeDxt1(std::string_view path, const ImageData& imgData);
-        bool encodeDxt1(const Stream& stream, const ImageData& imgData);
+        bool encodeDxt1(std::string_view path, const ImageView& imgData);
+        bool encodeDxt1(const Stream& stream, const ImageView& imgData);
 
         bool decodeDxt5(std::string_view path, ImageData& imgData, const ImageDecodeParams params = {});
         bool decodeDxt5(const Stream& stream, ImageData& imgData, const ImageDecodeParams params = {});
                    
-        bool encodeDxt5(std::string_view path, const ImageData& imgData);
-        bool encodeDxt5(const Stream& stream, const ImageData& imgData);
+        bool encodeDxt5(std::string_view path, const ImageView& imgData);
+        bool encodeDxt5(const Stream& stream, const ImageView& imgData);
     }
 
     namespace DDS {
@@ -71,8 +73,8 @@ namespace JCore {
         bool getInfo(std::string_view path, ImageData& imgData);
         bool getInfo(const Stream& stream, ImageData& imgData);
 
-        bool encode(std::string_view path, const ImageData& imgData);
-        bool encode(const Stream& stream, const ImageData& imgData);
+        bool encode(std::string_view path, const ImageView& imgData);
+        bool encode(const Stream& stream, const ImageView& imgData);
     }
 
     namespace JTEX {
@@ -82,8 +84,9 @@ namespace JCore {
         bool getInfo(std::string_view path, ImageData& imgData);
         bool getInfo(const Stream& stream, ImageData& imgData);
 
-        bool encode(std::string_view path, const ImageData& imgData);
-        bool encode(const Stream& stream, const ImageData& imgData);
+        //'compression' is a zlib level, 0 stores the pixels uncompressed
+        bool encode(std::string_view path, const ImageView& imgData, const int32_t compression = 0);
+        bool encode(const Stream& stream, const ImageView& imgData, const int32_t compression = 0);
     }
 
     namespace Image {
@@ -93,7 +96,7 @@ namespace JCore {
         bool tryDecode(std::string_view path, ImageData& imgData, DataFormat& format, const ImageDecodeParams params = {});
         bool tryDecode(const Stream& stream, ImageData& imgData, DataFormat& format, const ImageDecodeParams params = {});
 
-        bool tryEncode(std::string_view path, const ImageData& imgData, DataFormat format, const ImageEncodeParams& encodeParams = {});
-        bool tryEncode(const Stream& stream, const ImageData& imgData, DataFormat format, const ImageEncodeParams& encodeParams = {});
+        bool tryEncode(std::string_view path, const ImageView& imgData, DataFormat format, const ImageEncodeParams& encodeParams = {});
+        bool tryEncode(const Stream& stream, const ImageView& imgData, DataFormat format, const ImageEncodeParams& encodeParams = {});
     }
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include <J-Core/IO/Image.h>
+#include <J-Core/Util/FlatMap.h>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+
+namespace JCore {
+    /// <summary>
+    /// Persistent cache of decoded images, one JTEX file per source image in a cache directory.
+    /// Entries are keyed by a hash of the source's absolute path, modification time, size & the decode parameters,
+    /// so a hit only costs a stat of the source & a lookup, a changed source simply hashes to a different entry.
+    /// Entries are written to a temp file & renamed into place, a crash never leaves a half written entry behind.
+    /// The directory is kept under a size limit by evicting the least recently used entries, use order is kept across runs through the files' modification times.
+    /// Once the global cache is opened Image::tryDecode(path, ...) goes through it automatically.
+    /// </summary>
+    class ImageCache {
+    public:
+        static constexpr uint64_t DEFAULT_MAX_BYTES = 1024ULL * 1024 * 1024;
+
+        ImageCache();
+        ~ImageCache();
+
+        ImageCache(const ImageCache&) = delete;
+        ImageCache& operator=(const ImageCache&) = delete;
+
+        static ImageCache& getGlobal();
+
+        /// <summary>
+        /// Opens (or creates) the cache in 'directory' & indexes the entries already in it.
+        /// 'compression' is the zlib level entries are stored with, 0 keeps them uncompressed which is the fastest to load.
+        /// </summary>
+        bool open(const std::filesystem::path& directory, uint64_t maxBytes = DEFAULT_MAX_BYTES, int32_t compression = 0);
+        void close();
+        bool isOpen() const;
+
+        /// <summary>
+        /// Key for the decoded result of 'path' with 'params', 0 if the source doesn't exist. A single stat is all it costs,
+        /// compute it before decoding & use it for both tryLoad & store so a source changing mid decode can't be cached under its new key.
+        /// </summary>
+        uint64_t getKey(std::string_view path, const ImageDecodeParams& params) const;
+
+        bool tryLoad(uint64_t key, ImageData& imgData, DataFormat& format);
+        bool store(uint64_t key, const ImageView& imgData, DataFormat format);
+
+        /// <summary>
+        /// Evicts least recently used entries until the cache is at most 'targetBytes'.
+        /// </summary>
+        void trim(uint64_t targetBytes);
+        void clear();
+
+        uint64_t getSize() const;
+        size_t getEntryCount() const;
+
+        uint64_t getMaxBytes() const;
+        void setMaxBytes(uint64_t maxBytes);
+
+    private:
+        struct CacheEntry {
+            uint64_t size{ 0 };
+            uint64_t lastUse{ 0 };
+        };
+
+        mutable std::mutex _mutex;
+        std::filesystem::path _directory;
+        bool _isOpen;
+        int32_t _compression;
+        uint64_t _maxBytes;
+        uint64_t _totalBytes;
+        uint64_t _useCounter;
+        uint64_t _tempCounter;
+        FlatMap<uint64_t, CacheEntry> _entries;
+
+        std::filesystem::path getEntryPath(uint64_t key) const;
+        void removeEntry(uint64_t key);
+        bool removeEntryFile(uint64_t key) const;
+        void trimLocked(uint64_t targetBytes);
+    };
+}
@@ -6,8 +6,9 @@
 #include <J-Core/Math/Color565.h>
 #include <J-Core/Math/Color4444.h>
 #include <J-Core/Util/DataUtils.h>
+#include <J-Core/Util/BufferPool.h>
 #include <J-Core/Math/Math.h>
-#include <unordered_map>
+#include <J-Core/Util/FlatMap.h>
 #include <glm.hpp>
 #include <algorithm>
 
@@ -84,7 +85,7 @@ namespace JCore {
     bool hasAlpha(const uint8_t* data, int32_t width, int32_t height, TextureFormat format, int32_t paletteSize = -1);
     int32_t findInPalette(const Color32 color, const Color32* palette, uint32_t size);
 
-    bool tryBuildPalette(Color32 pixel, int32_t& colors, TextureFormat& format, uint8_t* newPalette, std::unordered_map<uint32_t, int32_t>& paletteLut, int32_t alphaClip = -1, int32_t absoluteMax = -1);
+    bool tryBuildPalette(Color32 pixel, int32_t& colors, TextureFormat& format, uint8_t* newPalette, FlatMap<uint32_t, int32_t>& paletteLut, int32_t alphaClip = -1, int32_t absoluteMax = -1);
 
     bool tryBuildPalette8(Color32 pixel, int32_t& colors, TextureFormat& format, uint8_t* newPalette, Color32 buffer[32], uint32_t& bufSize, int32_t alphaClip = -1);
     bool tryBuildPalette16(Color32 pixel, int32_t& colors, TextureFormat& format, uint8_t* newPalette, Color32 buffer[256], uint32_t& bufSize, int32_t alphaClip = -1, int32_t maxSize = 256 * 256);
@@ -397,6 +398,63 @@ namespace JCore {
         IMG_FLAG_ALIGNED = 0x80,
     };
 
+    /// <summary>
+    /// Non-owning, strided view into pixel data. Rows are 'stride' bytes apart, so a view
+    /// can point at a sub-rectangle of a larger image (crops, sprite sheets, atlas regions) without copying.
+    /// For indexed formats 'palette' points to 'paletteSize' colors which don't have to be adjacent to the pixels.
+    /// </summary>
+    struct ImageView {
+    public:
+        int32_t width{ 0 };
+        int32_t height{ 0 };
+        size_t stride{ 0 };
+        TextureFormat format{ TextureFormat::Unknown };
+        int32_t paletteSize{ 0 };
+        Color32* palette{ nullptr };
+        uint8_t* pixels{ nullptr };
+        uint8_t flags{ 0 };
+
+        constexpr ImageView() : width(), height(), stride(), format(), paletteSize(), palette(), pixels(), flags() {}
+        constexpr ImageView(uint8_t* pixels, int32_t width, int32_t height, size_t stride, TextureFormat format, Color32* palette = nullptr, int32_t paletteSize = 0, uint8_t flags = 0) :
+            width(width), height(height), stride(stride), format(format), paletteSize(paletteSize), palette(palette), pixels(pixels), flags(flags) {}
+
+        constexpr bool isValid() const { return pixels != nullptr && width > 0 && height > 0; }
+        constexpr bool isIndexed() const { return format >= TextureFormat::Indexed8 && format <= TextureFormat::Indexed16; }
+
+        constexpr int32_t getBytesPerPixel() const { return getBitsPerPixel(format) >> 3; }
+        constexpr size_t getScanSize() const { return size_t(width) * getBytesPerPixel(); }
+        constexpr size_t getPaletteBytes() const { return isIndexed() ? size_t(paletteSize) * sizeof(Color32) : 0; }
+
+        constexpr bool isContiguous() const { return stride == getScanSize() || height < 2; }
+
+        constexpr uint8_t* getRow(int32_t y) const { return pixels + size_t(y) * stride; }
+        constexpr uint8_t* getPixel(int32_t x, int32_t y) const { return getRow(y) + size_t(x) * getBytesPerPixel(); }
+
+        ImageView getSubView(int32_t x, int32_t y, int32_t w, int32_t h) const {
+            x = Math::clamp(x, 0, width);
+            y = Math::clamp(y, 0, height);
+            w = Math::clamp(w, 0, width - x);
+            h = Math::clamp(h, 0, height - y);
+            return ImageView(pixels ? getPixel(x, y) : nullptr, w, h, stride, format, palette, paletteSize, flags);
+        }
+
+        /// <summary>
+        /// Copies the view row by row into 'dst', which must be at least getScanSize() * height bytes.
+        /// </summary>
+        void copyPixelsTo(uint8_t* dst) const {
+            if (!pixels) { return; }
+            size_t scan = getScanSize();
+            if (isContiguous()) {
+                memcpy(dst, pixels, scan * height);
+                return;
+            }
+
+            for (int32_t y = 0; y < height; y++, dst += scan) {
+                memcpy(dst, getRow(y), scan);
+            }
+        }
+    };
+
     struct ImageData {
     public:
         int32_t width{ 0 };
@@ -446,21 +504,25 @@ namespace JCore {
 
         constexpr size_t getBufferSize() const { return _bufferSize; }
 
-        ImageData getFramed(size_t frame) const {
-            if (data == nullptr) { return *this; }
-            size_t framePos = frame * getSize();
+        ImageView getView() const {
+            return getFramed(0);
+        }
+
+        ImageView getFramed(size_t frame) const {
+            if (data == nullptr) { return ImageView(nullptr, width, height, 0, format, nullptr, 0, flags); }
+            uint8_t* start = getFramedStart(frame);
+            int32_t palSize = getPaletteSize(format, paletteSize, isAligned());
+            return ImageView(
+                start + getPaletteOffset(), width, height, size_t(width) * (getBitsPerPixel(format) >> 3), format,
+                palSize > 0 ? reinterpret_cast<Color32*>(start) : nullptr, palSize, flags);
+        }
 
-            ImageData temp{};
-            temp._bufferSize = _bufferSize - framePos;
-            temp.data = data + framePos;
-            temp.paletteSize = paletteSize;
-            temp.format = format;
-            temp.width = width;
-            temp.height = height;
-            temp.flags = flags;
-            return temp;
+        ImageView getSubView(int32_t x, int32_t y, int32_t w, int32_t h, size_t frame = 0) const {
+            return getFramed(frame).getSubView(x, y, w, h);
         }
 
+        operator ImageView() const { return getView(); }
+
         constexpr size_t getSize() const {
             return calculateSize(width, height, format, paletteSize, (this->flags & IMG_FLAG_ALIGNED) != 0);
         }
@@ -468,12 +530,13 @@ namespace JCore {
         bool isEqual(const ImageData& img) const {
             if (this == &img) { return true; }
             bool indexed = isIndexed();
-            if (_bufferSize != img._bufferSize ||
+            const size_t size = getSize();
+            if (size != img.getSize() ||
                 width != img.width || height != img.height ||
                 format != img.format || indexed != img.isIndexed() || (indexed && paletteSize != img.paletteSize)) {
                 return false;
             }
-            return memcmp(data, img.data, _bufferSize) == 0;
+            return memcmp(data, img.data, size) == 0;
         }
 
         static constexpr bool isIndexed(TextureFormat format) {
@@ -503,27 +566,11 @@ namespace JCore {
         }
 
         bool doAllocate() {
-            size_t required = getSize();
-            if (data) {
-                if (required <= _bufferSize) { return true; }
-                void* reloc = realloc(data, required);
-                if (!reloc) { return false; }
-                data = reinterpret_cast<uint8_t*>(reloc);
-            }
-            else
-            {
-                data = reinterpret_cast<uint8_t*>(malloc(required));
-            }
-
-            _bufferSize = required;
-            if (data) {
-                memset(data, 0, required);
-            }
-            return data != nullptr;
+            return doAllocate(getSize(), true);
         }
 
         bool copyFrom(const ImageData& other) {
-            if (doAllocate(other.width, other.height, other.format, other.paletteSize, other.isAligned())) {
+            if (doAllocate(other.width, other.height, other.format, other.paletteSize, other.isAligned(), 1, true, false)) {
                 size_t size = getSize();
                 if (other.data) {
                     memcpy(data, other.data, size);
@@ -536,35 +583,30 @@ namespace JCore {
             return false;
         }
 
-        bool doAllocate(size_t size, bool clear = true) {
-            size_t required = size;
-            if (data) {
-                if (required <= _bufferSize)
-                {
-                    if (clear) {
-                        memset(data, 0, size);
-                    }
-                    return true;
+        bool copyFrom(const ImageView& view) {
+            if (doAllocate(view.width, view.height, view.format, view.paletteSize, (view.flags & IMG_FLAG_ALIGNED) != 0, 1, true, view.pixels == nullptr)) {
+                flags = uint8_t((view.flags & ~IMG_FLAG_ALIGNED) | (flags & IMG_FLAG_ALIGNED));
+                size_t palOffset = getPaletteOffset();
+                size_t palCopy = view.palette ? Math::min(palOffset, view.getPaletteBytes()) : 0;
+                if (palCopy > 0) {
+                    memcpy(data, view.palette, palCopy);
                 }
-
-                void* reloc = realloc(data, required);
-                if (!reloc) { return false; }
-                data = reinterpret_cast<uint8_t*>(reloc);
-                _bufferSize = required;
-            }
-            else
-            {
-                data = reinterpret_cast<uint8_t*>(malloc(required));
-                _bufferSize = required;
-            }
-
-            if (data && clear) {
-                memset(data, 0, required);
+                memset(data + palCopy, 0, palOffset - palCopy);
+                view.copyPixelsTo(data + palOffset);
+                return true;
             }
-            return data != nullptr;
+            return false;
         }
 
+        /// <summary>
+        /// Makes sure the buffer holds at least 'size' bytes. Buffers come from the global BufferPool, are 64 byte aligned 
+        /// and only reallocated when growing. Pass clear = false when the contents are about to be overwritten anyway.
+        /// </summary>
+        bool doAllocate(size_t size, bool clear = true);
+
         bool doAllocate(int32_t width, int32_t height, TextureFormat format, int32_t paletteSize = 0, bool alignedPalette = false, uint32_t frames = 1, bool modify = true, bool clear = true) {
+            //What's kept when growing without clearing is the current image, not one of the new size
+            const size_t prevSize = data ? getSize() : 0;
             if (modify) {
                 this->width = width;
                 this->height = height;
@@ -572,15 +614,24 @@ namespace JCore {
                 this->flags = alignedPalette ? (this->flags | IMG_FLAG_ALIGNED) : (this->flags & ~IMG_FLAG_ALIGNED);
                 this->paletteSize = getPaletteSize(format, paletteSize, alignedPalette);
             }
-            return doAllocate(calculateSize(width, height, format, paletteSize, alignedPalette) * frames);
+            return allocateBuffer(calculateSize(width, height, format, paletteSize, alignedPalette) * frames, prevSize, clear);
         }
 
         void resize(int32_t newWidth, int32_t newHeight, bool linear, ImageData* tempBuffer = nullptr);
 
-        void replaceData(uint8_t* newData, bool destroy);
+        /// <summary>
+        /// Swaps in an externally allocated buffer. 'bufferSize' should be its capacity (0 if unknown), 
+        /// set 'pooled' only if it came from BufferPool::getGlobal().
+        /// </summary>
+        void replaceData(uint8_t* newData, bool destroy, size_t bufferSize = 0, bool pooled = false);
         void clear(bool destroy);
     private:
         size_t _bufferSize{ 0 };
+        bool _pooled{ false };
+
+        void releaseBuffer();
+        //'keepSize' is how many bytes of the current buffer are valid when its capacity isn't known
+        bool allocateBuffer(size_t size, size_t keepSize, bool clear);
     };
 
     struct ImageBuffers {
@@ -619,5 +670,18 @@ namespace JCore {
         ImageData _buffers[4]{ };
     };
 
-    uint8_t calculateColorVariance(const ImageData& img, bool ignoreClear);
+    bool hasAlpha(const ImageView& img);
+    uint8_t calculateColorVariance(const ImageView& img, bool ignoreClear);
+
+    /// <summary>
+    /// Resamples 'src' into 'dst', both views must share the same format and 'dst' must already point to writable pixels.
+    /// Linear filtering is only used for RGB24 & RGBA32, other formats fall back to nearest.
+    /// </summary>
+    bool resizeImage(const ImageView& src, const ImageView& dst, bool linear);
+
+    /// <summary>
+    /// Applies colorToAlpha to a whole image with the key color given as bytes.
+    /// RGBA32 pixels are processed 4 at a time in parallel row bands, indexed images only touch their palette.
+    /// </summary>
+    bool colorToAlpha(const ImageView& img, Color32 key, float mA, float mX);
 }
\ No newline at end of file
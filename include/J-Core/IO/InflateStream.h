@@ -0,0 +1,56 @@
+#pragma once
+#include <J-Core/IO/Stream.h>
+#include <zlib.h>
+
+/// <summary>
+/// Read only decorator that lazily decompresses zlib data from the wrapped stream as it's read.
+/// Output is inflated straight into the caller's buffer, compressed input is taken from the wrapped stream's view when it has one (memory, mapped files)
+/// & otherwise read into an internal pooled buffer. Once the end of the compressed data is reached the wrapped stream is left right after it.
+/// Seeking forward skips, seeking backwards restarts decompression from the beginning so it works but isn't cheap.
+/// </summary>
+class InflateStream : public Stream {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+    static constexpr size_t UNKNOWN_LENGTH = SIZE_MAX;
+
+    /// <summary>
+    /// 'length' is the decompressed size if the container stores it, otherwise size() only becomes exact once the end has been read.
+    /// </summary>
+    InflateStream(const Stream& stream, const size_t length = UNKNOWN_LENGTH, const size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~InflateStream();
+
+    InflateStream(const InflateStream&) = delete;
+    InflateStream& operator=(const InflateStream&) = delete;
+
+    const Stream& getStream() const { return _stream; }
+
+    bool isEOF() const override { return _finished || _position >= _length; }
+    bool isOpen() const override { return _initialized; }
+    bool canWrite() const override { return false; }
+    bool canRead() const override { return _initialized && !_failed && _stream.canRead(); }
+
+    using Stream::read;
+    size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override;
+    size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override { return 0; }
+
+    bool flush() const override { return false; }
+    bool close() const override;
+
+    size_t seek(int64_t offset, int origin) const override;
+
+private:
+    const Stream& _stream;
+    size_t _streamStart;
+    mutable z_stream _zStream;
+    mutable bool _initialized;
+    mutable bool _finished;
+    mutable bool _failed;
+
+    uint8_t* _buffer;
+    size_t _bufferSize;
+    size_t _bufferCapacity;
+
+    size_t inflateOutput(uint8_t* output, const size_t size) const;
+    bool refill() const;
+    bool restart() const;
+};
@@ -0,0 +1,170 @@
+#pragma once
+#include <J-Core/IO/MappedFileStream.h>
+#include <J-Core/IO/MemoryStream.h>
+#include <J-Core/IO/InflateStream.h>
+#include <J-Core/IO/IOUtils.h>
+#include <J-Core/Util/StringId.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace JCore {
+    /// <summary>
+    /// JPAK archive, a read only virtual file system packed into a single file.
+    /// The file is memory mapped on mount, the index is used in place & looked up through a small bucket table built from it,
+    /// so finding an entry is a hash + a scan of a bucket or two without touching the filesystem.
+    ///
+    /// Layout (little endian):
+    ///   Header                       (at 0, padded to ALIGNMENT)
+    ///   Entry data                   (each entry starts at a multiple of ALIGNMENT)
+    ///   Entry[entryCount]            (sorted by hash)
+    ///   Path table                   (the original relative paths, '/' separated, not null terminated)
+    /// Entry hashes are StringId hashes of the normalized path (lower case, '/' separated, no leading "./" or '/').
+    /// </summary>
+    class JPak {
+    public:
+        static constexpr uint32_t SIGNATURE = 0x4B41504AU;
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t ALIGNMENT = 4096;
+
+        enum EntryFlags : uint32_t {
+            ENTRY_None = 0x0,
+            ENTRY_Deflated = 0x1,
+        };
+
+#pragma pack(push, 1)
+        struct Header {
+            uint32_t signature{ SIGNATURE };
+            uint32_t version{ VERSION };
+            uint32_t entryCount{ 0 };
+            uint32_t indexCrc{ 0 };
+            uint64_t indexOffset{ 0 };
+            uint64_t pathsOffset{ 0 };
+            uint64_t pathsSize{ 0 };
+            uint8_t reserved[24]{ 0 };
+        };
+
+        struct Entry {
+            uint64_t hash;
+            uint64_t offset;
+            //Bytes stored in the archive & bytes after decompression, equal unless deflated
+            uint64_t size;
+            uint64_t rawSize;
+            //CRC-32 of the stored bytes, so entries can be verified without inflating them
+            uint32_t crc;
+            uint32_t flags;
+            uint32_t pathOffset;
+            uint32_t pathLength;
+
+            bool isDeflated() const { return (flags & ENTRY_Deflated) != 0; }
+        };
+#pragma pack(pop)
+
+        struct PackParams {
+            //Zlib level for entries, 0 stores everything as is
+            int32_t compression{ 6 };
+            //Deflated data is only kept if it's at most this fraction of the original, already compressed files (PNG, etc) end up stored
+            float maxRatio{ 0.9f };
+            bool recursive{ true };
+            //Optional filter, files it returns false for are left out. Runs on IO::walk's worker threads
+            IO::CheckPath check{ nullptr };
+        };
+
+        JPak();
+        JPak(std::string_view path);
+        ~JPak();
+
+        JPak(const JPak&) = delete;
+        JPak& operator=(const JPak&) = delete;
+
+        bool mount(std::string_view path);
+        void unmount();
+
+        bool isMounted() const { return !_buckets.empty(); }
+        const std::string& getPath() const { return _file.getFilePath(); }
+
+        size_t getEntryCount() const { return _entryCount; }
+        const Entry* getEntries() const { return _entries; }
+        std::string_view getEntryPath(const Entry& entry) const;
+
+        const Entry* find(std::string_view path) const;
+        const Entry* find(StringId id) const;
+        bool contains(std::string_view path) const { return find(path) != nullptr; }
+
+        /// <summary>
+        /// Stored bytes of an entry straight from the mapping, these are still compressed for deflated entries.
+        /// </summary>
+        const uint8_t* getStoredData(const Entry& entry) const;
+
+        bool verify(const Entry& entry) const;
+
+        /// <summary>
+        /// Hash used for the index, normalizes the path first so "Sprites\\Player.png" & "sprites/player.png" match.
+        /// </summary>
+        static StringId hashPath(std::string_view path);
+
+        /// <summary>
+        /// Builds an archive out of every file under 'directory' (found with IO::walk), paths are stored relative to it.
+        /// Files are read & compressed in parallel, then written out in index order.
+        /// </summary>
+        static bool pack(const std::filesystem::path& directory, const std::filesystem::path& output);
+        static bool pack(const std::filesystem::path& directory, const std::filesystem::path& output, const PackParams& params);
+
+    private:
+        MappedFileStream _file;
+        const Entry* _entries;
+        size_t _entryCount;
+        const char* _paths;
+        size_t _pathsSize;
+
+        //_buckets[i] is the first entry whose hash has 'i' in its top bits, there's one extra slot at the end
+        std::vector<uint32_t> _buckets;
+        uint32_t _bucketShift;
+    };
+
+    /// <summary>
+    /// Stream over a single JPAK entry. Stored entries are read straight out of the mapping (tryGetView hands out pointers into it),
+    /// deflated ones go through an InflateStream as they're read. The archive has to stay mounted while the stream is in use.
+    /// </summary>
+    class JPakStream : public Stream {
+    public:
+        JPakStream();
+        JPakStream(const JPak& pak, std::string_view path);
+        JPakStream(const JPak& pak, const JPak::Entry& entry);
+        ~JPakStream();
+
+        JPakStream(const JPakStream&) = delete;
+        JPakStream& operator=(const JPakStream&) = delete;
+
+        bool open(const JPak& pak, std::string_view path) const;
+        bool open(const JPak& pak, const JPak::Entry& entry) const;
+
+        bool isDeflated() const { return _inflate != nullptr; }
+
+        bool isEOF() const override { return _position >= _length; }
+        bool isOpen() const override { return _isOpen; }
+        bool canWrite() const override { return false; }
+        bool canRead() const override { return _isOpen; }
+
+        using Stream::read;
+        size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override;
+        size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override { return 0; }
+
+        bool flush() const override { return false; }
+        bool close() const override;
+
+        size_t seek(int64_t offset, int origin) const override;
+
+        const uint8_t* tryGetView(const size_t size) const override;
+
+    private:
+        mutable const uint8_t* _data;
+        mutable bool _isOpen;
+
+        //Only set for deflated entries, _source is the compressed bytes in the mapping
+        mutable std::unique_ptr<MemoryStream> _source;
+        mutable std::unique_ptr<InflateStream> _inflate;
+    };
+}
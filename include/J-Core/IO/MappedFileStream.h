@@ -0,0 +1,58 @@
+#pragma once
+#include <J-Core/IO/Stream.h>
+#include <string_view>
+
+/// <summary>
+/// Read only stream over a memory mapped file. Reads are plain copies out of the mapping and
+/// tryGetView() hands out pointers straight into it, so parsing headers or pixel data needs no syscalls or extra buffers.
+/// Pages are faulted in by the OS on first touch, the access hint is passed on to it (madvise / PrefetchVirtualMemory).
+/// </summary>
+class MappedFileStream : public Stream {
+public:
+    enum class AccessHint : uint8_t {
+        Normal,
+        Sequential,
+        Random,
+        //Sequential & asks the OS to start reading the whole file in right away
+        WillNeed,
+    };
+
+    MappedFileStream();
+    MappedFileStream(std::string_view filepath, AccessHint hint = AccessHint::Sequential);
+    ~MappedFileStream();
+
+    MappedFileStream(const MappedFileStream&) = delete;
+    MappedFileStream& operator=(const MappedFileStream&) = delete;
+
+    const std::string& getFilePath() const { return _filepath; }
+    const uint8_t* getData() const { return _data; }
+
+    bool open(std::string_view filepath, AccessHint hint = AccessHint::Sequential) const;
+
+    bool isOpen() const override { return _isOpen; }
+    bool canWrite() const override { return false; }
+    bool canRead() const override { return _isOpen; }
+
+    size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override;
+    size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override { return 0; }
+
+    bool flush() const override { return false; }
+    bool close() const override;
+
+    size_t seek(int64_t offset, int origin) const override;
+
+    const uint8_t* tryGetView(const size_t size) const override;
+    void adviseReadAhead(const size_t offset, const size_t length) const override;
+
+private:
+    mutable std::string _filepath;
+    mutable const uint8_t* _data;
+    mutable bool _isOpen;
+
+#ifdef _WIN32
+    mutable void* _file;
+    mutable void* _mapping;
+#else
+    mutable int _file;
+#endif
+};
@@ -24,6 +24,7 @@ public:
     virtual size_t seek(int64_t offset, int origin) const override;
 
     virtual bool tryReserve(const size_t bytes) const override;
+    virtual const uint8_t* tryGetView(const size_t size) const override;
 
 protected:
     static constexpr uint8_t DYNAMIC_FLAG = 0x40;
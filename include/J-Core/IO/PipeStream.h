@@ -0,0 +1,103 @@
+#pragma once
+#include <J-Core/IO/Stream.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+/// <summary>
+/// Single producer/single consumer pipe over a lock-free ring buffer, for chaining stages (read -> inflate -> decode -> ...) across threads
+/// without materializing the whole data in between. One thread writes, one thread reads.
+/// Writes wait while the ring is full (backpressure) and reads wait until all the requested bytes are there or the write end has been closed (EOF).
+/// Only forward seeks are supported (they skip bytes), so consumers that seek backwards need the data buffered elsewhere first.
+/// </summary>
+class PipeStream : public Stream {
+public:
+    enum class WaitMode : uint8_t {
+        //Spins briefly & then sleeps until the other side makes progress
+        Block,
+        //Never sleeps, for stages that run on dedicated cores & want the lowest latency
+        Spin,
+    };
+
+    static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    PipeStream(const size_t capacity = DEFAULT_CAPACITY, const WaitMode mode = WaitMode::Block);
+    ~PipeStream();
+
+    PipeStream(const PipeStream&) = delete;
+    PipeStream& operator=(const PipeStream&) = delete;
+
+    WaitMode getWaitMode() const { return _mode; }
+
+    //Bytes read so far
+    size_t tell() const override { return _tail.load(std::memory_order_acquire); }
+    //Bytes written so far
+    size_t size() const override { return _head.load(std::memory_order_acquire); }
+    size_t available() const { return size() - tell(); }
+
+    bool isEOF() const override;
+    bool isWriteClosed() const { return _writeClosed.load(std::memory_order_acquire); }
+    bool isReadClosed() const { return _readClosed.load(std::memory_order_acquire); }
+
+    bool isOpen() const override { return _buffer != nullptr; }
+    bool canWrite() const override { return _buffer && !isWriteClosed() && !isReadClosed(); }
+    bool canRead() const override { return _buffer && !isReadClosed(); }
+
+    using Stream::read;
+    using Stream::write;
+    size_t read(void* buffer, size_t elementSize, size_t count, const bool bigEndian = false) const override;
+    size_t write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian = false) const override;
+
+    /// <summary>
+    /// Non-blocking variants, move whatever fits/is there right now & return the number of bytes moved.
+    /// </summary>
+    size_t tryRead(void* buffer, const size_t size) const;
+    size_t tryWrite(const void* buffer, const size_t size) const;
+
+    bool flush() const override { return isOpen(); }
+
+    /// <summary>
+    /// Closes the write end, the reader gets the remaining bytes & then EOF. Called by the producer.
+    /// </summary>
+    bool close() const override;
+
+    /// <summary>
+    /// Closes the read end, blocked & future writes return early. Called by the consumer when it stops before EOF.
+    /// </summary>
+    bool closeRead() const;
+
+    size_t seek(int64_t offset, int origin) const override;
+
+    /// <summary>
+    /// Consume bytes only up to the delimiter, the base versions read ahead & seek back which a pipe can't do.
+    /// Both wait for more data until the delimiter or EOF shows up.
+    /// </summary>
+    bool readLine(std::string& output) const override;
+    int32_t readCString(char* str, int32_t maxLen) const override;
+
+private:
+    uint8_t* _buffer;
+    size_t _bufferCapacity;
+    size_t _mask;
+    WaitMode _mode;
+
+    //Total bytes written/read, each only advanced by its own side & kept on separate cache lines
+    alignas(64) mutable std::atomic<size_t> _head;
+    alignas(64) mutable std::atomic<size_t> _tail;
+
+    alignas(64) mutable std::atomic<bool> _writeClosed;
+    mutable std::atomic<bool> _readClosed;
+    mutable std::atomic<uint32_t> _sleepers;
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _cv;
+
+    size_t readRaw(uint8_t* buffer, const size_t size, const bool wait) const;
+    size_t writeRaw(const uint8_t* buffer, const size_t size, const bool wait) const;
+
+    template<typename OnBytes>
+    bool readUntil(const uint8_t delimiter, OnBytes&& onBytes) const;
+
+    template<typename Pred>
+    void waitFor(Pred&& ready) const;
+    void wake() const;
+};
@@ -2,8 +2,12 @@
 #include <string>
 #include <cstdint>
 #include <stdio.h>
+#include <functional>
 #include <J-Core/Util/DataUtils.h>
 
+//(bytes copied so far, total bytes), returning false cancels the copy
+using CopyProgressCB = std::function<bool(size_t, size_t)>;
+
 class Stream {
 public:
     static constexpr uint8_t READ_FLAG = 0x1;
@@ -13,8 +17,8 @@ public:
     Stream(const uint8_t flags, const size_t length = 0, const size_t capacity = 0) : _position(0), _length(length), _flags(flags), _capacity(capacity) {}
     virtual ~Stream() {}
 
-    bool isEOF() const { return _position >= _length; }
-    bool isEOF(size_t length) const { return (_position + length) >= _length; }
+    virtual bool isEOF() const { return _position >= _length; }
+    bool isEOF(size_t length) const { return (tell() + length) >= size(); }
 
     virtual size_t tell() const { return _position; }
     virtual size_t size() const { return _length; }
@@ -94,15 +98,19 @@ public:
         return ret;
     }
 
-    bool readLine(std::string& output) const {
+    /// <summary>
+    /// readLine reads up to the next '\n' ('\r' is dropped), readCString up to the next null.
+    /// The base versions read ahead & seek back to just after what they consumed, streams that can't seek backwards override them.
+    /// </summary>
+    virtual bool readLine(std::string& output) const {
         output.clear();
 
-        if (_position >= _length || !canRead()) {
+        size_t pos = tell();
+        if (pos >= size() || !canRead()) {
             return false;
         }
 
         char temp[8192]{ 0 };
-        size_t pos = _position;
         while (true) {
             size_t read = this->read(temp, 8192, false);
             if (read <= 0) { break; }
@@ -122,12 +130,12 @@ public:
         return true;
     }
 
-    int32_t readCString(char* str, int32_t maxLen) const {
+    virtual int32_t readCString(char* str, int32_t maxLen) const {
         if (!canRead()) { return 0; }
 
         if (maxLen < 1) { return 0; }
         maxLen--;
-        size_t pos = _position;
+        size_t pos = tell();
         int32_t len = 0;
 
         char buffer[256]{ 0 };
@@ -160,31 +168,26 @@ public:
     virtual size_t seek(int64_t offset, int origin) const = 0;
     virtual bool tryReserve(const size_t bytes) const { return true; }
 
-    void copyTo(const Stream& other) const {
-        size_t curPos = _position;
-        size_t remain = _length - _position;
-
-        if (remain < 1) { return; }
-
-        size_t curPosTgt = other._position;
-        size_t remainTgt = other._length - other._position;
-
-        if (remainTgt < remain && !other.tryReserve(((remain - remainTgt) + other._position))) {
-            return;
-        }
-
-        void* data = _malloca(remain);
-        if (!data) { return; }
-
-        this->read(data, remain, false);
-        other.write(data, remain);
-
-        _freea(data);
-        this->seek(curPos, SEEK_SET);
-    }
+    /// <summary>
+    /// Returns a pointer to the next 'size' bytes & moves past them, when the stream's storage can be read directly (memory, mapped files).
+    /// Returns nullptr without moving if it can't or if there aren't 'size' bytes left, callers then fall back to read().
+    /// The pointer stays valid until the next read, write, seek or close on the stream.
+    /// </summary>
+    virtual const uint8_t* tryGetView(const size_t size) const { return nullptr; }
+
+    /// <summary>
+    /// Hint that the given range is about to be read sequentially so the OS can start fetching it, does nothing where that isn't supported.
+    /// </summary>
+    virtual void adviseReadAhead(const size_t offset, const size_t length) const { }
+
+    /// <summary>
+    /// Copies everything from the current position to the end into 'other' at its position, then seeks this stream back.
+    /// Goes straight from memory when this stream exposes it and otherwise in bounded chunks.
+    /// 'onProgress' is called after every chunk & can return false to stop early. Returns the number of bytes copied.
+    /// </summary>
+    size_t copyTo(const Stream& other, const CopyProgressCB& onProgress = nullptr) const;
 
 protected:
-
     mutable uint8_t _flags;
     mutable size_t _position;
     mutable size_t _length;
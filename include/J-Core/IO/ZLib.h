@@ -40,7 +40,7 @@ namespace JCore::ZLib {
     int32_t inflateData(const Stream& streamIn, Stream& target);
 
     int32_t deflateData(void* dataIn, const size_t lenIn, void* dataOut, const size_t lenOut, const int32_t level);
-    int32_t inflateData(void* dataIn, const size_t lenIn, void* dataOut, const size_t lenOut);
+    int32_t inflateData(const void* dataIn, const size_t lenIn, void* dataOut, const size_t lenOut);
 
     int32_t deflateBegin(ZLibContext& context, uint32_t level, void* buffer, const size_t bufferSize);
     int32_t deflateSegment(ZLibContext& context, void* dataIn, const size_t lenIn, const Stream& streamIn, void* buffer, const size_t bufferSize);
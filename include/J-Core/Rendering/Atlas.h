@@ -3,9 +3,10 @@
 #include <vector>
 #include <algorithm>
 #include <J-Core/Rendering/Sprite.h>
-#include <unordered_map>
+#include <J-Core/Rendering/SpritePacking.h>
 #include <J-Core/IO/ImageUtils.h>
-#include <J-Core/Util/PoolAllocator.h>
+#include <J-Core/Util/ConcurrentPoolAllocator.h>
+#include <J-Core/Util/StringId.h>
 #include <J-Core/Util/Stack.h>
 
 namespace JCore {
@@ -16,16 +17,26 @@ namespace JCore {
         bool sort{ true };
         uint16_t maxSize{ 8192 };
         uint8_t padding{ 0 };
+        //The guillotine packer can't rotate, with this set Guillotine packs with MaxRects instead
+        bool allowRotation{ false };
+        PackingMethod method{ PackingMethod::Guillotine };
+        MaxRectsHeuristic heuristic{ MaxRectsHeuristic::BestShortSideFit };
+        PackingSort sortBy{ PackingSort::Area };
         size_t poolInit{0};
         size_t stackInit{0};
+        const uint32_t* duplicateOf{ nullptr };
     };
 
     struct TextureRegion {
         uint32_t original{ 0 };
         SpriteRect rect{};
+        uint8_t flags{ Spr_None };
 
-        TextureRegion() : original(0), rect() {}
-        TextureRegion(uint32_t orignal, SpriteRect rect) : original(orignal), rect(rect) {}
+        TextureRegion() : original(0), rect(), flags(Spr_None) {}
+        TextureRegion(uint32_t orignal, SpriteRect rect) : original(orignal), rect(rect), flags(Spr_None) {}
+        TextureRegion(uint32_t orignal, SpriteRect rect, uint8_t flags) : original(orignal), rect(rect), flags(flags) {}
+
+        bool isRotated() const { return bool(flags & Spr_Rotated); }
     };
 
     struct AtlasDefiniton {
@@ -36,6 +47,58 @@ namespace JCore {
         AtlasDefiniton() : width(), height(), atlas{} {}
     };
 
+    /// <summary>
+    /// Returns a view into the sprite's area of a sheet, no pixels are copied.
+    /// </summary>
+    inline ImageView getSpriteView(const ImageView& sheet, const SpriteRect& rect) {
+        return sheet.getSubView(rect.x, rect.y, rect.width, rect.height);
+    }
+
+    inline ImageView getSpriteView(const ImageView& sheet, const SpriteInfo& sprite) {
+        return getSpriteView(sheet, sprite.rect);
+    }
+
+    /// <summary>
+    /// Finds sprites with identical pixels. 'duplicateOf[i]' is set to the first sprite with the same content (i for unique sprites).
+    /// Hashes are computed in parallel with Data::hash64 and every match is confirmed with memcmp.
+    /// Returns the number of unique sprites, pass duplicateOf.data() to TexturePackingSpecs::duplicateOf to pack only those.
+    /// </summary>
+    size_t findDuplicateSprites(const ImageView* sprites, size_t count, std::vector<uint32_t>& duplicateOf);
+
+    /// <summary>
+    /// Adds a region for every duplicate sprite, sharing the rect (and page) of the sprite it duplicates.
+    /// </summary>
+    void appendDuplicateRegions(const uint32_t* duplicateOf, size_t spriteCount, std::vector<AtlasDefiniton>& results, size_t firstPage);
+
+    struct PackingItem {
+        uint32_t index{ 0 };
+        uint16_t width{ 0 };
+        uint16_t height{ 0 };
+
+        PackingItem() : index(0), width(0), height(0) {}
+        PackingItem(uint32_t index, uint16_t width, uint16_t height) : index(index), width(width), height(height) {}
+    };
+
+    struct RectPackingSpecs {
+        PackingMethod method{ PackingMethod::MaxRects };
+        MaxRectsHeuristic heuristic{ MaxRectsHeuristic::BestShortSideFit };
+        PackingSort sortBy{ PackingSort::Area };
+        bool sort{ true };
+        bool allowRotation{ false };
+        uint16_t maxSize{ 8192 };
+        uint8_t padding{ 0 };
+    };
+
+    /// <summary>
+    /// Packs items with the MaxRects or Skyline packers, pages start at a size estimated from the total area
+    /// and grow in place (doubling the shorter side) until maxSize, items that don't fit anymore go to the next page.
+    /// PackingMethod::Search runs every heuristic & sort order combination on worker threads and keeps the one with
+    /// the fewest pages, then the smallest total page area. The pick only depends on the input so it's deterministic.
+    /// Region rects include the padding on the right & bottom, same as the guillotine packer.
+    /// With allowRotation sprites may be turned 90 degrees clockwise, those regions get Spr_Rotated and a rect with width & height swapped.
+    /// </summary>
+    bool packRects(const PackingItem* items, size_t count, const RectPackingSpecs& specs, std::vector<AtlasDefiniton>& results);
+
     template<typename T>
     bool sortSprites(const T* a, const T* b) {
         const int32_t resoA(a->getWidth() * a->getHeight());
@@ -50,6 +113,31 @@ namespace JCore {
 
     template<typename T>
     bool packSprites(const TexturePackingSpecs<T>& specs, std::vector<AtlasDefiniton>& results) {
+        if (specs.method != PackingMethod::Guillotine || specs.allowRotation) {
+            const size_t firstPage = results.size();
+            std::vector<PackingItem> items{};
+            items.reserve(specs.spriteCount);
+            for (size_t i = 0; i < specs.spriteCount; i++) {
+                if (specs.duplicateOf && specs.duplicateOf[i] != i) { continue; }
+                items.emplace_back(uint32_t(i), uint16_t(specs.sprites[i].getWidth()), uint16_t(specs.sprites[i].getHeight()));
+            }
+
+            RectPackingSpecs rectSpecs{};
+            rectSpecs.method = specs.method == PackingMethod::Guillotine ? PackingMethod::MaxRects : specs.method;
+            rectSpecs.heuristic = specs.heuristic;
+            rectSpecs.sortBy = specs.sortBy;
+            rectSpecs.sort = specs.sort;
+            rectSpecs.allowRotation = specs.allowRotation;
+            rectSpecs.maxSize = specs.maxSize;
+            rectSpecs.padding = specs.padding;
+
+            bool success = packRects(items.data(), items.size(), rectSpecs, results);
+            if (specs.duplicateOf) {
+                appendDuplicateRegions(specs.duplicateOf, specs.spriteCount, results, firstPage);
+            }
+            return success;
+        }
+
         struct PackingNode {
             const T* sprite{};
             SpriteRect rect{};
@@ -59,8 +147,8 @@ namespace JCore {
             PackingNode() : sprite{ nullptr }, rect{}, notLeaf{0}, children{} {}
             ~PackingNode() { clear(); }
 
-            static PoolAllocator<PackingNode>& getAllocator() {
-                static PoolAllocator<PackingNode> allocator{};
+            static ConcurrentPoolAllocator<PackingNode>& getAllocator() {
+                static ConcurrentPoolAllocator<PackingNode> allocator{};
                 return allocator;
             }
 
@@ -139,9 +227,11 @@ namespace JCore {
         Stack<PackingNode*> nodeStack{};
         nodeStack.reserve(specs.stackInit);
 
+        const size_t firstPage = results.size();
         std::vector<const T*> temp;
         temp.reserve(specs.spriteCount);
         for (size_t i = 0; i < specs.spriteCount; i++) {
+            if (specs.duplicateOf && specs.duplicateOf[i] != i) { continue; }
             temp.push_back(&specs.sprites[i]);
         }
 
@@ -193,6 +283,10 @@ namespace JCore {
             res.height = std::min(res.height, specs.maxSize);
             results.push_back(res);
         }
+
+        if (specs.duplicateOf) {
+            appendDuplicateRegions(specs.duplicateOf, specs.spriteCount, results, firstPage);
+        }
         return true;
     }
 
@@ -254,6 +348,27 @@ namespace JCore {
     }
 
 
+    struct AtlasCompositeSpecs {
+        TextureFormat format{ TextureFormat::RGBA32 };
+        uint8_t padding{ 0 };
+        uint8_t extrude{ 0 };
+        bool clear{ true };
+    };
+
+    /// <summary>
+    /// Copies 'src' into 'target' at (x, y), converting it to the target's format (see composeAtlas), turned 90 degrees clockwise if 'rotated'.
+    /// Clipped to the target, returns the area written in target space (empty if nothing was written).
+    /// </summary>
+    SpriteRect blitSprite(const ImageView& src, const ImageView& target, int32_t x, int32_t y, bool rotated = false);
+
+    /// <summary>
+    /// Blits every region of 'definition' into 'output' in parallel, 'sources' are indexed by TextureRegion::original.
+    /// Rotated regions are written turned 90 degrees clockwise through a tiled transpose.
+    /// Sources are converted to specs.format on the fly (RGBA32 & RGB24 accept any source format, other formats only copy as is).
+    /// Edge pixels are extruded into the padding by up to specs.extrude pixels, clamped to half of specs.padding so neighbours never overlap.
+    /// </summary>
+    bool composeAtlas(const AtlasDefiniton& definition, const ImageView* sources, size_t sourceCount, ImageData& output, const AtlasCompositeSpecs& specs = {});
+
     class Texture;
     class Atlas {
     public:
@@ -265,14 +380,15 @@ namespace JCore {
         void applyPixelData(const ImageData& imageData);
 
         std::weak_ptr<Texture> getTexture() const { return _texture; }
-        const Sprite* findByName(const std::string& str) const;
+        const Sprite* findByName(StringId name) const;
+        const Sprite* findByName(std::string_view name) const { return findByName(StringId(name)); }
 
         bool isValid() const;
 
     private:
         std::shared_ptr<Texture> _texture;
         std::vector<Sprite> _sprites;
-        std::unordered_map<std::string, int32_t> _nameToIndex;
+        FlatMap<StringId, int32_t> _nameToIndex;
     };
 
 }
\ No newline at end of file
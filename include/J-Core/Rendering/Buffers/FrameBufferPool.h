@@ -2,8 +2,7 @@
 #include <cstdint>
 #include <vector>
 #include <J-Core/Rendering/Buffers/FrameBuffer.h>
-#include <deque>
-#include <unordered_map>
+#include <J-Core/Util/FlatMap.h>
 static constexpr uint64_t FB_POOL_MAX_TICKS_ACTIVE = 120;
 
 namespace JCore {
@@ -24,7 +23,7 @@ namespace JCore {
             FrameBuffer buffer{};
         };
 
-        std::unordered_map<uint64_t, int32_t> _bufferLut;
+        FlatMap<uint64_t, int32_t> _bufferLut;
         std::vector<PoolInstance> _buffers;
     };
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <J-Core/Rendering/Sprite.h>
+#include <J-Core/Rendering/SpritePacking.h>
+#include <J-Core/IO/ImageUtils.h>
+#include <J-Core/Util/StringId.h>
+
+namespace JCore {
+    class Texture;
+
+    /// <summary>
+    /// RGBA32 atlas that sprites can be added to & removed from at runtime.
+    /// Space comes from a ShelfAllocator, when it's full the least recently used sprites (not used this frame) are evicted.
+    /// Pixels are kept on the CPU and only the changed areas are uploaded on flush().
+    /// Sprites live in stable storage, so pointers & handles of other sprites stay valid across adds, removes and evictions.
+    /// </summary>
+    class DynamicAtlas {
+    public:
+        static constexpr size_t MAX_DIRTY_RECTS = 16;
+
+        struct Handle {
+            uint32_t index{ UINT32_MAX };
+            uint32_t generation{ 0 };
+
+            bool isValid() const { return index != UINT32_MAX; }
+            bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+            bool operator!=(const Handle& other) const { return !(*this == other); }
+        };
+
+        DynamicAtlas(uint16_t width, uint16_t height, uint8_t padding = 1);
+        ~DynamicAtlas();
+
+        DynamicAtlas(const DynamicAtlas&) = delete;
+        DynamicAtlas& operator=(const DynamicAtlas&) = delete;
+
+        /// <summary>
+        /// Copies 'image' into the atlas, evicting least recently used sprites if needed.
+        /// Returns an invalid handle if the image can't fit even after evicting everything not used this frame.
+        /// </summary>
+        Handle add(const ImageView& image, const std::string& name = "");
+        bool remove(Handle handle);
+
+        bool contains(Handle handle) const;
+        Handle findByName(StringId name) const;
+        Handle findByName(std::string_view name) const { return findByName(StringId(name)); }
+
+        /// <summary>
+        /// Returns nullptr for removed/evicted handles, the pointer itself stays valid for the lifetime of the atlas.
+        /// </summary>
+        const Sprite* getSprite(Handle handle) const;
+
+        /// <summary>
+        /// Marks the sprite as used this frame, sprites used in the current frame are never evicted.
+        /// </summary>
+        void touch(Handle handle);
+        void nextFrame() { _frame++; }
+
+        /// <summary>
+        /// Creates the texture on the first call, after that only uploads the areas changed since the last flush.
+        /// Needs to be called on the thread that owns the GL context.
+        /// </summary>
+        bool flush();
+
+        std::weak_ptr<Texture> getTexture() const { return _texture; }
+        const ImageData& getPixels() const { return _pixels; }
+        const ShelfAllocator& getAllocator() const { return _allocator; }
+        const std::vector<PackRect>& getDirtyRects() const { return _dirty; }
+
+        size_t getSpriteCount() const { return _allocator.getAllocationCount(); }
+        size_t getEvictionCount() const { return _evictions; }
+
+    private:
+        struct Entry {
+            Sprite sprite{};
+            StringId name{};
+            uint32_t allocation{ ShelfAllocator::INVALID_ID };
+            uint32_t generation{ 0 };
+            uint64_t lastUsed{ 0 };
+            uint32_t prev{ UINT32_MAX };
+            uint32_t next{ UINT32_MAX };
+        };
+
+        ShelfAllocator _allocator;
+        ImageData _pixels;
+        std::shared_ptr<Texture> _texture;
+        std::deque<Entry> _entries;
+        std::vector<uint32_t> _freeEntries;
+        FlatMap<StringId, uint32_t> _nameToIndex;
+        std::vector<PackRect> _dirty;
+
+        uint32_t _lruHead;
+        uint32_t _lruTail;
+        uint64_t _frame;
+        size_t _evictions;
+        uint8_t _padding;
+
+        const Entry* getEntry(Handle handle) const;
+
+        void release(uint32_t index);
+        void unlink(uint32_t index);
+        void linkFront(uint32_t index);
+        void markDirty(const PackRect& rect);
+    };
+}
@@ -1,8 +1,8 @@
 #pragma once
 #include <cstdint>
-#include <string>
-#include <unordered_map>
+#include <string_view>
 #include <J-Core/Math/Matrix4f.h>
+#include <J-Core/Util/StringId.h>
 
 namespace JCore {
     class Texture;
@@ -14,10 +14,16 @@ namespace JCore {
         bool createShader(const char* vert, const char* frag);
         void release();
 
-        void setUniformMat4f(const std::string& name, const Matrix4f& mat);
+        /// <summary>
+        /// Uniforms are cached by id, ids not interned with StringId::intern can only be resolved through the string_view overloads.
+        /// </summary>
+        void setUniformMat4f(StringId name, const Matrix4f& mat);
+        void setUniformMat4f(std::string_view name, const Matrix4f& mat);
 
-        uint32_t setTexture(const std::string& name, const uint32_t position);
-        uint32_t setTextures(const std::string& name, const Texture* texture, const uint32_t position);
+        uint32_t setTexture(StringId name, const uint32_t position);
+        uint32_t setTexture(std::string_view name, const uint32_t position);
+        uint32_t setTextures(StringId name, const Texture* texture, const uint32_t position);
+        uint32_t setTextures(std::string_view name, const Texture* texture, const uint32_t position);
 
         bool bind() const;
         void unbind() const;
@@ -25,11 +31,20 @@ namespace JCore {
         uint32_t getShaderId() const { return _shaderId; }
 
     private:
-        std::unordered_map<std::string, int32_t> _uniformCache;
+        static constexpr int32_t UNRESOLVED_LOCATION = INT32_MIN;
+
+        struct UniformInfo {
+            int32_t location{ -1 };
+            //Looked up the first time an indexed texture is bound to the uniform
+            int32_t paletteLocation{ UNRESOLVED_LOCATION };
+        };
+
+        FlatMap<StringId, UniformInfo> _uniformCache;
 
         uint32_t _shaderId;
 
         static uint32_t compileShader(const char* shader, uint32_t type);
-        int32_t getUniformLocation(const std::string& name);
+        UniformInfo& getUniform(StringId id, std::string_view name);
+        uint32_t setTextures(StringId id, std::string_view name, const Texture* texture, const uint32_t position);
     };
 }
\ No newline at end of file
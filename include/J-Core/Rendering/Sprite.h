@@ -9,7 +9,7 @@ namespace JCore {
         Spr_None = 0,
 
         Spr_FromAtlas = 0x1,
-        Spr_Rotated = 0x2, //Not supported atm, probably in the future
+        Spr_Rotated = 0x2, //Stored turned 90 degrees clockwise in the texture, the rect is in texture space (width & height swapped)
     };
 
     struct SpriteRect {
@@ -54,6 +54,12 @@ namespace JCore {
         const Vertex* getVertices() const { return _verts; }
         void assignAtlas(Atlas* atlas, bool rotated);
 
+        /// <summary>
+        /// Fills the quad of a sprite at 'info.rect' in a texture of size 'reso', used by every sprite to build its vertices.
+        /// Needs no texture, so the UV mapping can be checked without a GL context.
+        /// </summary>
+        static void buildVerts(const SpriteInfo& info, const glm::i32vec2& reso, Vertex verts[4]);
+
     private:
         SpriteInfo _info;
         Atlas* _atlas;
@@ -0,0 +1,181 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace JCore {
+    enum class PackingMethod : uint8_t {
+        Guillotine,
+        MaxRects,
+        Skyline,
+
+        //Tries every MaxRects heuristic & the skyline packer with every sort order in parallel, keeping the best result
+        Search,
+    };
+
+    enum class MaxRectsHeuristic : uint8_t {
+        BestShortSideFit,
+        BestLongSideFit,
+        BestAreaFit,
+        BottomLeft,
+
+        Count,
+    };
+
+    enum class PackingSort : uint8_t {
+        Area,
+        Height,
+        Width,
+        Perimeter,
+        MaxSide,
+
+        Count,
+    };
+
+    struct PackRect {
+        int32_t x{ 0 }, y{ 0 };
+        int32_t width{ 0 }, height{ 0 };
+
+        PackRect() : x(0), y(0), width(0), height(0) {}
+        PackRect(int32_t x, int32_t y, int32_t width, int32_t height) :
+            x(x), y(y), width(width), height(height) {}
+
+        bool contains(const PackRect& other) const {
+            return other.x >= x && other.y >= y &&
+                other.x + other.width <= x + width &&
+                other.y + other.height <= y + height;
+        }
+
+        bool overlaps(const PackRect& other) const {
+            return other.x < x + width && other.x + other.width > x &&
+                other.y < y + height && other.y + other.height > y;
+        }
+    };
+
+    /// <summary>
+    /// MaxRects bin, free rects are picked using the given heuristic (best short side fit by default).
+    /// The bin can be grown at any time, placed rects stay where they are and the new area is added to the free list.
+    /// With 'allowRotation' a 90 degree turned placement is also scored, the returned rect then has width & height swapped.
+    /// </summary>
+    class MaxRectsBin {
+    public:
+        MaxRectsBin(MaxRectsHeuristic heuristic = MaxRectsHeuristic::BestShortSideFit) :
+            _heuristic(heuristic), _width(0), _height(0), _usedArea(0), _freeRects{}, _newRects{} {}
+        MaxRectsBin(int32_t width, int32_t height, MaxRectsHeuristic heuristic = MaxRectsHeuristic::BestShortSideFit) :
+            MaxRectsBin(heuristic) { reset(width, height); }
+
+        void reset(int32_t width, int32_t height);
+        void grow(int32_t width, int32_t height);
+        bool insert(int32_t width, int32_t height, PackRect& rect, bool allowRotation = false);
+
+        int32_t getWidth() const { return _width; }
+        int32_t getHeight() const { return _height; }
+        uint64_t getUsedArea() const { return _usedArea; }
+        float getOccupancy() const { return _width > 0 && _height > 0 ? float(double(_usedArea) / (double(_width) * _height)) : 0.0f; }
+
+    private:
+        MaxRectsHeuristic _heuristic;
+        int32_t _width;
+        int32_t _height;
+        uint64_t _usedArea;
+        std::vector<PackRect> _freeRects;
+        std::vector<PackRect> _newRects;
+
+        void findPosition(int32_t width, int32_t height, PackRect& rect, int64_t& bestPrimary, int64_t& bestSecondary) const;
+        void place(const PackRect& rect);
+        void pruneFreeRects();
+    };
+
+    /// <summary>
+    /// Bottom-left skyline bin, cheaper than MaxRects but wastes the area under overhangs.
+    /// Growing the width extends the skyline at the floor, growing the height only raises the ceiling.
+    /// Rotation works the same as with MaxRectsBin.
+    /// </summary>
+    class SkylineBin {
+    public:
+        SkylineBin() : _width(0), _height(0), _usedArea(0), _skyline{} {}
+        SkylineBin(int32_t width, int32_t height) : SkylineBin() { reset(width, height); }
+
+        void reset(int32_t width, int32_t height);
+        void grow(int32_t width, int32_t height);
+        bool insert(int32_t width, int32_t height, PackRect& rect, bool allowRotation = false);
+
+        int32_t getWidth() const { return _width; }
+        int32_t getHeight() const { return _height; }
+        uint64_t getUsedArea() const { return _usedArea; }
+        float getOccupancy() const { return _width > 0 && _height > 0 ? float(double(_usedArea) / (double(_width) * _height)) : 0.0f; }
+
+    private:
+        struct Segment {
+            int32_t x, y, width;
+        };
+
+        int32_t _width;
+        int32_t _height;
+        uint64_t _usedArea;
+        std::vector<Segment> _skyline;
+
+        bool fits(size_t index, int32_t width, int32_t height, int32_t& y) const;
+        void addLevel(size_t index, const PackRect& rect);
+    };
+
+    /// <summary>
+    /// Shelf allocator for atlases that change at runtime, rects can be freed one by one and their space gets reused.
+    /// Shelves (rows) are opened top to bottom as needed and a rect goes to the shelf wasting the least height.
+    /// Free spans in a shelf are merged with their neighbours, empty shelves are merged & can be split again for any height.
+    /// Has no GL dependency so it can be driven & checked on its own.
+    /// </summary>
+    class ShelfAllocator {
+    public:
+        static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+        ShelfAllocator() : _width(0), _height(0), _top(0), _usedArea(0), _shelves{}, _allocations{}, _freeIds{} {}
+        ShelfAllocator(int32_t width, int32_t height) : ShelfAllocator() { reset(width, height); }
+
+        void reset(int32_t width, int32_t height);
+
+        /// <summary>
+        /// Returns the id of the allocation or INVALID_ID if there's no room left.
+        /// </summary>
+        uint32_t allocate(int32_t width, int32_t height, PackRect& rect);
+        bool free(uint32_t id);
+
+        bool isAllocated(uint32_t id) const { return id < _allocations.size() && _allocations[id].used; }
+        bool getRect(uint32_t id, PackRect& rect) const;
+
+        int32_t getWidth() const { return _width; }
+        int32_t getHeight() const { return _height; }
+        uint64_t getUsedArea() const { return _usedArea; }
+        size_t getAllocationCount() const { return _allocations.size() - _freeIds.size(); }
+        size_t getShelfCount() const { return _shelves.size(); }
+
+    private:
+        struct Span {
+            int32_t x, width;
+            uint32_t id;
+        };
+
+        struct Shelf {
+            int32_t y, height;
+            std::vector<Span> spans;
+
+            bool isEmpty() const { return spans.size() == 1 && spans[0].id == INVALID_ID; }
+        };
+
+        struct Allocation {
+            PackRect rect;
+            bool used;
+        };
+
+        int32_t _width;
+        int32_t _height;
+        int32_t _top;
+        uint64_t _usedArea;
+        std::vector<Shelf> _shelves;
+        std::vector<Allocation> _allocations;
+        std::vector<uint32_t> _freeIds;
+
+        int32_t findSpan(const Shelf& shelf, int32_t width) const;
+        size_t findShelf(int32_t y) const;
+        void mergeEmptyShelves(size_t index);
+    };
+}
@@ -17,6 +17,12 @@ namespace JCore {
 
         bool create(const uint8_t* input, TextureFormat format, int32_t paletteSize, int32_t width, int32_t height, uint8_t flags);
 
+        /// <summary>
+        /// Uploads 'view' into the area at (x, y) with glTexSubImage2D, the view can be strided (e.g. a sub view of a bigger image).
+        /// Only works for non-indexed textures that were already created with the same format.
+        /// </summary>
+        bool update(const ImageView& view, int32_t x, int32_t y);
+
         bool isValid() const { return bool(_textureId) && _valid; }
 
         int32_t getWidth() const { return _width; }
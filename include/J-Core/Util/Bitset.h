@@ -1,9 +1,41 @@
 #pragma once
 #include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace JCore {
+    namespace detail {
+        inline uint32_t popCount64(uint64_t value) {
+#ifdef _MSC_VER
+            return uint32_t(__popcnt64(value));
+#else
+            return uint32_t(__builtin_popcountll(value));
+#endif
+        }
+
+        //'value' must not be 0
+        inline uint32_t lowestBit64(uint64_t value) {
+#ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanForward64(&index, value);
+            return uint32_t(index);
+#else
+            return uint32_t(__builtin_ctzll(value));
+#endif
+        }
+    }
+
+    /// <summary>
+    /// Bitset stored in 64-bit words, bits past size() are always kept cleared so counts & searches never see them.
+    /// Bulk boolean ops use AVX2 when built with it.
+    /// rank/select work without an index but become near constant time after buildRankIndex(), any modification drops the index.
+    /// </summary>
     class Bitset {
     public:
+        static constexpr size_t npos = SIZE_MAX;
 
         Bitset();
         Bitset(size_t bits);
@@ -11,26 +43,87 @@ namespace JCore {
         Bitset(Bitset&& other) noexcept;
         ~Bitset();
 
-        bool operator[](size_t i) const;
+        Bitset& operator=(const Bitset& other);
+        Bitset& operator=(Bitset&& other) noexcept;
+
+        bool operator[](size_t i) const { return bool((_buffer[i >> 6] >> (i & 63)) & 1); }
 
         size_t size() const { return _bits; }
+        size_t wordCount() const { return (_bits + 63) >> 6; }
+        uint64_t* getWords() { _rankValid = false; return _buffer; }
+        const uint64_t* getWords() const { return _buffer; }
 
         void copyFrom(const Bitset& other);
 
-        void set(size_t i, bool value);
+        void set(size_t i, bool value) {
+            const uint64_t mask = 1ULL << (i & 63);
+            uint64_t& word = _buffer[i >> 6];
+            word = value ? (word | mask) : (word & ~mask);
+            _rankValid = false;
+        }
+
         void setAll(bool value);
+        void setRange(size_t start, size_t count, bool value);
         void resize(size_t bits);
 
         void flip();
         void andWith(const Bitset& other);
         void orWith(const Bitset& other);
         void xorWith(const Bitset& other);
+        void andNotWith(const Bitset& other);
+
+        size_t count() const;
+        size_t countRange(size_t start, size_t count) const;
+        bool any() const;
+        bool none() const { return !any(); }
+        bool all() const;
+
+        /// <summary>
+        /// Index of the first set/cleared bit at or after 'from', npos if there's none.
+        /// </summary>
+        size_t findNextSet(size_t from) const;
+        size_t findNextClear(size_t from) const;
+        size_t findFirstSet() const { return findNextSet(0); }
+
+        /// <summary>
+        /// Calls 'func(index)' for every set bit in ascending order, skips empty words without touching their bits.
+        /// </summary>
+        template<typename Func>
+        void forEachSet(Func func) const {
+            const size_t words = wordCount();
+            for (size_t i = 0; i < words; i++) {
+                for (uint64_t word = _buffer[i]; word; word &= word - 1) {
+                    func((i << 6) + detail::lowestBit64(word));
+                }
+            }
+        }
+
+        void buildRankIndex();
+        bool hasRankIndex() const { return _rankValid; }
+
+        /// <summary>
+        /// Number of set bits before 'i'.
+        /// </summary>
+        size_t rank(size_t i) const;
+
+        /// <summary>
+        /// Index of the n:th (0 based) set bit, npos if there are n or fewer set bits.
+        /// </summary>
+        size_t select(size_t n) const;
 
         void toString(char* buffer, int32_t width, int32_t height) const;
 
     private:
-        uint8_t* _buffer;
+        //A rank entry covers 8 words (512 bits)
+        static constexpr size_t RANK_BLOCK_WORDS = 8;
+
+        uint64_t* _buffer;
         size_t _capacity;
         size_t _bits;
+
+        std::vector<uint64_t> _rankIndex;
+        bool _rankValid;
+
+        void clearTail();
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace JCore {
+    /// <summary>
+    /// Thread-safe cache of 64 byte aligned buffers grouped into size classes (4 classes per power of two).
+    /// Released buffers are kept for reuse until the cached total goes over the trim threshold,
+    /// at which point the largest cached buffers are freed first.
+    /// </summary>
+    class BufferPool {
+    public:
+        static constexpr size_t ALIGNMENT = 64;
+        static constexpr size_t MIN_CLASS_SHIFT = 6;
+        static constexpr size_t MAX_CLASS_SHIFT = 30;
+        static constexpr size_t CLASS_COUNT = (MAX_CLASS_SHIFT - MIN_CLASS_SHIFT) * 4 + 1;
+        static constexpr size_t DEFAULT_MAX_CACHED = 256ULL * 1024 * 1024;
+
+        BufferPool(size_t maxCachedBytes = DEFAULT_MAX_CACHED);
+        ~BufferPool();
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        static BufferPool& getGlobal();
+
+        /// <summary>
+        /// Size actually reserved for a request of 'size' bytes, always a multiple of ALIGNMENT.
+        /// </summary>
+        static size_t getCapacity(size_t size);
+
+        static uint8_t* allocateAligned(size_t size);
+        static void freeAligned(void* ptr);
+
+        uint8_t* allocate(size_t size, size_t& capacity);
+        void deallocate(void* ptr, size_t capacity);
+
+        void trim(size_t targetBytes = 0);
+
+        size_t getCachedBytes() const;
+        size_t getMaxCachedBytes() const;
+        void setMaxCachedBytes(size_t bytes);
+
+    private:
+        mutable std::mutex _mutex;
+        std::vector<void*> _classes[CLASS_COUNT];
+        size_t _cachedBytes;
+        size_t _maxCachedBytes;
+
+        static size_t getClassIndex(size_t size);
+        static size_t getClassSize(size_t index);
+
+        void trimLocked(size_t targetBytes);
+    };
+}
@@ -0,0 +1,451 @@
+#pragma once
+#include <cstdint>
+#include <stdlib.h>
+#include <malloc.h>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+namespace JCore {
+    namespace detail {
+        inline std::atomic<uint64_t>& getPoolIdCounter() {
+            static std::atomic<uint64_t> counter{ 1 };
+            return counter;
+        }
+    }
+
+    /// <summary>
+    /// Thread-caching variant of PoolAllocator with the same interface.
+    /// Every thread allocates from its own magazine (a free list of up to 2 * MAGAZINE_SIZE slots) without any locking.
+    /// Empty magazines are refilled from frees other threads made to this thread's chunks (remote-free list),
+    /// then from a lock-free depot of spare magazines and only then by carving a new chunk.
+    /// Slots of chunks owned by another thread are handed back to that thread through its remote-free list.
+    ///
+    /// allocate/deallocate are thread-safe, reserve/trim/clear take a lock but trim & clear must not run
+    /// while other threads are allocating or deallocating from the same pool.
+    /// </summary>
+    template<typename T>
+    class ConcurrentPoolAllocator {
+    public:
+        static constexpr size_t MAGAZINE_SIZE = 64;
+
+        ConcurrentPoolAllocator() : _id(detail::getPoolIdCounter().fetch_add(1)), _depot(nullptr), _chunkCount(0), _mutex(), _chunks{}, _caches{}, _idleCaches{} {
+            std::lock_guard<std::mutex> lock(getRegistryMutex());
+            getLivePools()[_id] = this;
+        }
+
+        ~ConcurrentPoolAllocator() {
+            {
+                std::lock_guard<std::mutex> lock(getRegistryMutex());
+                getLivePools().erase(_id);
+            }
+            clear(true);
+            for (ThreadCache* cache : _caches) {
+                delete cache;
+            }
+        }
+
+        ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;
+        ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&) = delete;
+
+        const size_t getChunkCount() const { return _chunkCount.load(std::memory_order_relaxed); }
+
+        static ConcurrentPoolAllocator<T>& getGlobal() {
+            static ConcurrentPoolAllocator<T> global{};
+            return global;
+        }
+
+        /// <summary>
+        /// Makes sure at least 'count' free slots are available to the calling thread (its magazine & the depot).
+        /// New chunks go to the depot so other threads can use them as well.
+        /// </summary>
+        void reserve(int64_t count) {
+            count -= int64_t(getCache()->localCount);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            FreeNode* depot = _depot.exchange(nullptr, std::memory_order_acquire);
+            if (depot) {
+                FreeNode* last = depot;
+                for (; last->nextBatch; last = last->nextBatch) {
+                    count -= int64_t(last->count);
+                }
+                count -= int64_t(last->count);
+                pushChain(depot, last);
+            }
+
+            while (count > 0) {
+                Chunk* chunk = newChunk(nullptr);
+                if (!chunk) { return; }
+                pushBatch(linkSlots(chunk), SLOT_COUNT);
+                count -= int64_t(SLOT_COUNT);
+            }
+        }
+
+        T* allocate() {
+            FreeNode* node = popLocal();
+            if (!node) { return nullptr; }
+            return new (node) T();
+        }
+
+        template<class... Args>
+        T* allocate(Args&&... args) {
+            FreeNode* node = popLocal();
+            if (!node) { return nullptr; }
+            return new (node) T(std::forward<Args>(args)...);
+        }
+
+        /// <summary>
+        /// 'obj' must be null or a pointer returned by this allocator (from any thread).
+        /// </summary>
+        bool deallocate(T* obj) {
+            if (!obj) { return false; }
+
+            Chunk* chunk = Chunk::fromPointer(obj);
+            if (chunk->pool != this) { return false; }
+
+            obj->~T();
+
+            FreeNode* node = reinterpret_cast<FreeNode*>(obj);
+            ThreadCache* cache = getCache();
+            if (chunk->owner && chunk->owner != cache) {
+                std::atomic<FreeNode*>& remote = chunk->owner->remote;
+                node->next = remote.load(std::memory_order_relaxed);
+                while (!remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+                return true;
+            }
+
+            node->next = cache->local;
+            cache->local = node;
+            if (++cache->localCount >= MAGAZINE_SIZE * 2) {
+                //Hand a full magazine to the depot so a thread that mostly frees doesn't hoard slots
+                FreeNode* last = cache->local;
+                for (size_t i = 1; i < MAGAZINE_SIZE; i++) {
+                    last = last->next;
+                }
+                FreeNode* batch = cache->local;
+                cache->local = last->next;
+                cache->localCount -= MAGAZINE_SIZE;
+                last->next = nullptr;
+                pushBatch(batch, MAGAZINE_SIZE);
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Frees chunks without live objects. Not safe to call while other threads use the pool.
+        /// </summary>
+        void trim() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::unordered_map<Chunk*, uint64_t> freeMasks = gatherFreeSlots();
+
+            size_t kept = 0;
+            for (Chunk* chunk : _chunks) {
+                auto find = freeMasks.find(chunk);
+                const uint64_t mask = find != freeMasks.end() ? find->second : 0;
+                if (mask == FULL_MASK) {
+                    freeChunk(chunk);
+                    continue;
+                }
+
+                _chunks[kept++] = chunk;
+                returnFreeSlots(chunk, mask);
+            }
+            _chunks.resize(kept);
+            _chunkCount.store(kept, std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Destroys every live object, 'full' also frees all chunks. Not safe to call while other threads use the pool.
+        /// </summary>
+        void clear(bool full) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::unordered_map<Chunk*, uint64_t> freeMasks = gatherFreeSlots();
+
+            for (Chunk* chunk : _chunks) {
+                auto find = freeMasks.find(chunk);
+                const uint64_t live = FULL_MASK & ~(find != freeMasks.end() ? find->second : 0);
+                for (size_t i = 0; i < SLOT_COUNT; i++) {
+                    if (live & (1ULL << i)) {
+                        reinterpret_cast<T*>(chunk->getSlot(i))->~T();
+                    }
+                }
+
+                if (full) {
+                    freeChunk(chunk);
+                }
+                else {
+                    returnFreeSlots(chunk, FULL_MASK);
+                }
+            }
+
+            if (full) {
+                _chunks.clear();
+                _chunkCount.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        struct FreeNode {
+            FreeNode* next;
+            FreeNode* nextBatch;
+            size_t count;
+        };
+
+        struct ThreadCache {
+            FreeNode* local{ nullptr };
+            size_t localCount{ 0 };
+            std::atomic<FreeNode*> remote{ nullptr };
+        };
+
+        static constexpr size_t SLOT_ALIGN = alignof(T) > alignof(FreeNode) ? alignof(T) : alignof(FreeNode);
+        static constexpr size_t SLOT_SIZE = (((sizeof(T) > sizeof(FreeNode) ? sizeof(T) : sizeof(FreeNode)) + SLOT_ALIGN - 1) / SLOT_ALIGN) * SLOT_ALIGN;
+        static constexpr size_t HEADER_SIZE = ((sizeof(void*) * 2 + SLOT_ALIGN - 1) / SLOT_ALIGN) * SLOT_ALIGN;
+
+        //Same sizing as PoolChunk, smallest power of two holding at least 32 slots (64 at most)
+        static constexpr size_t CHUNK_ALIGN = []() {
+            size_t align = 256;
+            while ((align - HEADER_SIZE) / SLOT_SIZE < 32) { align <<= 1; }
+            return align;
+        }();
+        static constexpr size_t SLOT_COUNT = (CHUNK_ALIGN - HEADER_SIZE) / SLOT_SIZE < 64 ? (CHUNK_ALIGN - HEADER_SIZE) / SLOT_SIZE : 64;
+        static constexpr uint64_t FULL_MASK = SLOT_COUNT >= 64 ? UINT64_MAX : (1ULL << SLOT_COUNT) - 1;
+
+        struct Chunk {
+            ConcurrentPoolAllocator<T>* pool;
+            ThreadCache* owner;
+
+            uint8_t* getSlot(size_t index) { return reinterpret_cast<uint8_t*>(this) + HEADER_SIZE + index * SLOT_SIZE; }
+            size_t indexOf(const void* ptr) { return size_t(reinterpret_cast<const uint8_t*>(ptr) - getSlot(0)) / SLOT_SIZE; }
+
+            static Chunk* fromPointer(const void* ptr) {
+                return reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t(CHUNK_ALIGN - 1));
+            }
+        };
+
+        struct CacheRef {
+            uint64_t poolId;
+            ThreadCache* cache;
+        };
+
+        //Per thread list of caches, gives them back to their pools (if still alive) when the thread exits
+        struct ThreadCaches {
+            uint64_t lastId{ 0 };
+            ThreadCache* last{ nullptr };
+            std::vector<CacheRef> refs{};
+
+            ~ThreadCaches() {
+                std::lock_guard<std::mutex> lock(getRegistryMutex());
+                auto& pools = getLivePools();
+                for (const CacheRef& ref : refs) {
+                    auto find = pools.find(ref.poolId);
+                    if (find != pools.end()) {
+                        find->second->detachCache(ref.cache);
+                    }
+                }
+            }
+        };
+
+        uint64_t _id;
+        std::atomic<FreeNode*> _depot;
+        std::atomic<size_t> _chunkCount;
+
+        std::mutex _mutex;
+        std::vector<Chunk*> _chunks;
+        std::vector<ThreadCache*> _caches;
+        std::vector<ThreadCache*> _idleCaches;
+
+        static std::mutex& getRegistryMutex() {
+            static std::mutex mutex{};
+            return mutex;
+        }
+
+        static std::unordered_map<uint64_t, ConcurrentPoolAllocator<T>*>& getLivePools() {
+            static std::unordered_map<uint64_t, ConcurrentPoolAllocator<T>*> pools{};
+            return pools;
+        }
+
+        ThreadCache* getCache() {
+            thread_local ThreadCaches caches{};
+            if (caches.last && caches.lastId == _id) { return caches.last; }
+
+            ThreadCache* cache = nullptr;
+            for (const CacheRef& ref : caches.refs) {
+                if (ref.poolId == _id) {
+                    cache = ref.cache;
+                    break;
+                }
+            }
+
+            if (!cache) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_idleCaches.size() > 0) {
+                    cache = _idleCaches.back();
+                    _idleCaches.pop_back();
+                }
+                else {
+                    cache = new ThreadCache();
+                    _caches.push_back(cache);
+                }
+                caches.refs.push_back({ _id, cache });
+            }
+
+            caches.lastId = _id;
+            caches.last = cache;
+            return cache;
+        }
+
+        void detachCache(ThreadCache* cache) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (cache->local) {
+                pushBatch(cache->local, cache->localCount);
+                cache->local = nullptr;
+                cache->localCount = 0;
+            }
+
+            //Its remote list stays, whichever thread adopts the cache next drains it
+            _idleCaches.push_back(cache);
+        }
+
+        FreeNode* popLocal() {
+            ThreadCache* cache = getCache();
+            if (!cache->local) {
+                refill(cache);
+                if (!cache->local) { return nullptr; }
+            }
+
+            FreeNode* node = cache->local;
+            cache->local = node->next;
+            cache->localCount--;
+            return node;
+        }
+
+        void refill(ThreadCache* cache) {
+            FreeNode* remote = cache->remote.exchange(nullptr, std::memory_order_acquire);
+            if (remote) {
+                size_t count = 0;
+                for (FreeNode* node = remote; node; node = node->next) { count++; }
+                cache->local = remote;
+                cache->localCount = count;
+                return;
+            }
+
+            FreeNode* batch = popBatch();
+            if (batch) {
+                cache->local = batch;
+                cache->localCount = batch->count;
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            Chunk* chunk = newChunk(cache);
+            if (chunk) {
+                cache->local = linkSlots(chunk);
+                cache->localCount = SLOT_COUNT;
+            }
+        }
+
+        void pushBatch(FreeNode* batch, size_t count) {
+            batch->count = count;
+            pushChain(batch, batch);
+        }
+
+        void pushChain(FreeNode* first, FreeNode* last) {
+            last->nextBatch = _depot.load(std::memory_order_relaxed);
+            while (!_depot.compare_exchange_weak(last->nextBatch, first, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+
+        FreeNode* popBatch() {
+            //Taking the whole stack & pushing the rest back avoids the ABA problem of popping a single node
+            FreeNode* head = _depot.exchange(nullptr, std::memory_order_acquire);
+            if (!head) { return nullptr; }
+
+            FreeNode* rest = head->nextBatch;
+            head->nextBatch = nullptr;
+            if (rest) {
+                FreeNode* last = rest;
+                while (last->nextBatch) { last = last->nextBatch; }
+                pushChain(rest, last);
+            }
+            return head;
+        }
+
+        Chunk* newChunk(ThreadCache* owner) {
+#ifdef _WIN32
+            void* mem = _aligned_malloc(CHUNK_ALIGN, CHUNK_ALIGN);
+#else
+            void* mem = nullptr;
+            if (posix_memalign(&mem, CHUNK_ALIGN, CHUNK_ALIGN) != 0) { mem = nullptr; }
+#endif
+            if (!mem) { return nullptr; }
+
+            Chunk* chunk = reinterpret_cast<Chunk*>(mem);
+            chunk->pool = this;
+            chunk->owner = owner;
+            _chunks.push_back(chunk);
+            _chunkCount.fetch_add(1, std::memory_order_relaxed);
+            return chunk;
+        }
+
+        static void freeChunk(Chunk* chunk) {
+#ifdef _WIN32
+            _aligned_free(chunk);
+#else
+            free(chunk);
+#endif
+        }
+
+        static FreeNode* linkSlots(Chunk* chunk) {
+            for (size_t i = 0; i < SLOT_COUNT; i++) {
+                reinterpret_cast<FreeNode*>(chunk->getSlot(i))->next = i + 1 < SLOT_COUNT ? reinterpret_cast<FreeNode*>(chunk->getSlot(i + 1)) : nullptr;
+            }
+            return reinterpret_cast<FreeNode*>(chunk->getSlot(0));
+        }
+
+        void markFree(std::unordered_map<Chunk*, uint64_t>& masks, FreeNode* node) {
+            for (; node; node = node->next) {
+                Chunk* chunk = Chunk::fromPointer(node);
+                masks[chunk] |= 1ULL << chunk->indexOf(node);
+            }
+        }
+
+        std::unordered_map<Chunk*, uint64_t> gatherFreeSlots() {
+            std::unordered_map<Chunk*, uint64_t> masks{};
+            masks.reserve(_chunks.size());
+            for (ThreadCache* cache : _caches) {
+                markFree(masks, cache->local);
+                markFree(masks, cache->remote.exchange(nullptr, std::memory_order_acquire));
+                cache->local = nullptr;
+                cache->localCount = 0;
+            }
+
+            for (FreeNode* batch = _depot.exchange(nullptr, std::memory_order_acquire); batch;) {
+                FreeNode* next = batch->nextBatch;
+                markFree(masks, batch);
+                batch = next;
+            }
+            return masks;
+        }
+
+        void returnFreeSlots(Chunk* chunk, uint64_t mask) {
+            FreeNode* head = nullptr;
+            size_t count = 0;
+            for (size_t i = SLOT_COUNT; i > 0; i--) {
+                if (mask & (1ULL << (i - 1))) {
+                    FreeNode* node = reinterpret_cast<FreeNode*>(chunk->getSlot(i - 1));
+                    node->next = head;
+                    head = node;
+                    count++;
+                }
+            }
+
+            //Ownership is dropped, after a trim/clear slots of the chunk are freed into whichever thread frees them
+            chunk->owner = nullptr;
+            if (head) {
+                pushBatch(head, count);
+            }
+        }
+    };
+}
@@ -88,6 +88,76 @@ namespace JCore {
             return updateCRC(crc, &value, sizeof(T));
         }
 
+        inline uint64_t rotl64(uint64_t value, int32_t bits) {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        /// <summary>
+        /// 64-bit non-cryptographic hash (XXH64), much faster than the byte-wise CRC for large buffers.
+        /// Feed the previous result in as 'seed' to hash non-contiguous data piece by piece.
+        /// </summary>
+        inline uint64_t hash64(const void* data, size_t length, uint64_t seed = 0) {
+            static constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+            static constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+            static constexpr uint64_t P3 = 0x165667B19E3779F9ULL;
+            static constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+            static constexpr uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+            auto read64 = [](const uint8_t* ptr) { uint64_t v; memcpy(&v, ptr, 8); return v; };
+            auto read32 = [](const uint8_t* ptr) { uint32_t v; memcpy(&v, ptr, 4); return v; };
+            auto round = [](uint64_t acc, uint64_t input) { return rotl64(acc + input * P2, 31) * P1; };
+            auto merge = [&round](uint64_t acc, uint64_t val) { return (acc ^ round(0, val)) * P1 + P4; };
+
+            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+            const uint8_t* end = ptr + length;
+            uint64_t h;
+
+            if (length >= 32) {
+                uint64_t v1 = seed + P1 + P2;
+                uint64_t v2 = seed + P2;
+                uint64_t v3 = seed;
+                uint64_t v4 = seed - P1;
+                for (const uint8_t* limit = end - 32; ptr <= limit; ptr += 32) {
+                    v1 = round(v1, read64(ptr));
+                    v2 = round(v2, read64(ptr + 8));
+                    v3 = round(v3, read64(ptr + 16));
+                    v4 = round(v4, read64(ptr + 24));
+                }
+                h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+                h = merge(h, v1);
+                h = merge(h, v2);
+                h = merge(h, v3);
+                h = merge(h, v4);
+            }
+            else {
+                h = seed + P5;
+            }
+
+            h += uint64_t(length);
+            for (; ptr + 8 <= end; ptr += 8) {
+                h ^= round(0, read64(ptr));
+                h = rotl64(h, 27) * P1 + P4;
+            }
+
+            if (ptr + 4 <= end) {
+                h ^= uint64_t(read32(ptr)) * P1;
+                h = rotl64(h, 23) * P2 + P3;
+                ptr += 4;
+            }
+
+            for (; ptr < end; ptr++) {
+                h ^= (*ptr) * P5;
+                h = rotl64(h, 11) * P1;
+            }
+
+            h ^= h >> 33;
+            h *= P2;
+            h ^= h >> 29;
+            h *= P3;
+            h ^= h >> 32;
+            return h;
+        }
+
         template<typename T>
         T read(const void* data) {
             return data ? *reinterpret_cast<const T*>(data) : {};
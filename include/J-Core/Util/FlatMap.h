@@ -0,0 +1,431 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define JCORE_FLATMAP_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace JCore {
+    namespace detail {
+        inline uint64_t mixHash(uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xFF51AFD7ED558CCDULL;
+            value ^= value >> 33;
+            value *= 0xC4CEB9FE1A85EC53ULL;
+            value ^= value >> 33;
+            return value;
+        }
+
+        inline uint64_t hashBytes(const void* data, size_t length) {
+            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+            uint64_t hash = 0x9E3779B97F4A7C15ULL ^ (uint64_t(length) * 0xC6A4A7935BD1E995ULL);
+            uint64_t word = 0;
+            for (; length >= 8; ptr += 8, length -= 8) {
+                memcpy(&word, ptr, 8);
+                hash ^= word * 0xC6A4A7935BD1E995ULL;
+                hash = ((hash << 31) | (hash >> 33)) * 0x9E3779B97F4A7C15ULL;
+            }
+
+            if (length > 0) {
+                word = 0;
+                memcpy(&word, ptr, length);
+                hash ^= word * 0xC6A4A7935BD1E995ULL;
+                hash = ((hash << 31) | (hash >> 33)) * 0x9E3779B97F4A7C15ULL;
+            }
+            return mixHash(hash);
+        }
+
+        inline uint32_t lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return uint32_t(index);
+#else
+            return uint32_t(__builtin_ctz(mask));
+#endif
+        }
+    }
+
+    template<typename T, typename = void>
+    struct FlatHash {
+        uint64_t operator()(const T& value) const { return detail::mixHash(uint64_t(std::hash<T>{}(value))); }
+    };
+
+    template<typename T>
+    struct FlatHash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>> {
+        uint64_t operator()(T value) const { return detail::mixHash(uint64_t(value)); }
+    };
+
+    template<typename T>
+    struct FlatHash<T*> {
+        uint64_t operator()(const T* value) const { return detail::mixHash(uint64_t(reinterpret_cast<uintptr_t>(value))); }
+    };
+
+    /// <summary>
+    /// Transparent string hash, std::string keys can be looked up with string_views & literals without building a string.
+    /// </summary>
+    struct FlatStringHash {
+        uint64_t operator()(std::string_view str) const { return detail::hashBytes(str.data(), str.length()); }
+    };
+
+    template<> struct FlatHash<std::string> : FlatStringHash {};
+    template<> struct FlatHash<std::string_view> : FlatStringHash {};
+
+    /// <summary>
+    /// Open addressing hash map with Swiss table style probing. Every slot has a control byte (empty, deleted or 7 bits of the hash)
+    /// and lookups compare 16 control bytes at once, so keys are only touched on a likely match.
+    /// Keys & values live in one flat array, there's no allocation per entry.
+    /// Lookups are heterogeneous, anything 'Hash' & 'Eq' accept works as a key (e.g. string_view for std::string keys).
+    /// Inserting may rehash, which invalidates iterators & pointers to entries. Erasing only invalidates the erased entry.
+    /// </summary>
+    template<typename K, typename V, typename Hash = FlatHash<K>, typename Eq = std::equal_to<>>
+    class FlatMap {
+    public:
+        using value_type = std::pair<K, V>;
+
+        static constexpr size_t GROUP_WIDTH = 16;
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        template<bool isConst>
+        class Iterator {
+        public:
+            using MapPtr = std::conditional_t<isConst, const FlatMap*, FlatMap*>;
+            using Reference = std::conditional_t<isConst, const value_type&, value_type&>;
+            using Pointer = std::conditional_t<isConst, const value_type*, value_type*>;
+
+            Iterator() : _map(nullptr), _index(0) {}
+            Iterator(MapPtr map, size_t index) : _map(map), _index(index) {}
+            operator Iterator<true>() const { return Iterator<true>(_map, _index); }
+
+            Reference operator*() const { return _map->_slots[_index]; }
+            Pointer operator->() const { return _map->_slots + _index; }
+
+            Iterator& operator++() {
+                _index = _map->nextFull(_index + 1);
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            bool operator==(const Iterator& other) const { return _index == other._index; }
+            bool operator!=(const Iterator& other) const { return _index != other._index; }
+
+        private:
+            friend class FlatMap;
+            MapPtr _map;
+            size_t _index;
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        FlatMap() : _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _growthLeft(0), _hash(), _eq() {}
+        FlatMap(size_t capacity) : FlatMap() { reserve(capacity); }
+
+        FlatMap(const FlatMap& other) : FlatMap() { *this = other; }
+        FlatMap(FlatMap&& other) noexcept : FlatMap() { *this = std::move(other); }
+
+        ~FlatMap() {
+            release();
+        }
+
+        FlatMap& operator=(const FlatMap& other) {
+            if (this == &other) { return *this; }
+            clear();
+            reserve(other._size);
+            for (const auto& entry : other) {
+                insert(entry);
+            }
+            return *this;
+        }
+
+        FlatMap& operator=(FlatMap&& other) noexcept {
+            if (this == &other) { return *this; }
+            release();
+            std::swap(_ctrl, other._ctrl);
+            std::swap(_slots, other._slots);
+            std::swap(_capacity, other._capacity);
+            std::swap(_size, other._size);
+            std::swap(_growthLeft, other._growthLeft);
+            return *this;
+        }
+
+        size_t size() const { return _size; }
+        size_t capacity() const { return _capacity; }
+        bool empty() const { return _size == 0; }
+
+        iterator begin() { return iterator(this, nextFull(0)); }
+        iterator end() { return iterator(this, _capacity); }
+        const_iterator begin() const { return const_iterator(this, nextFull(0)); }
+        const_iterator end() const { return const_iterator(this, _capacity); }
+
+        template<typename Q>
+        iterator find(const Q& key) {
+            const size_t index = findIndex(key);
+            return iterator(this, index < _capacity ? index : _capacity);
+        }
+
+        template<typename Q>
+        const_iterator find(const Q& key) const {
+            const size_t index = findIndex(key);
+            return const_iterator(this, index < _capacity ? index : _capacity);
+        }
+
+        template<typename Q>
+        bool contains(const Q& key) const { return findIndex(key) < _capacity; }
+
+        /// <summary>
+        /// Returns a pointer to the value or nullptr, saves comparing against end() at call sites.
+        /// </summary>
+        template<typename Q>
+        V* tryGet(const Q& key) {
+            const size_t index = findIndex(key);
+            return index < _capacity ? &_slots[index].second : nullptr;
+        }
+
+        template<typename Q>
+        const V* tryGet(const Q& key) const {
+            const size_t index = findIndex(key);
+            return index < _capacity ? &_slots[index].second : nullptr;
+        }
+
+        /// <summary>
+        /// Constructs the value from 'args' only if 'key' isn't in the map yet, the key is converted to K only in that case too.
+        /// </summary>
+        template<typename Q, typename... Args>
+        std::pair<iterator, bool> tryEmplace(Q&& key, Args&&... args) {
+            const uint64_t hash = _hash(key);
+            size_t index = findIndex(key, hash);
+            if (index < _capacity) { return { iterator(this, index), false }; }
+
+            index = prepareInsert(hash);
+            new (_slots + index) value_type(std::piecewise_construct,
+                std::forward_as_tuple(std::forward<Q>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+            return { iterator(this, index), true };
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value) { return tryEmplace(value.first, value.second); }
+        std::pair<iterator, bool> insert(value_type&& value) { return tryEmplace(std::move(value.first), std::move(value.second)); }
+
+        template<typename Q>
+        V& operator[](Q&& key) { return tryEmplace(std::forward<Q>(key)).first->second; }
+
+        template<typename Q>
+        bool erase(const Q& key) {
+            const size_t index = findIndex(key);
+            if (index >= _capacity) { return false; }
+            eraseAt(index);
+            return true;
+        }
+
+        void erase(const_iterator it) {
+            if (it._index < _capacity) {
+                eraseAt(it._index);
+            }
+        }
+        void erase(iterator it) { erase(const_iterator(it)); }
+
+        void clear() {
+            if (_capacity == 0) { return; }
+            destroyAll();
+            memset(_ctrl, CTRL_EMPTY, _capacity + GROUP_WIDTH);
+            _size = 0;
+            _growthLeft = maxLoad(_capacity);
+        }
+
+        /// <summary>
+        /// Makes room for at least 'count' entries without rehashing.
+        /// </summary>
+        void reserve(size_t count) {
+            size_t capacity = MIN_CAPACITY;
+            while (maxLoad(capacity) < count) { capacity <<= 1; }
+            if (capacity > _capacity) {
+                rehash(capacity);
+            }
+        }
+
+    private:
+        template<bool isConst>
+        friend class Iterator;
+
+        static constexpr int8_t CTRL_EMPTY = -128;
+        static constexpr int8_t CTRL_DELETED = -2;
+        static constexpr int8_t CTRL_SENTINEL = -1;
+
+        //Control bytes of one probe group, bit N of the returned masks is set if byte N matched
+        struct Group {
+#ifdef JCORE_FLATMAP_SSE2
+            __m128i ctrl;
+            explicit Group(const int8_t* pos) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+            uint32_t match(int8_t h2) const { return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))); }
+            uint32_t matchEmpty() const { return match(CTRL_EMPTY); }
+            uint32_t matchFree() const { return uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(CTRL_SENTINEL), ctrl))); }
+#else
+            const int8_t* ctrl;
+            explicit Group(const int8_t* pos) : ctrl(pos) {}
+
+            uint32_t match(int8_t h2) const {
+                uint32_t mask = 0;
+                for (uint32_t i = 0; i < GROUP_WIDTH; i++) {
+                    mask |= uint32_t(ctrl[i] == h2) << i;
+                }
+                return mask;
+            }
+            uint32_t matchEmpty() const { return match(CTRL_EMPTY); }
+            uint32_t matchFree() const {
+                uint32_t mask = 0;
+                for (uint32_t i = 0; i < GROUP_WIDTH; i++) {
+                    mask |= uint32_t(ctrl[i] < CTRL_SENTINEL) << i;
+                }
+                return mask;
+            }
+#endif
+        };
+
+        //The first GROUP_WIDTH control bytes are mirrored past the end, so a group can be loaded at any slot without wrapping
+        int8_t* _ctrl;
+        value_type* _slots;
+        size_t _capacity;
+        size_t _size;
+        size_t _growthLeft;
+        Hash _hash;
+        Eq _eq;
+
+        static constexpr size_t maxLoad(size_t capacity) { return capacity - (capacity >> 3); }
+        static constexpr int8_t getH2(uint64_t hash) { return int8_t(hash & 0x7F); }
+        size_t getH1(uint64_t hash) const { return size_t(hash >> 7) & (_capacity - 1); }
+
+        template<typename Q>
+        size_t findIndex(const Q& key) const {
+            return _size > 0 ? findIndex(key, _hash(key)) : SIZE_MAX;
+        }
+
+        template<typename Q>
+        size_t findIndex(const Q& key, uint64_t hash) const {
+            if (_size == 0) { return SIZE_MAX; }
+
+            const int8_t h2 = getH2(hash);
+            size_t pos = getH1(hash);
+            for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+                const Group group(_ctrl + pos);
+                for (uint32_t mask = group.match(h2); mask; mask &= mask - 1) {
+                    const size_t index = (pos + detail::lowestBit(mask)) & (_capacity - 1);
+                    if (_eq(_slots[index].first, key)) { return index; }
+                }
+
+                //The load factor keeps empty slots around, so every probe sequence ends
+                if (group.matchEmpty()) { return SIZE_MAX; }
+                pos = (pos + step) & (_capacity - 1);
+            }
+        }
+
+        size_t findFree(uint64_t hash) const {
+            size_t pos = getH1(hash);
+            for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+                const uint32_t mask = Group(_ctrl + pos).matchFree();
+                if (mask) { return (pos + detail::lowestBit(mask)) & (_capacity - 1); }
+                pos = (pos + step) & (_capacity - 1);
+            }
+        }
+
+        size_t prepareInsert(uint64_t hash) {
+            if (_growthLeft == 0) {
+                //Mostly tombstones, rehashing in place is enough to clean them up
+                rehash(_capacity == 0 ? MIN_CAPACITY : _size < (maxLoad(_capacity) >> 1) ? _capacity : _capacity << 1);
+            }
+
+            const size_t index = findFree(hash);
+            if (_ctrl[index] == CTRL_EMPTY) {
+                _growthLeft--;
+            }
+            setCtrl(index, getH2(hash));
+            _size++;
+            return index;
+        }
+
+        void setCtrl(size_t index, int8_t value) {
+            _ctrl[index] = value;
+            if (index < GROUP_WIDTH) {
+                _ctrl[index + _capacity] = value;
+            }
+        }
+
+        void eraseAt(size_t index) {
+            _slots[index].~value_type();
+            setCtrl(index, CTRL_DELETED);
+            _size--;
+        }
+
+        size_t nextFull(size_t index) const {
+            while (index < _capacity && _ctrl[index] < 0) { index++; }
+            return index;
+        }
+
+        void destroyAll() {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_t i = 0; i < _capacity; i++) {
+                    if (_ctrl[i] >= 0) {
+                        _slots[i].~value_type();
+                    }
+                }
+            }
+        }
+
+        void rehash(size_t capacity) {
+            int8_t* oldCtrl = _ctrl;
+            value_type* oldSlots = _slots;
+            const size_t oldCapacity = _capacity;
+
+            _ctrl = new int8_t[capacity + GROUP_WIDTH];
+            _slots = static_cast<value_type*>(::operator new(sizeof(value_type) * capacity, std::align_val_t(alignof(value_type))));
+            _capacity = capacity;
+            _growthLeft = maxLoad(capacity) - _size;
+            memset(_ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+
+            for (size_t i = 0; i < oldCapacity; i++) {
+                if (oldCtrl[i] < 0) { continue; }
+                const uint64_t hash = _hash(oldSlots[i].first);
+                const size_t index = findFree(hash);
+                setCtrl(index, getH2(hash));
+                new (_slots + index) value_type(std::move(oldSlots[i]));
+                oldSlots[i].~value_type();
+            }
+
+            if (oldCtrl) {
+                delete[] oldCtrl;
+                ::operator delete(oldSlots, std::align_val_t(alignof(value_type)));
+            }
+        }
+
+        void release() {
+            if (!_ctrl) { return; }
+            destroyAll();
+            delete[] _ctrl;
+            ::operator delete(_slots, std::align_val_t(alignof(value_type)));
+            _ctrl = nullptr;
+            _slots = nullptr;
+            _capacity = 0;
+            _size = 0;
+            _growthLeft = 0;
+        }
+    };
+}
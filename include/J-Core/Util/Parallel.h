@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+namespace JCore::Parallel {
+    inline size_t getWorkerCount() {
+        static const size_t WORKERS = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        return WORKERS;
+    }
+
+    /// <summary>
+    /// Splits [0, count) into contiguous bands and calls func(begin, end) for each band,
+    /// using the calling thread as one of the workers. Blocks until every band is done.
+    /// </summary>
+    template<typename Func>
+    void forRange(size_t count, size_t minBatch, Func&& func) {
+        if (count < 1) { return; }
+        minBatch = std::max<size_t>(minBatch, 1);
+
+        size_t batches = std::min(getWorkerCount(), (count + minBatch - 1) / minBatch);
+        if (batches <= 1) {
+            func(size_t(0), count);
+            return;
+        }
+
+        size_t perBatch = (count + batches - 1) / batches;
+        std::vector<std::thread> threads{};
+        threads.reserve(batches - 1);
+        for (size_t i = 1, begin = perBatch; i < batches && begin < count; i++, begin += perBatch) {
+            size_t end = std::min(begin + perBatch, count);
+            threads.emplace_back([&func, begin, end]() { func(begin, end); });
+        }
+
+        func(size_t(0), perBatch);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /// <summary>
+    /// Calls func(index) for every index in [0, count). Workers pull indices from a shared counter
+    /// so items of uneven cost (e.g. sprites of different sizes) still balance across threads.
+    /// </summary>
+    template<typename Func>
+    void forEach(size_t count, Func&& func) {
+        if (count < 1) { return; }
+
+        size_t workers = std::min(getWorkerCount(), count);
+        if (workers <= 1) {
+            for (size_t i = 0; i < count; i++) {
+                func(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next{ 0 };
+        auto worker = [&func, &next, count]() {
+            for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed)) {
+                func(i);
+            }
+        };
+
+        std::vector<std::thread> threads{};
+        threads.reserve(workers - 1);
+        for (size_t i = 1; i < workers; i++) {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
@@ -1,14 +1,32 @@
 #pragma once
 #include <cstdint>
 #include <stdlib.h>
+#include <malloc.h>
+#include <new>
 #include <J-Core/Math/Math.h>
 
 namespace JCore {
+    template<typename T, uint32_t init>
+    class PoolAllocator;
+
+    /// <summary>
+    /// Fixed block of up to 64 slots. Chunks are allocated aligned to CHUNK_ALIGN, so the chunk owning
+    /// any slot is found by masking the slot's address, no searching needed.
+    /// </summary>
     template<typename T>
     struct PoolChunk {
     public:
-        static constexpr size_t CHUNK_SHIFT = 6;
-        static constexpr size_t CHUNK_SIZE = 1 << CHUNK_SHIFT;
+        static constexpr size_t HEADER_SIZE = ((sizeof(void*) * 4 + sizeof(uint64_t) + alignof(T) - 1) / alignof(T)) * alignof(T);
+
+        //Smallest power of two that fits at least 32 slots (or 64 if they fit), keeps the slack at the end of a chunk small
+        static constexpr size_t CHUNK_ALIGN = []() {
+            size_t align = 256;
+            while ((align - HEADER_SIZE) / sizeof(T) < 32) { align <<= 1; }
+            return align;
+        }();
+        static constexpr size_t CHUNK_SIZE = (CHUNK_ALIGN - HEADER_SIZE) / sizeof(T) < 64 ? (CHUNK_ALIGN - HEADER_SIZE) / sizeof(T) : 64;
+        static constexpr uint64_t FULL_MASK = CHUNK_SIZE >= 64 ? UINT64_MAX : (1ULL << CHUNK_SIZE) - 1;
+
         PoolChunk<T>* next{ nullptr };
 
         const uint64_t getUsageMask() const { return _inUse; }
@@ -16,15 +34,15 @@ namespace JCore {
         const T* getBuffer() const { return _buffer; }
 
         constexpr bool isEmpty() const { return _inUse == 0; }
-        constexpr bool isFull() const { return _inUse == UINT64_MAX; }
-        constexpr bool hasFreeSlots() const { return _inUse != UINT64_MAX; }
+        constexpr bool isFull() const { return _inUse == FULL_MASK; }
+        constexpr bool hasFreeSlots() const { return _inUse != FULL_MASK; }
 
-        size_t countFreeSlots() const { return Math::countBits(_inUse); }
+        size_t countFreeSlots() const { return CHUNK_SIZE - Math::countBits(_inUse); }
         void clear() { _inUse = 0; }
 
         T* allocateSlot() {
             if (isFull()) { return nullptr; }
-            const int32_t newInd = Math::findFirstLSB(~_inUse);
+            const int32_t newInd = Math::findFirstLSB(~_inUse & FULL_MASK);
 
             if (newInd < 0) { return nullptr; }
             _inUse |= (1ULL << newInd);
@@ -36,7 +54,19 @@ namespace JCore {
             return true;
         }
 
+        static PoolChunk<T>* fromPointer(const T* ptr) {
+            return reinterpret_cast<PoolChunk<T>*>(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t(CHUNK_ALIGN - 1));
+        }
+
     private:
+        template<typename U, uint32_t init>
+        friend class PoolAllocator;
+
+        //Intrusive list of chunks that still have free slots
+        PoolChunk<T>* _prevFree{ nullptr };
+        PoolChunk<T>* _nextFree{ nullptr };
+        const void* _owner{ nullptr };
+
         uint64_t _inUse{};
         T _buffer[CHUNK_SIZE]{};
     };
@@ -44,18 +74,9 @@ namespace JCore {
     template<typename T, uint32_t init = 0>
     class PoolAllocator {
     public:
-        PoolAllocator() : _chunk(nullptr), _chunkCount(0) {
-            PoolChunk<T>* prev = _chunk;
-            _chunkCount = init;
+        PoolAllocator() : _chunk(nullptr), _freeChunk(nullptr), _chunkCount(0) {
             for (size_t i = 0; i < init; i++) {
-                PoolChunk<T>* chunk = new PoolChunk<T>();
-                if (_chunk) {
-                    prev->next = chunk;
-                }
-                else {
-                    _chunk = chunk;
-                }
-                prev = chunk;
+                addChunk();
             }
         }
         ~PoolAllocator() {
@@ -68,94 +89,54 @@ namespace JCore {
         static PoolAllocator<T, init>& getGlobal() { return Global; }
 
         void reserve(int64_t count) {
-            PoolChunk<T>* prev = nullptr;
-            PoolChunk<T>* cChnk = _chunk;
-            while (cChnk) {
-                count -= cChnk->countFreeSlots();
-                prev = cChnk;
-                cChnk = cChnk->next;
+            for (PoolChunk<T>* chunk = _freeChunk; chunk && count > 0; chunk = chunk->_nextFree) {
+                count -= chunk->countFreeSlots();
             }
             if (count <= 0) { return; }
-            count = (count >> PoolChunk<T>::CHUNK_SHIFT) + 1;
 
+            count = (count + PoolChunk<T>::CHUNK_SIZE - 1) / PoolChunk<T>::CHUNK_SIZE;
             for (int64_t i = 0; i < count; i++) {
-                cChnk = new PoolChunk<T>();
-                _chunkCount++;
-                if (prev) {
-                    prev->next = cChnk;
-                }
-                else {
-                    _chunk = cChnk;
-                }
-                prev = cChnk;
+                addChunk();
             }
         }
 
         T* allocate() {
-            PoolChunk<T>* prev = nullptr;
-            PoolChunk<T>* cChnk = _chunk;
-            while (cChnk) {
-                if (cChnk->hasFreeSlots()) {
-                    break;
-                }
-                prev = cChnk;
-                cChnk = cChnk->next;
-            }
+            PoolChunk<T>* chunk = _freeChunk ? _freeChunk : addChunk();
+            if (!chunk) { return nullptr; }
 
-            if (!cChnk) {
-                cChnk = new PoolChunk<T>();
-                _chunkCount++;
-                if (prev) {
-                    prev->next = cChnk;
-                }
-                else {
-                    _chunk = cChnk;
-                }
+            T* ptrOut = chunk->allocateSlot();
+            if (chunk->isFull()) {
+                unlinkFree(chunk);
             }
-            return cChnk->allocateSlot();
+            return ptrOut;
         }
 
         template<class... Args>
         T* allocate(Args&&... args) {
-            PoolChunk<T>* prev = nullptr;
-            PoolChunk<T>* cChnk = _chunk;
-            while (cChnk) {
-                if (cChnk->hasFreeSlots()) {
-                    break;
-                }
-                prev = cChnk;
-                cChnk = cChnk->next;
-            }
-
-            if (!cChnk) {
-                cChnk = new PoolChunk<T>();
-                _chunkCount++;
-                if (prev) {
-                    prev->next = cChnk;
-                }
-                else {
-                    _chunk = cChnk;
-                }
-            }
-            T* ptrOut = cChnk->allocateSlot();
+            T* ptrOut = allocate();
             if (!ptrOut) { return nullptr; }
 
             *ptrOut = T(args...);
             return ptrOut;
         }
 
+        /// <summary>
+        /// 'obj' must be null or a pointer returned by this allocator, its chunk is found straight from the address.
+        /// </summary>
         bool deallocate(T* obj) {
-            if (obj) {
-                PoolChunk<T>* ptr = _chunk;
-                while (ptr) {
-                    if (ptr->tryDeallocate(obj)) {
-                        obj->~T();
-                        return true;
-                    }
-                    ptr = ptr->next;
-                }
+            if (!obj) { return false; }
+
+            PoolChunk<T>* chunk = PoolChunk<T>::fromPointer(obj);
+            if (chunk->_owner != this) { return false; }
+
+            const bool wasFull = chunk->isFull();
+            if (!chunk->tryDeallocate(obj)) { return false; }
+
+            obj->~T();
+            if (wasFull) {
+                linkFree(chunk);
             }
-            return false;
+            return true;
         }
 
         void trim() {
@@ -171,7 +152,8 @@ namespace JCore {
                     }
                     auto temp = ptr;
                     ptr = ptr->next;
-                    delete temp;
+                    unlinkFree(temp);
+                    freeChunk(temp);
                     _chunkCount--;
                     continue;
                 }
@@ -182,6 +164,7 @@ namespace JCore {
 
         void clear(bool full) {
             PoolChunk<T>* ptr = _chunk;
+            _freeChunk = nullptr;
             while (ptr) {
                 PoolChunk<T>* temp = ptr;
                 ptr = ptr->next;
@@ -197,7 +180,12 @@ namespace JCore {
                 }
 
                 if (full) {
-                    delete temp;
+                    freeChunk(temp);
+                }
+                else {
+                    temp->_prevFree = nullptr;
+                    temp->_nextFree = nullptr;
+                    linkFree(temp);
                 }
             }
 
@@ -209,9 +197,54 @@ namespace JCore {
 
     private:
         static PoolAllocator<T, init> Global;
-        size_t _chunkCount;
         PoolChunk<T>* _chunk;
-        
+        PoolChunk<T>* _freeChunk;
+        size_t _chunkCount;
+
+        PoolChunk<T>* addChunk() {
+            static_assert(sizeof(PoolChunk<T>) <= PoolChunk<T>::CHUNK_ALIGN, "PoolChunk doesn't fit in its alignment!");
+#ifdef _WIN32
+            void* mem = _aligned_malloc(PoolChunk<T>::CHUNK_ALIGN, PoolChunk<T>::CHUNK_ALIGN);
+#else
+            void* mem = nullptr;
+            if (posix_memalign(&mem, PoolChunk<T>::CHUNK_ALIGN, PoolChunk<T>::CHUNK_ALIGN) != 0) { mem = nullptr; }
+#endif
+            if (!mem) { return nullptr; }
+
+            PoolChunk<T>* chunk = new (mem) PoolChunk<T>();
+            chunk->_owner = this;
+            chunk->next = _chunk;
+            _chunk = chunk;
+            _chunkCount++;
+            linkFree(chunk);
+            return chunk;
+        }
+
+        static void freeChunk(PoolChunk<T>* chunk) {
+            chunk->~PoolChunk<T>();
+#ifdef _WIN32
+            _aligned_free(chunk);
+#else
+            free(chunk);
+#endif
+        }
+
+        void linkFree(PoolChunk<T>* chunk) {
+            chunk->_prevFree = nullptr;
+            chunk->_nextFree = _freeChunk;
+            if (_freeChunk) { _freeChunk->_prevFree = chunk; }
+            _freeChunk = chunk;
+        }
+
+        void unlinkFree(PoolChunk<T>* chunk) {
+            if (chunk->_prevFree) { chunk->_prevFree->_nextFree = chunk->_nextFree; }
+            else if (_freeChunk == chunk) { _freeChunk = chunk->_nextFree; }
+            else { return; }
+
+            if (chunk->_nextFree) { chunk->_nextFree->_prevFree = chunk->_prevFree; }
+            chunk->_prevFree = nullptr;
+            chunk->_nextFree = nullptr;
+        }
     };
 
     template<typename T, uint32_t init>
@@ -226,4 +259,4 @@ namespace JCore {
     void trimPoolAllocator() {
         PoolAllocator<T, init>::getGlobal().trim();
     }
-}
\ No newline at end of file
+}
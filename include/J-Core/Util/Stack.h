@@ -36,7 +36,7 @@ namespace JCore {
         void push(const T& value) {
             if (_tail >= _capacity) {
                 size_t newCap = std::max<size_t>(_capacity, 1);
-                while (newCap < _tail) {
+                while (newCap <= _tail) {
                     newCap <<= 1;
                 }
                 reserve(newCap);
@@ -55,6 +55,7 @@ namespace JCore {
 
         void reserve(size_t newCap) {
             if (_buffer) {
+                if (newCap <= _capacity) { return; }
                 void* reall = realloc(_buffer, newCap * sizeof(T));
 
                 if (reall) {
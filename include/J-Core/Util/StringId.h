@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <J-Core/Util/FlatMap.h>
+
+namespace JCore {
+    /// <summary>
+    /// 64-bit FNV-1a hash of a string, compared & hashed like an integer.
+    /// Ids can be made at compile time ("name"_sid or StringId("name")), those compare equal to interned ones
+    /// but only resolve back to text once the same string has been interned somewhere with StringId::intern.
+    /// The empty string is always id 0.
+    /// </summary>
+    class StringId {
+    public:
+        static constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+        static constexpr uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+        constexpr StringId() : _hash(0) {}
+        constexpr explicit StringId(std::string_view str) : _hash(hash(str)) {}
+
+        static constexpr uint64_t hash(std::string_view str) {
+            if (str.length() < 1) { return 0; }
+
+            uint64_t hash = FNV_OFFSET;
+            for (char ch : str) {
+                hash = (hash ^ uint8_t(ch)) * FNV_PRIME;
+            }
+            return hash ? hash : 1;
+        }
+
+        /// <summary>
+        /// Id of an already computed hash, for hashes stored in files or computed incrementally.
+        /// </summary>
+        static constexpr StringId fromHash(uint64_t hash) {
+            StringId id{};
+            id._hash = hash;
+            return id;
+        }
+
+        /// <summary>
+        /// Registers the text of 'str' in the global string table, thread safe.
+        /// Hash collisions between different strings are logged as errors.
+        /// </summary>
+        static StringId intern(std::string_view str);
+
+        /// <summary>
+        /// Number of strings in the global string table.
+        /// </summary>
+        static size_t getInternedCount();
+
+        constexpr uint64_t getHash() const { return _hash; }
+        constexpr bool isValid() const { return _hash != 0; }
+
+        /// <summary>
+        /// Text of an interned id or an empty view if it was never interned.
+        /// The view stays valid for the lifetime of the program & is null terminated.
+        /// </summary>
+        std::string_view toString() const;
+
+        constexpr bool operator==(StringId other) const { return _hash == other._hash; }
+        constexpr bool operator!=(StringId other) const { return _hash != other._hash; }
+        constexpr bool operator<(StringId other) const { return _hash < other._hash; }
+
+    private:
+        uint64_t _hash;
+    };
+
+    template<>
+    struct FlatHash<StringId> {
+        uint64_t operator()(StringId id) const { return detail::mixHash(id.getHash()); }
+    };
+
+    inline constexpr StringId operator""_sid(const char* str, size_t length) {
+        return StringId(std::string_view(str, length));
+    }
+}
+
+namespace std {
+    template<>
+    struct hash<JCore::StringId> {
+        size_t operator()(JCore::StringId id) const { return size_t(id.getHash()); }
+    };
+}
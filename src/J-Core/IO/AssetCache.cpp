@@ -0,0 +1,198 @@
+#include <J-Core/IO/AssetCache.h>
+#include <J-Core/IO/Audio.h>
+#include <J-Core/IO/IOUtils.h>
+#include <J-Core/Util/DataUtils.h>
+#include <vector>
+
+namespace JCore {
+    namespace {
+#pragma pack(push, 1)
+        struct KeyInfo {
+            uint8_t type;
+            uint8_t flags;
+        };
+#pragma pack(pop)
+
+        bool loadImage(std::string_view path, uint8_t flags, std::shared_ptr<const void>& asset, size_t& size) {
+            //ImageData doesn't free its buffer on its own
+            std::shared_ptr<ImageData> image(new ImageData(), [](ImageData* img) {
+                img->clear(true);
+                delete img;
+            });
+
+            ImageDecodeParams params{};
+            params.flags = flags;
+            DataFormat format = DataFormat::FMT_UNKNOWN;
+            if (!Image::tryDecode(path, *image, format, params)) { return false; }
+
+            size = image->getBufferSize();
+            asset = std::move(image);
+            return true;
+        }
+
+        bool loadAudio(std::string_view path, uint8_t flags, std::shared_ptr<const void>& asset, size_t& size) {
+            std::shared_ptr<AudioData> audio = std::make_shared<AudioData>();
+            if (!Wav::decode(path, *audio)) { return false; }
+
+            size = audio->getBufferSize();
+            asset = std::move(audio);
+            return true;
+        }
+    }
+
+    AssetCache::AssetCache(size_t maxBytes) : _mutex(), _maxBytes(maxBytes), _totalBytes(0), _loadCounter(0), _stats(), _entries(), _lru() {}
+
+    AssetCache::~AssetCache() {
+        clear();
+    }
+
+    AssetCache& AssetCache::getGlobal() {
+        static AssetCache cache{};
+        return cache;
+    }
+
+    std::shared_ptr<const ImageData> AssetCache::getImage(std::string_view path, const ImageDecodeParams& params) {
+        return std::static_pointer_cast<const ImageData>(getAsset(ASSET_Image, path, params.flags, loadImage));
+    }
+
+    std::shared_ptr<const AudioData> AssetCache::getAudio(std::string_view path) {
+        return std::static_pointer_cast<const AudioData>(getAsset(ASSET_Audio, path, 0, loadAudio));
+    }
+
+    StringId AssetCache::getPathId(std::string_view path) {
+        std::error_code err{};
+        const fs::path source = fs::absolute(fs::path(path), err).lexically_normal();
+        return err ? StringId() : StringId(source.generic_string());
+    }
+
+    void AssetCache::invalidate(std::string_view path) {
+        const StringId pathId = getPathId(path);
+        if (!pathId.isValid()) { return; }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<uint64_t> keys{};
+        for (const auto& entry : _entries) {
+            if (entry.second.pathId == pathId) {
+                keys.push_back(entry.first);
+            }
+        }
+
+        for (uint64_t key : keys) {
+            removeLocked(key, *_entries.tryGet(key));
+        }
+    }
+
+    void AssetCache::trim(size_t targetBytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        trimLocked(targetBytes);
+    }
+
+    void AssetCache::clear() {
+        //Loads still in flight finish normally, they just don't find their entry anymore & aren't cached
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+        _lru.clear();
+        _totalBytes = 0;
+    }
+
+    size_t AssetCache::getMaxBytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _maxBytes;
+    }
+
+    void AssetCache::setMaxBytes(size_t maxBytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxBytes = maxBytes;
+        trimLocked(_maxBytes);
+    }
+
+    AssetCache::Stats AssetCache::getStats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Stats stats = _stats;
+        stats.entryCount = _entries.size();
+        stats.bytes = _totalBytes;
+        stats.maxBytes = _maxBytes;
+        return stats;
+    }
+
+    void AssetCache::resetStats() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats = {};
+    }
+
+    AssetCache::AssetPtr AssetCache::getAsset(AssetType type, std::string_view path, uint8_t flags, Loader loader) {
+        const StringId pathId = getPathId(path);
+        if (!pathId.isValid()) { return nullptr; }
+
+        const KeyInfo info{ uint8_t(type), flags };
+        const uint64_t key = Data::hash64(&info, sizeof(info), pathId.getHash());
+
+        std::promise<AssetPtr> promise{};
+        uint64_t loadId = 0;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (CacheEntry* entry = _entries.tryGet(key)) {
+                _stats.hits++;
+                if (entry->loaded) {
+                    _lru.splice(_lru.begin(), _lru, entry->lruPos);
+                    return entry->result.get();
+                }
+
+                //Someone else is already decoding this, share their result instead of decoding it twice
+                _stats.sharedLoads++;
+                std::shared_future<AssetPtr> pending = entry->result;
+                lock.unlock();
+                return pending.get();
+            }
+
+            _stats.misses++;
+            CacheEntry& entry = _entries[key];
+            entry.result = promise.get_future().share();
+            entry.pathId = pathId;
+            entry.loadId = loadId = ++_loadCounter;
+        }
+
+        AssetPtr asset{};
+        size_t size = 0;
+        if (!loader(path, flags, asset, size)) {
+            asset.reset();
+        }
+        promise.set_value(asset);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        CacheEntry* entry = _entries.tryGet(key);
+        if (!entry || entry->loadId != loadId) { return asset; }
+
+        if (!asset) {
+            _stats.failures++;
+            _entries.erase(key);
+            return asset;
+        }
+
+        entry->loaded = true;
+        entry->size = size;
+        _lru.push_front(key);
+        entry->lruPos = _lru.begin();
+        _totalBytes += size;
+
+        //An asset bigger than the whole budget is evicted right away, the caller still gets its own reference
+        trimLocked(_maxBytes);
+        return asset;
+    }
+
+    void AssetCache::removeLocked(uint64_t key, CacheEntry& entry) {
+        if (entry.loaded) {
+            _lru.erase(entry.lruPos);
+            _totalBytes -= entry.size;
+        }
+        _entries.erase(key);
+    }
+
+    void AssetCache::trimLocked(size_t targetBytes) {
+        while (_totalBytes > targetBytes && !_lru.empty()) {
+            const uint64_t key = _lru.back();
+            removeLocked(key, *_entries.tryGet(key));
+            _stats.evictions++;
+        }
+    }
+}
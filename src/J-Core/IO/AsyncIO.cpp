@@ -0,0 +1,543 @@
+#include <J-Core/IO/AsyncIO.h>
+#include <J-Core/Util/BufferPool.h>
+#include <J-Core/Util/Parallel.h>
+#include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace JCore {
+    static constexpr size_t FALLBACK_IO_THREADS = 16;
+    //Single reads are split so the length always fits in 32 bits
+    static constexpr size_t MAX_READ_CHUNK = size_t(1) << 30;
+
+    AsyncReadResult::AsyncReadResult(AsyncReadResult&& other) noexcept :
+        _path(std::move(other._path)), _offset(other._offset), _data(other._data), _size(other._size), _capacity(other._capacity), _ok(other._ok) {
+        other._data = nullptr;
+        other._size = 0;
+        other._capacity = 0;
+        other._ok = false;
+    }
+
+    AsyncReadResult& AsyncReadResult::operator=(AsyncReadResult&& other) noexcept {
+        if (this != &other) {
+            release();
+            _path = std::move(other._path);
+            _offset = other._offset;
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+            _ok = other._ok;
+
+            other._data = nullptr;
+            other._size = 0;
+            other._capacity = 0;
+            other._ok = false;
+        }
+        return *this;
+    }
+
+    void AsyncReadResult::release() {
+        if (_data) {
+            BufferPool::getGlobal().deallocate(_data, _capacity);
+        }
+        _data = nullptr;
+        _size = 0;
+        _capacity = 0;
+        _ok = false;
+    }
+
+    bool AsyncReadResult::allocate(size_t size) {
+        release();
+        _data = BufferPool::getGlobal().allocate(Math::max<size_t>(size, 1), _capacity);
+        if (!_data) {
+            JCORE_ERROR("[J-Core - AsyncIO] Error: Failed to allocate read buffer for '{0}'! ({1} bytes)", _path, size);
+            return false;
+        }
+        _size = size;
+        return true;
+    }
+
+#ifdef __linux__
+    //Minimal io_uring setup over the raw syscalls, only what plain reads need
+    struct AsyncIO::Ring {
+        int32_t fd{ -1 };
+        int32_t wakeFd{ -1 };
+        uint64_t wakeValue{ 0 };
+        uint32_t entries{ 0 };
+        uint32_t toSubmit{ 0 };
+
+        void* sqPtr{ nullptr };
+        size_t sqSize{ 0 };
+        void* cqPtr{ nullptr };
+        size_t cqSize{ 0 };
+        io_uring_sqe* sqes{ nullptr };
+        size_t sqesSize{ 0 };
+
+        uint32_t* sqHead{ nullptr };
+        uint32_t* sqTail{ nullptr };
+        uint32_t* sqMask{ nullptr };
+        uint32_t* sqArray{ nullptr };
+        uint32_t* cqHead{ nullptr };
+        uint32_t* cqTail{ nullptr };
+        uint32_t* cqMask{ nullptr };
+        io_uring_cqe* cqes{ nullptr };
+
+        ~Ring() {
+            if (sqes) { munmap(sqes, sqesSize); }
+            if (cqPtr && cqPtr != sqPtr) { munmap(cqPtr, cqSize); }
+            if (sqPtr) { munmap(sqPtr, sqSize); }
+            if (fd >= 0) { ::close(fd); }
+            if (wakeFd >= 0) { ::close(wakeFd); }
+        }
+
+        bool init(uint32_t depth) {
+            io_uring_params params{};
+            fd = int32_t(syscall(__NR_io_uring_setup, depth, &params));
+            if (fd < 0) { return false; }
+
+            //IORING_OP_READ came in the same kernel as this feature bit
+            if (!(params.features & IORING_FEAT_RW_CUR_POS)) { return false; }
+
+            entries = params.sq_entries;
+            sqSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+            cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap) {
+                sqSize = cqSize = Math::max(sqSize, cqSize);
+            }
+
+            sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sqPtr == MAP_FAILED) { sqPtr = nullptr; return false; }
+
+            cqPtr = singleMap ? sqPtr : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cqPtr == MAP_FAILED) { cqPtr = nullptr; return false; }
+
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sqesPtr == MAP_FAILED) { return false; }
+            sqes = reinterpret_cast<io_uring_sqe*>(sqesPtr);
+
+            uint8_t* sq = reinterpret_cast<uint8_t*>(sqPtr);
+            sqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+            sqMask = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+            uint8_t* cq = reinterpret_cast<uint8_t*>(cqPtr);
+            cqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+            cqMask = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            wakeFd = eventfd(0, EFD_CLOEXEC);
+            return wakeFd >= 0;
+        }
+
+        //Returns nullptr if every slot is waiting to be submitted
+        io_uring_sqe* prepare(uint8_t opcode, int32_t file, void* buffer, uint32_t length, uint64_t offset, uint64_t userData) {
+            const uint32_t tail = *sqTail;
+            if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= entries) { return nullptr; }
+
+            const uint32_t index = tail & *sqMask;
+            io_uring_sqe* sqe = sqes + index;
+            memset(sqe, 0, sizeof(io_uring_sqe));
+            sqe->opcode = opcode;
+            sqe->fd = file;
+            sqe->addr = uint64_t(uintptr_t(buffer));
+            sqe->len = length;
+            sqe->off = offset;
+            sqe->user_data = userData;
+
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            toSubmit++;
+            return sqe;
+        }
+
+        int32_t enter(uint32_t waitFor) {
+            const int32_t ret = int32_t(syscall(__NR_io_uring_enter, fd, toSubmit, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+            if (ret >= 0) {
+                toSubmit -= Math::min<uint32_t>(uint32_t(ret), toSubmit);
+            }
+            return ret;
+        }
+
+        void wake() {
+            const uint64_t one = 1;
+            ssize_t ret = ::write(wakeFd, &one, sizeof(one));
+            (void)ret;
+        }
+    };
+#else
+    struct AsyncIO::Ring {};
+#endif
+
+    AsyncIO::AsyncIO(size_t workers, uint32_t queueDepth) :
+        _workers(), _io(), _ring(nullptr), _ringThread(), _ringMutex(), _ringPending(), _stopping(false),
+        _outstanding(0), _idleMutex(), _idleCv() {
+        startPool(_workers, workers ? workers : Parallel::getWorkerCount());
+
+        queueDepth = Math::max<uint32_t>(queueDepth, 2);
+        if (initRing(queueDepth)) {
+            _ringThread = std::thread([this]() { runRing(); });
+            return;
+        }
+        startPool(_io, Math::min<size_t>(queueDepth, FALLBACK_IO_THREADS));
+    }
+
+    AsyncIO::~AsyncIO() {
+        waitIdle();
+
+        _stopping.store(true, std::memory_order_release);
+#ifdef __linux__
+        if (_ring) {
+            _ring->wake();
+            _ringThread.join();
+            delete _ring;
+            _ring = nullptr;
+        }
+#endif
+        stopPool(_io);
+        stopPool(_workers);
+    }
+
+    AsyncIO& AsyncIO::getGlobal() {
+        static AsyncIO io{};
+        return io;
+    }
+
+    void AsyncIO::readAsync(std::string_view path, size_t offset, size_t size, AsyncReadCB onComplete) {
+        AsyncReadRequest request{ std::string(path), offset, size, std::move(onComplete) };
+        readBatch(&request, 1);
+    }
+
+    std::future<AsyncReadResult> AsyncIO::readAsync(std::string_view path, size_t offset, size_t size) {
+        auto promise = std::make_shared<std::promise<AsyncReadResult>>();
+        std::future<AsyncReadResult> future = promise->get_future();
+        readAsync(path, offset, size, [promise](AsyncReadResult& result) {
+            promise->set_value(std::move(result));
+        });
+        return future;
+    }
+
+    void AsyncIO::readAsync(const Stream& stream, size_t offset, size_t size, AsyncReadCB onComplete) {
+        _outstanding.fetch_add(1, std::memory_order_acq_rel);
+        push(_workers, [this, &stream, offset, size, onComplete = std::move(onComplete)]() {
+            Op op{};
+            op.request.offset = offset;
+            op.request.size = size;
+            if (stream.canRead() && prepareRange(op, stream.size())) {
+                stream.seek(offset, SEEK_SET);
+                op.result._size = stream.read(op.result._data, 1, op.result._size, false);
+                op.result._ok = true;
+            }
+
+            if (onComplete) {
+                onComplete(op.result);
+            }
+            finishOne();
+        });
+    }
+
+    void AsyncIO::readBatch(AsyncReadRequest* requests, size_t count) {
+        if (count < 1) { return; }
+        _outstanding.fetch_add(count, std::memory_order_acq_rel);
+
+        if (_ring) {
+            {
+                std::lock_guard<std::mutex> lock(_ringMutex);
+                for (size_t i = 0; i < count; i++) {
+                    Op* op = new Op();
+                    op->request = std::move(requests[i]);
+                    _ringPending.push_back(op);
+                }
+            }
+#ifdef __linux__
+            _ring->wake();
+#endif
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_io.mutex);
+        for (size_t i = 0; i < count; i++) {
+            Op* op = new Op();
+            op->request = std::move(requests[i]);
+            _io.jobs.emplace_back([this, op]() {
+                readDirect(*op);
+                complete(op);
+            });
+        }
+        _io.cv.notify_all();
+    }
+
+    void AsyncIO::waitIdle() {
+        std::unique_lock<std::mutex> lock(_idleMutex);
+        _idleCv.wait(lock, [this]() { return _outstanding.load(std::memory_order_acquire) == 0; });
+    }
+
+    void AsyncIO::complete(Op* op) {
+#ifndef _WIN32
+        if (op->file >= 0) {
+            ::close(op->file);
+            op->file = -1;
+        }
+#endif
+        push(_workers, [this, op]() {
+            if (op->request.onComplete) {
+                op->request.onComplete(op->result);
+            }
+            delete op;
+            finishOne();
+        });
+    }
+
+    void AsyncIO::finishOne() {
+        if (_outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(_idleMutex);
+            _idleCv.notify_all();
+        }
+    }
+
+    void AsyncIO::startPool(Pool& pool, size_t threads) {
+        pool.stop = false;
+        pool.threads.reserve(threads);
+        for (size_t i = 0; i < threads; i++) {
+            pool.threads.emplace_back([&pool]() {
+                while (true) {
+                    std::function<void()> job{};
+                    {
+                        std::unique_lock<std::mutex> lock(pool.mutex);
+                        pool.cv.wait(lock, [&pool]() { return pool.stop || !pool.jobs.empty(); });
+                        if (pool.jobs.empty()) { return; }
+
+                        job = std::move(pool.jobs.front());
+                        pool.jobs.pop_front();
+                    }
+                    job();
+                }
+            });
+        }
+    }
+
+    void AsyncIO::stopPool(Pool& pool) {
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            pool.stop = true;
+        }
+        pool.cv.notify_all();
+
+        for (auto& thread : pool.threads) {
+            thread.join();
+        }
+        pool.threads.clear();
+    }
+
+    void AsyncIO::push(Pool& pool, std::function<void()>&& job) {
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            pool.jobs.emplace_back(std::move(job));
+        }
+        pool.cv.notify_one();
+    }
+
+    bool AsyncIO::prepareRange(Op& op, size_t fileSize) {
+        AsyncReadResult& result = op.result;
+        result._path = op.request.path;
+        result._offset = op.request.offset;
+
+        if (result._offset > fileSize) {
+            JCORE_ERROR("[J-Core - AsyncIO] Error: Read offset {0} is past the end of '{1}' ({2} bytes)!", result._offset, result._path, fileSize);
+            return false;
+        }
+        return result.allocate(Math::min(op.request.size, fileSize - result._offset));
+    }
+
+    bool AsyncIO::readDirect(Op& op) {
+        const std::string& path = op.request.path;
+
+#ifdef _WIN32
+        int32_t len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, NULL, 0);
+        std::wstring widePath(size_t(len > 0 ? len : 1), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath.data(), len);
+
+        HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            JCORE_ERROR("[J-Core - AsyncIO] Error: Failed to open '{0}' ({1})!", path, GetLastError());
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize) || !prepareRange(op, size_t(fileSize.QuadPart))) {
+            CloseHandle(file);
+            return false;
+        }
+
+        AsyncReadResult& result = op.result;
+        while (op.done < result._size) {
+            const uint64_t position = result._offset + op.done;
+            OVERLAPPED overlapped{};
+            overlapped.Offset = DWORD(position & 0xFFFFFFFFULL);
+            overlapped.OffsetHigh = DWORD(position >> 32);
+
+            DWORD bRead = 0;
+            if (!ReadFile(file, result._data + op.done, DWORD(Math::min(result._size - op.done, MAX_READ_CHUNK)), &bRead, &overlapped) || bRead == 0) { break; }
+            op.done += bRead;
+        }
+        CloseHandle(file);
+#else
+        op.file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (op.file < 0) {
+            JCORE_ERROR("[J-Core - AsyncIO] Error: Failed to open '{0}' ({1})!", path, errno);
+            return false;
+        }
+
+        struct stat info {};
+        if (fstat(op.file, &info) != 0 || !prepareRange(op, size_t(info.st_size))) {
+            return false;
+        }
+
+        AsyncReadResult& result = op.result;
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(op.file, off_t(result._offset), off_t(result._size), POSIX_FADV_SEQUENTIAL);
+#endif
+        while (op.done < result._size) {
+            const ssize_t bRead = pread(op.file, result._data + op.done, Math::min(result._size - op.done, MAX_READ_CHUNK), off_t(result._offset + op.done));
+            if (bRead < 0 && errno == EINTR) { continue; }
+            if (bRead <= 0) { break; }
+            op.done += size_t(bRead);
+        }
+#endif
+        //The file may have shrunk since its size was checked
+        result._size = op.done;
+        result._ok = true;
+        return true;
+    }
+
+#ifdef __linux__
+    bool AsyncIO::initRing(uint32_t queueDepth) {
+        Ring* ring = new Ring();
+        if (!ring->init(queueDepth)) {
+            delete ring;
+            return false;
+        }
+        _ring = ring;
+        return true;
+    }
+
+    void AsyncIO::runRing() {
+        Ring& ring = *_ring;
+        std::deque<Op*> waiting{};
+        size_t inFlight = 0;
+        bool wakeArmed = false;
+
+        auto submitRead = [&ring](Op* op) {
+            AsyncReadResult& result = op->result;
+            const size_t length = Math::min(result._size - op->done, MAX_READ_CHUNK);
+            return ring.prepare(IORING_OP_READ, op->file, result._data + op->done, uint32_t(length), result._offset + op->done, uint64_t(uintptr_t(op))) != nullptr;
+        };
+
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(_ringMutex);
+                while (!_ringPending.empty()) {
+                    waiting.push_back(_ringPending.front());
+                    _ringPending.pop_front();
+                }
+            }
+
+            //A read on the eventfd that completes whenever new requests come in or we're shutting down
+            if (!wakeArmed && ring.prepare(IORING_OP_READ, ring.wakeFd, &ring.wakeValue, sizeof(ring.wakeValue), 0, 0)) {
+                wakeArmed = true;
+            }
+
+            //Files are opened as slots free up so the number of open handles stays bounded by the queue depth
+            while (!waiting.empty() && inFlight + 1 < ring.entries) {
+                Op* op = waiting.front();
+                waiting.pop_front();
+
+                op->file = ::open(op->request.path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (op->file < 0) {
+                    JCORE_ERROR("[J-Core - AsyncIO] Error: Failed to open '{0}' ({1})!", op->request.path, errno);
+                    complete(op);
+                    continue;
+                }
+
+                struct stat info {};
+                if (fstat(op->file, &info) != 0 || !prepareRange(*op, size_t(info.st_size))) {
+                    complete(op);
+                    continue;
+                }
+
+                if (op->result._size < 1) {
+                    op->result._ok = true;
+                    complete(op);
+                    continue;
+                }
+
+                if (!submitRead(op)) {
+                    waiting.push_front(op);
+                    break;
+                }
+                inFlight++;
+            }
+
+            if (_stopping.load(std::memory_order_acquire) && inFlight == 0 && waiting.empty()) { break; }
+
+            const int32_t ret = ring.enter(1);
+            if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                JCORE_ERROR("[J-Core - AsyncIO] Error: io_uring_enter failed ({0})!", errno);
+            }
+
+            uint32_t head = *ring.cqHead;
+            const uint32_t tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++) {
+                const io_uring_cqe& cqe = ring.cqes[head & *ring.cqMask];
+                if (cqe.user_data == 0) {
+                    wakeArmed = false;
+                    continue;
+                }
+
+                Op* op = reinterpret_cast<Op*>(uintptr_t(cqe.user_data));
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                    if (submitRead(op)) { continue; }
+                }
+                else if (cqe.res > 0) {
+                    op->done += size_t(cqe.res);
+                    if (op->done < op->result._size && submitRead(op)) { continue; }
+                }
+
+                if (cqe.res < 0) {
+                    JCORE_ERROR("[J-Core - AsyncIO] Error: Failed to read '{0}' ({1})!", op->request.path, -cqe.res);
+                    op->result.release();
+                }
+                else {
+                    //Hitting EOF early means the file shrunk, hand out what was read
+                    op->result._size = op->done;
+                    op->result._ok = true;
+                }
+                inFlight--;
+                complete(op);
+            }
+            __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+        }
+    }
+#else
+    bool AsyncIO::initRing(uint32_t queueDepth) { return false; }
+    void AsyncIO::runRing() {}
+#endif
+}
@@ -1,5 +1,7 @@
 #include <J-Core/IO/Audio.h>
 #include <J-Core/IO/FileStream.h>
+#include <J-Core/IO/MappedFileStream.h>
+#include <J-Core/IO/BufferedStream.h>
 #include <J-Core/Log.h>
 
 namespace JCore {
@@ -25,7 +27,8 @@ namespace JCore {
         bool getInfo(std::string_view path, AudioData& audio) {
             FileStream fs(path, "rb");
             if (fs.isOpen()) {
-                return getInfo(fs, audio);
+                BufferedStream buffered(fs, BufferedStream::HEADER_BUFFER_SIZE);
+                return getInfo(buffered, audio);
             }
             JCORE_ERROR("[Audio-IO] (WAV) Decode Error: Failed to open file '{0}' for reading!", path);
             return false;
@@ -91,7 +94,7 @@ namespace JCore {
         }
 
         bool decode(std::string_view path, AudioData& audio) {
-            FileStream fs(path, "rb");
+            MappedFileStream fs(path);
             if (fs.isOpen()) {
                 return decode(fs, audio);
             }
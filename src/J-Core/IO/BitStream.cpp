@@ -1,74 +1,287 @@
 #include <J-Core/IO/BitStream.h>
 #include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
 using namespace JCore;
 
-//TODO: Finish writing this bitstream class.
+BitStream::BitStream() : Stream(READ_FLAG | WRITE_FLAG), _stream(nullptr), _order(BitOrder::MSBFirst), _writing(false), _exhausted(false),
+    _bits(0), _bitCount(0), _bufferStart(0), _bufferPos(0), _bufferLength(0) {}
 
-//bool BitStream::isOpen() const
-//{
-//    return false;
-//}
+BitStream::BitStream(const Stream& stream, const BitOrder order) : BitStream() {
+    _order = order;
+    setStream(&stream);
+}
+
+BitStream::~BitStream() {
+    sync();
+}
+
+void BitStream::setStream(const Stream* stream) const {
+    sync();
+    _stream = stream;
+    _writing = false;
+    reset(_stream ? _stream->tell() : 0);
+}
+
+void BitStream::setBitOrder(const BitOrder order) const {
+    if (_order == order) { return; }
+
+    //The register's layout depends on the order, continue from the next byte boundary
+    sync();
+    _order = order;
+    reset(_stream ? _stream->tell() : 0);
+}
+
+size_t BitStream::size() const {
+    if (!_stream) { return 0; }
+    return _writing ? Math::max<size_t>(_stream->size(), size_t((tellBits() + 7) >> 3)) : _stream->size();
+}
+
+size_t BitStream::readBits(void* buffer, size_t bits) const {
+    if (!canRead()) { return 0; }
+    if (_writing) { beginRead(); }
+
+    uint8_t* output = reinterpret_cast<uint8_t*>(buffer);
+    const size_t bytes = bits >> 3;
+    if ((tellBits() & 0x7) == 0) {
+        const size_t bRead = read(output, 1, bytes, false);
+        if (bRead < bytes) { return bRead << 3; }
+    }
+    else {
+        for (size_t i = 0; i < bytes; i++) {
+            output[i] = uint8_t(getBits(8));
+        }
+    }
+
+    if (bits & 0x7) {
+        output[bytes] = uint8_t(getBits(uint32_t(bits & 0x7)));
+    }
+    return bits;
+}
+
+size_t BitStream::writeBits(const void* buffer, const size_t bits) const {
+    if (!canWrite()) { return 0; }
+    if (!_writing) { beginWrite(); }
+
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(buffer);
+    const size_t bytes = bits >> 3;
+    if ((_bitCount & 0x7) == 0) {
+        const size_t written = write(input, 1, bytes, false);
+        if (written < bytes) { return written << 3; }
+    }
+    else {
+        for (size_t i = 0; i < bytes; i++) {
+            putBits(input[i], 8);
+        }
+    }
+
+    if (bits & 0x7) {
+        putBits(input[bytes], uint32_t(bits & 0x7));
+    }
+    return bits;
+}
 
 void BitStream::byteAlign() const {
-    if (_stream && (_bitPos & 0x7) != 0) {
-        uint64_t next = Math::nextDivByPowOf2<uint64_t, 8>(_bitPos);
-        //_bitPos = 
+    if (_writing) {
+        const uint32_t padding = (8 - (_bitCount & 0x7)) & 0x7;
+        putBits(0, padding);
+        return;
     }
+
+    //Bits are always loaded in whole bytes, so whatever doesn't make up a full byte belongs to the current one
+    consumeBits(_bitCount & 0x7);
 }
 
 size_t BitStream::read(void* buffer, size_t elementSize, size_t count, const bool bigEndian) const {
-    if (!_stream || !_stream->canRead()) { return 0; }
-
+    if (!canRead()) { return 0; }
+    if (_writing) { beginRead(); }
     byteAlign();
-    size_t len = _stream->read(buffer, elementSize, count);
-    _position = _stream->tell();
-    return len;
+
+    uint8_t* output = reinterpret_cast<uint8_t*>(buffer);
+    const size_t position = tell();
+    const size_t length = size();
+    const size_t total = Math::min(elementSize * count, length > position ? length - position : 0);
+    if (total < 1) { return 0; }
+
+    size_t done = 0;
+    while (done < total && _bitCount >= 8) {
+        output[done++] = uint8_t(getBits(8));
+    }
+
+    if (done < total) {
+        //The register is empty, the rest can be copied in bulk
+        _bits = 0;
+        const size_t fromBuffer = _bufferPos < _bufferLength ? Math::min(total - done, _bufferLength - _bufferPos) : 0;
+        memcpy(output + done, _bitBuffer + _bufferPos, fromBuffer);
+        done += fromBuffer;
+        _bufferPos += fromBuffer;
+
+        if (done < total) {
+            done += _stream->read(output + done, 1, total - done, false);
+            reset(_stream->tell());
+        }
+    }
+
+    if (bigEndian && elementSize > 1) {
+        Data::reverseEndianess(output, elementSize, done / elementSize);
+    }
+    return done;
 }
 
 size_t BitStream::write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian) const {
-    if (!_stream || !_stream->canWrite()) { return 0; }
-    size_t ret = _stream->write(buffer, elementSize, count);
-    _position = _stream->tell();
-    return ret; 
+    if (!canWrite()) { return 0; }
+    if (!_writing) { beginWrite(); }
+    byteAlign();
+    flushBits();
+
+    const size_t size = elementSize * count;
+    if (size < 1) { return 0; }
+    if (_bufferPos + size <= BIT_BUFFER_SIZE) {
+        memcpy(_bitBuffer + _bufferPos, buffer, size);
+        if (bigEndian && elementSize > 1) {
+            Data::reverseEndianess(_bitBuffer + _bufferPos, elementSize, count);
+        }
+        _bufferPos += size;
+        return size;
+    }
+
+    flushBuffer();
+    const size_t written = _stream->write(buffer, elementSize, count, bigEndian);
+    _bufferStart = _stream->tell();
+    return written;
 }
 
 bool BitStream::flush() const {
-    return false;
+    if (!_stream) { return false; }
+
+    const bool writing = _writing;
+    sync();
+    return writing ? _stream->flush() : true;
 }
 
 bool BitStream::close() const {
-    return false;
+    if (!_stream) { return false; }
+
+    sync();
+    reset(0);
+    return _stream->close();
 }
 
 size_t BitStream::seek(int64_t offset, int origin) const {
-    switch (origin) {
-        case SEEK_CUR:
-            _bitPos += offset;
+    if (!_stream) { return 0; }
+
+    sync();
+    const size_t position = _stream->seek(offset, origin);
+    reset(position);
+    return position;
+}
+
+uint64_t BitStream::seekBits(const uint64_t bit) const {
+    if (!_stream) { return 0; }
 
-            size_t bufferPos = tell();
-            if (bufferPos < _position || bufferPos > _position + BIT_BUFFER_SIZE) {
-                _flags |= FLAG_NEED_READ;
-            }
+    sync();
+    const size_t byte = size_t(bit >> 3);
+    const size_t position = _stream->seek(byte, SEEK_SET);
+    reset(position);
 
-            break;
+    if (position == byte && (bit & 0x7)) {
+        refill();
+        consumeBits(uint32_t(bit & 0x7));
     }
+    return tellBits();
+}
+
+void BitStream::refillSlow() const {
+    if (_writing) { beginRead(); }
+    if (!_stream) { return; }
 
-    return _bitPos;
+    if (!_exhausted) {
+        //Keep the unread tail & top the buffer back up behind it
+        const size_t left = _bufferLength - _bufferPos;
+        memmove(_bitBuffer, _bitBuffer + _bufferPos, left);
+        _bufferStart += _bufferPos;
+        _bufferPos = 0;
+        _bufferLength = left;
+
+        const size_t want = BIT_BUFFER_SIZE - left;
+        const size_t bRead = _stream->canRead() ? _stream->read(_bitBuffer + left, 1, want, false) : 0;
+        _bufferLength += bRead;
+        _exhausted = bRead < want;
+        memset(_bitBuffer + _bufferLength, 0, 8);
+    }
+
+    //Past the end only zeros come in, the slack after the buffer is zeroed so the last few bytes can still be loaded as a whole word
+    uint64_t next = 0;
+    if (_bufferPos < _bufferLength) {
+        memcpy(&next, _bitBuffer + _bufferPos, 8);
+    }
+    _bits |= _order == BitOrder::MSBFirst ? byteSwap(next) >> _bitCount : next << _bitCount;
+    _bufferPos += (63 - _bitCount) >> 3;
+    _bitCount |= 56;
 }
 
-void BitStream::checkBitBuffer() const {
-    size_t curPos = (_bitPos >> 3);
-    if (curPos < _position || curPos > _position + BIT_BUFFER_SIZE) {
-        _position = curPos;
-        _flags |= FLAG_NEED_READ;
+void BitStream::flushBits() const {
+    if (_bufferPos + 8 > BIT_BUFFER_SIZE) {
+        flushBuffer();
     }
 
-    if (_stream) {
-        if (_flags & FLAG_NEED_READ) {
-            _stream->seek(_position, SEEK_SET);
-            _stream->read(_bitBuffer, BIT_BUFFER_SIZE, false);
+    //Always stores the whole register, only the complete bytes count
+    const uint32_t bytes = _bitCount >> 3;
+    const uint64_t out = _order == BitOrder::MSBFirst ? byteSwap(_bits) : _bits;
+    memcpy(_bitBuffer + _bufferPos, &out, 8);
+    _bufferPos += bytes;
+
+    //Shifted in two halves so all 8 bytes going out doesn't turn into a shift by 64
+    const uint32_t shift = bytes * 4;
+    _bits = _order == BitOrder::MSBFirst ? (_bits << shift) << shift : (_bits >> shift) >> shift;
+    _bitCount -= bytes * 8;
+}
 
-            _flags &= ~BIT_BUFFER_SIZE;
+void BitStream::flushBuffer() const {
+    if (_bufferPos > 0 && _stream) {
+        const size_t written = _stream->write(_bitBuffer, 1, _bufferPos, false);
+        if (written != _bufferPos) {
+            JCORE_ERROR("[J-Core - BitStream] Error: Failed to write bit buffer! ({0}/{1} bytes)", written, _bufferPos);
         }
     }
+    _bufferStart += _bufferPos;
+    _bufferPos = 0;
+}
+
+void BitStream::beginRead() const {
+    sync();
+}
+
+void BitStream::beginWrite() const {
+    sync();
+    _writing = true;
+    reset(_stream ? _stream->tell() : 0);
+}
+
+void BitStream::sync() const {
+    if (!_stream) { return; }
+
+    if (_writing) {
+        byteAlign();
+        flushBits();
+        flushBuffer();
+        _writing = false;
+        reset(_stream->tell());
+        return;
+    }
+
+    //Leave the wrapped stream at the first byte that hasn't been fully consumed
+    const size_t next = Math::min<size_t>(size_t((tellBits() + 7) >> 3), _stream->size());
+    if (_stream->tell() != next) {
+        _stream->seek(next, SEEK_SET);
+    }
+    reset(next);
+}
+
+void BitStream::reset(const size_t position) const {
+    _bits = 0;
+    _bitCount = 0;
+    _bufferStart = position;
+    _bufferPos = 0;
+    _bufferLength = 0;
+    _exhausted = false;
 }
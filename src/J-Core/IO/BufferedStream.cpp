@@ -0,0 +1,185 @@
+#include <J-Core/IO/BufferedStream.h>
+#include <J-Core/Util/BufferPool.h>
+#include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
+
+using namespace JCore;
+
+BufferedStream::BufferedStream(const Stream& stream, const size_t bufferSize) :
+    Stream(READ_FLAG | WRITE_FLAG, stream.size(), stream.capacity()), _stream(stream), _buffer(nullptr), _bufferSize(bufferSize < 64 ? 64 : bufferSize), _bufferCapacity(0),
+    _bufferStart(0), _bufferLength(0), _pendingWrite(0) {
+    _position = stream.tell();
+
+    _buffer = BufferPool::getGlobal().allocate(_bufferSize, _bufferCapacity);
+    if (!_buffer) {
+        JCORE_ERROR("[J-Core - BufferedStream] Error: Failed to allocate buffer! ({0} bytes)", _bufferSize);
+    }
+}
+
+BufferedStream::~BufferedStream() {
+    flushWrites();
+    if (_buffer) {
+        BufferPool::getGlobal().deallocate(_buffer, _bufferCapacity);
+    }
+}
+
+size_t BufferedStream::read(void* buffer, size_t elementSize, size_t count, const bool bigEndian) const {
+    if (!canRead() || !flushWrites()) { return 0; }
+
+    uint8_t* output = reinterpret_cast<uint8_t*>(buffer);
+    const size_t size = elementSize * count;
+    size_t done = 0;
+    while (done < size && _position < _length) {
+        if (_position >= _bufferStart && _position < _bufferStart + _bufferLength) {
+            const size_t offset = _position - _bufferStart;
+            const size_t toCopy = Math::min(size - done, _bufferLength - offset);
+            memcpy(output + done, _buffer + offset, toCopy);
+            done += toCopy;
+            _position += toCopy;
+            continue;
+        }
+
+        //Anything at least as big as the buffer would only get copied twice, read it directly
+        const size_t left = size - done;
+        if (left >= _bufferSize) {
+            seekStream(_position);
+            const size_t bRead = _stream.read(output + done, 1, left, false);
+            done += bRead;
+            _position += bRead;
+            break;
+        }
+
+        if (!fill(_position)) { break; }
+    }
+
+    if (bigEndian && elementSize > 1) {
+        Data::reverseEndianess(output, elementSize, done / elementSize);
+    }
+    return done;
+}
+
+size_t BufferedStream::write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian) const {
+    if (!canWrite()) { return 0; }
+
+    const size_t size = elementSize * count;
+    if (size < 1) { return 0; }
+
+    //Read data would go stale, drop it
+    _bufferLength = 0;
+
+    //Writes only coalesce if they continue where the last one ended
+    if (_pendingWrite > 0 && (_position != _bufferStart + _pendingWrite || _pendingWrite + size > _bufferSize)) {
+        if (!flushWrites()) { return 0; }
+    }
+
+    if (size >= _bufferSize) {
+        seekStream(_position);
+        const size_t written = _stream.write(buffer, elementSize, count, bigEndian);
+        _position += written;
+        _length = Math::max(_length, _stream.size());
+        return written;
+    }
+
+    if (_pendingWrite < 1) {
+        _bufferStart = _position;
+    }
+
+    uint8_t* target = _buffer + _pendingWrite;
+    memcpy(target, buffer, size);
+    if (bigEndian && elementSize > 1) {
+        Data::reverseEndianess(target, elementSize, count);
+    }
+
+    _pendingWrite += size;
+    _position += size;
+    _length = Math::max(_length, _position);
+    return size;
+}
+
+size_t BufferedStream::peek(void* buffer, const size_t size) const {
+    const size_t pos = _position;
+    const size_t bRead = read(buffer, 1, size, false);
+    _position = pos;
+    return bRead;
+}
+
+bool BufferedStream::flush() const {
+    return flushWrites() && _stream.flush();
+}
+
+bool BufferedStream::close() const {
+    flushWrites();
+    _bufferLength = 0;
+    _position = 0;
+    _length = 0;
+    return _stream.close();
+}
+
+size_t BufferedStream::seek(int64_t offset, int origin) const {
+    if (!isOpen()) { return _position; }
+
+    //Only moves the cursor, the wrapped stream is seeked once data is actually needed
+    switch (origin) {
+        case SEEK_SET: _position = offset < 0 ? 0 : size_t(offset); break;
+        case SEEK_CUR: _position = offset < 0 && size_t(-offset) > _position ? 0 : _position + offset; break;
+        case SEEK_END: _position = offset < 0 || size_t(offset) > _length ? (offset < 0 ? _length : 0) : _length - offset; break;
+    }
+    _position = _position > _length ? _length : _position;
+    return _position;
+}
+
+const uint8_t* BufferedStream::tryGetView(const size_t size) const {
+    if (!canRead() || size > _length - _position || !flushWrites()) { return nullptr; }
+
+    if (_position >= _bufferStart && _position + size <= _bufferStart + _bufferLength) {
+        const uint8_t* view = _buffer + (_position - _bufferStart);
+        _position += size;
+        return view;
+    }
+
+    //Streams that expose their memory don't need to go through the buffer at all
+    seekStream(_position);
+    if (const uint8_t* view = _stream.tryGetView(size)) {
+        _position += size;
+        return view;
+    }
+
+    if (size > _bufferSize || !fill(_position) || size > _bufferLength) { return nullptr; }
+    _position += size;
+    return _buffer;
+}
+
+bool BufferedStream::fill(const size_t position) const {
+    const bool sequential = _bufferLength > 0 && position == _bufferStart + _bufferLength;
+
+    seekStream(position);
+    _bufferStart = position;
+    _bufferLength = _stream.read(_buffer, 1, _bufferSize, false);
+
+    //Reading straight through, let the OS start on the next window while this one gets consumed
+    if (sequential && _bufferLength == _bufferSize) {
+        _stream.adviseReadAhead(position + _bufferLength, _bufferSize);
+    }
+    return _bufferLength > 0;
+}
+
+bool BufferedStream::flushWrites() const {
+    if (_pendingWrite < 1) { return true; }
+
+    seekStream(_bufferStart);
+    const size_t written = _stream.write(_buffer, 1, _pendingWrite, false);
+    const bool ok = written == _pendingWrite;
+    if (!ok) {
+        JCORE_ERROR("[J-Core - BufferedStream] Error: Failed to write buffered data! ({0}/{1} bytes)", written, _pendingWrite);
+    }
+
+    _pendingWrite = 0;
+    _length = Math::max(_length, _stream.size());
+    return ok;
+}
+
+void BufferedStream::seekStream(const size_t position) const {
+    if (_stream.tell() != position) {
+        _stream.seek(position, SEEK_SET);
+    }
+}
@@ -0,0 +1,118 @@
+#include <J-Core/IO/DeflateStream.h>
+#include <J-Core/IO/ZLib.h>
+#include <J-Core/Util/BufferPool.h>
+#include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
+
+using namespace JCore;
+
+DeflateStream::DeflateStream(const Stream& stream, const int32_t level, const size_t bufferSize) :
+    Stream(WRITE_FLAG), _stream(stream), _zStream(), _initialized(false), _compressed(0),
+    _buffer(nullptr), _bufferSize(bufferSize < 64 ? 64 : bufferSize), _bufferCapacity(0) {
+
+    _buffer = BufferPool::getGlobal().allocate(_bufferSize, _bufferCapacity);
+    if (!_buffer) {
+        JCORE_ERROR("[J-Core - DeflateStream] Error: Failed to allocate buffer! ({0} bytes)", _bufferSize);
+        return;
+    }
+
+    const int32_t ret = deflateInit(&_zStream, level);
+    if (ret != Z_OK) {
+        JCORE_ERROR("[J-Core - DeflateStream] Error: Failed to initialize deflate! ({0})", ZLib::zerr(ret));
+        return;
+    }
+
+    _zStream.next_out = _buffer;
+    _zStream.avail_out = uInt(_bufferSize);
+    _initialized = true;
+}
+
+DeflateStream::~DeflateStream() {
+    finish();
+    if (_buffer) {
+        BufferPool::getGlobal().deallocate(_buffer, _bufferCapacity);
+    }
+}
+
+size_t DeflateStream::write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian) const {
+    if (!canWrite()) { return 0; }
+
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(buffer);
+    const size_t size = elementSize * count;
+    if (!bigEndian || elementSize < 2) {
+        if (!deflateInput(input, size, Z_NO_FLUSH)) { return 0; }
+    }
+    else {
+        //The caller's data is const, swap through a small buffer instead
+        uint8_t temp[4096];
+        const size_t perBatch = Math::max<size_t>(sizeof(temp) / elementSize, 1);
+        for (size_t i = 0; i < count; i += perBatch) {
+            const size_t batch = Math::min(count - i, perBatch);
+            memcpy(temp, input + i * elementSize, batch * elementSize);
+            Data::reverseEndianess(temp, elementSize, batch);
+            if (!deflateInput(temp, batch * elementSize, Z_NO_FLUSH)) { return 0; }
+        }
+    }
+
+    _position += size;
+    _length = _position;
+    return size;
+}
+
+bool DeflateStream::flush() const {
+    if (!canWrite() || !deflateInput(nullptr, 0, Z_SYNC_FLUSH)) { return false; }
+    return _stream.flush();
+}
+
+bool DeflateStream::finish() const {
+    if (!_initialized) { return false; }
+
+    const bool ok = deflateInput(nullptr, 0, Z_FINISH);
+    deflateEnd(&_zStream);
+    _initialized = false;
+    return ok;
+}
+
+bool DeflateStream::close() const {
+    finish();
+    _position = 0;
+    _length = 0;
+    return _stream.close();
+}
+
+bool DeflateStream::deflateInput(const uint8_t* input, const size_t size, const int32_t flush) const {
+    size_t left = size;
+    do {
+        //avail_in is 32 bits, anything bigger goes in slices
+        const uInt slice = uInt(Math::min<size_t>(left, UINT32_MAX));
+        const int32_t mode = left > slice ? Z_NO_FLUSH : flush;
+        _zStream.next_in = const_cast<uint8_t*>(input + (size - left));
+        _zStream.avail_in = slice;
+        left -= slice;
+
+        while (true) {
+            const int32_t ret = deflate(&_zStream, mode);
+            if (ret == Z_STREAM_ERROR) {
+                JCORE_ERROR("[J-Core - DeflateStream] Error: Deflate failed! ({0})", ZLib::zerr(ret));
+                return false;
+            }
+
+            //Output is only written out once the buffer fills up or on flush/finish, small writes coalesce
+            const bool full = _zStream.avail_out == 0;
+            if (full || mode != Z_NO_FLUSH) {
+                const size_t pending = _bufferSize - _zStream.avail_out;
+                if (pending > 0 && _stream.write(_buffer, 1, pending, false) != pending) {
+                    JCORE_ERROR("[J-Core - DeflateStream] Error: Failed to write compressed data! ({0} bytes)", pending);
+                    return false;
+                }
+                _compressed += pending;
+                _zStream.next_out = _buffer;
+                _zStream.avail_out = uInt(_bufferSize);
+            }
+
+            if (full) { continue; }
+            if (_zStream.avail_in == 0 && (mode != Z_FINISH || ret == Z_STREAM_END)) { break; }
+        }
+    } while (left > 0);
+    return true;
+}
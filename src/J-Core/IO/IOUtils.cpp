@@ -3,7 +3,11 @@
 #include <commdlg.h>
 #include <shlobj_core.h>
 #include <J-Core/Util/StringUtils.h>
+#include <J-Core/Util/Parallel.h>
 #include <J-Core/Math/Math.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include <GLFW/glfw3.h>
 #define GLFW_EXPOSE_NATIVE_WIN32
@@ -30,6 +34,11 @@ namespace JCore::IO {
             if (ch == '\\') { return '/'; }
             return caseSensitive ? ch : wchar_t(towlower(ch));
         }
+
+        DWORD CALLBACK copyProgressRoutine(LARGE_INTEGER total, LARGE_INTEGER copied, LARGE_INTEGER, LARGE_INTEGER, DWORD, DWORD, HANDLE, HANDLE, LPVOID data) {
+            const CopyProgressCB& onProgress = *reinterpret_cast<const CopyProgressCB*>(data);
+            return onProgress(size_t(copied.QuadPart), size_t(total.QuadPart)) ? PROGRESS_CONTINUE : PROGRESS_CANCEL;
+        }
     }
 
 
@@ -184,6 +193,175 @@ namespace JCore::IO {
         return getAll(path, flags, [&paths](const fs::path& path) { paths.emplace_back(path); }, recursive, check);
     }
 
+    namespace {
+        struct WalkState {
+            const WalkParams& params;
+            //Null when everything goes straight into 'results'
+            const OnPathBatch* callback;
+            size_t batchSize;
+
+            std::mutex queueMutex{};
+            std::condition_variable queueCond{};
+            std::vector<fs::path> queue{};
+            //Directories queued or still being listed, the walk is done once nothing is left
+            size_t pending{ 0 };
+
+            std::mutex outputMutex{};
+            std::vector<fs::path>& results;
+            size_t found{ 0 };
+
+            WalkState(const WalkParams& params, const OnPathBatch* callback, std::vector<fs::path>& results) :
+                params(params), callback(callback), batchSize(Math::max<size_t>(params.batchSize, 1)), results(results) {}
+        };
+
+        bool matchesFile(const fs::path& path, const WalkParams& params) {
+            if (!params.filter && params.extensions.empty()) { return true; }
+
+            const std::string name = path.filename().string();
+            if (params.filter && !matchFilter(name, params.filter)) { return false; }
+            if (params.extensions.empty()) { return true; }
+
+            const std::string_view extension = getExtension(std::string_view(name));
+            for (const std::string& wanted : params.extensions) {
+                if (pathsMatch(extension, wanted)) { return true; }
+            }
+            return false;
+        }
+
+        void flushBatch(WalkState& state, std::vector<fs::path>& batch) {
+            if (batch.empty()) { return; }
+
+            std::lock_guard<std::mutex> lock(state.outputMutex);
+            state.found += batch.size();
+            if (state.params.sorted || !state.callback) {
+                state.results.insert(state.results.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+            }
+            else {
+                (*state.callback)(batch.data(), batch.size());
+            }
+            batch.clear();
+        }
+
+        void walkDirectories(WalkState& state) {
+            const WalkParams& params = state.params;
+            std::vector<fs::path> batch{};
+            std::vector<fs::path> subDirs{};
+            batch.reserve(state.batchSize);
+
+            while (true) {
+                fs::path directory{};
+                {
+                    std::unique_lock<std::mutex> lock(state.queueMutex);
+                    state.queueCond.wait(lock, [&state]() { return !state.queue.empty() || state.pending == 0; });
+                    if (state.queue.empty()) { break; }
+
+                    directory = std::move(state.queue.back());
+                    state.queue.pop_back();
+                }
+
+                std::error_code err{};
+                for (fs::directory_iterator it(directory, fs::directory_options::skip_permission_denied, err), end; !err && it != end; it.increment(err)) {
+                    const fs::directory_entry& entry = *it;
+
+                    //Types come with the listing itself on most file systems, only symlinks cost an extra stat here
+                    std::error_code typeErr{};
+                    if (entry.is_directory(typeErr)) {
+                        if (params.recursive && !entry.is_symlink(typeErr)) {
+                            subDirs.push_back(entry.path());
+                        }
+
+                        if ((params.flags & F_TYPE_FOLDER) && (!params.check || params.check(entry))) {
+                            batch.push_back(entry.path());
+                        }
+                    }
+                    else if ((params.flags & F_TYPE_FILE) && entry.is_regular_file(typeErr) && matchesFile(entry.path(), params) && (!params.check || params.check(entry))) {
+                        batch.push_back(entry.path());
+                    }
+
+                    if (batch.size() >= state.batchSize) {
+                        flushBatch(state, batch);
+                    }
+                }
+
+                if (err) {
+                    JCORE_WARN("[J-Core - IOUtils] Warning: Failed to list '{0}'! ({1})", directory.string(), err.message());
+                }
+
+                const size_t pushed = subDirs.size();
+                bool done = false;
+                {
+                    std::lock_guard<std::mutex> lock(state.queueMutex);
+                    state.queue.insert(state.queue.end(), std::make_move_iterator(subDirs.begin()), std::make_move_iterator(subDirs.end()));
+                    state.pending = state.pending + pushed - 1;
+                    done = state.pending == 0;
+                }
+                subDirs.clear();
+
+                if (done || pushed > 1) {
+                    state.queueCond.notify_all();
+                }
+                else if (pushed == 1) {
+                    state.queueCond.notify_one();
+                }
+            }
+            flushBatch(state, batch);
+        }
+
+        bool walkPaths(const fs::path& path, const WalkParams& params, const OnPathBatch* callback, std::vector<fs::path>& results) {
+            if ((params.flags & F_TYPE_ALL) == 0) {
+                JCORE_WARN("[J-Core - IOUtils] Warning: Walk flags are set to 0!");
+                return false;
+            }
+
+            std::error_code err{};
+            if (!fs::is_directory(path, err)) {
+                JCORE_WARN("[J-Core - IOUtils] Warning: '{0}' is not a directory!", path.string());
+                return false;
+            }
+
+            const size_t start = results.size();
+            WalkState state(params, callback, results);
+            state.queue.push_back(path);
+            state.pending = 1;
+
+            const size_t threads = params.recursive ? (params.threads > 0 ? params.threads : Parallel::getWorkerCount()) : 1;
+            std::vector<std::thread> workers{};
+            workers.reserve(threads - 1);
+            for (size_t i = 1; i < threads; i++) {
+                workers.emplace_back(walkDirectories, std::ref(state));
+            }
+
+            walkDirectories(state);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            if (params.sorted) {
+                std::sort(results.begin() + start, results.end());
+                for (size_t i = start; callback && i < results.size(); i += state.batchSize) {
+                    (*callback)(results.data() + i, Math::min(state.batchSize, results.size() - i));
+                }
+            }
+            return state.found > 0;
+        }
+    }
+
+    bool walk(const fs::path& path, const WalkParams& params, const OnPathBatch& callback) {
+        if (!callback) {
+            JCORE_WARN("[J-Core - IOUtils] Warning: Walk callback is null!");
+            return false;
+        }
+
+        //Only used to gather everything for sorting
+        std::vector<fs::path> results{};
+        return walkPaths(path, params, &callback, results);
+    }
+
+    bool walk(const fs::path& path, const WalkParams& params, std::vector<fs::path>& paths) {
+        //Batches are moved straight into 'paths' instead of going through a callback
+        return walkPaths(path, params, nullptr, paths);
+    }
+
     struct Entry {
         size_t index{ 0 };
         int32_t value{ 0 };
@@ -232,19 +410,24 @@ namespace JCore::IO {
         _freea(entries);
     }
 
-    void moveFile(std::string_view src, std::string_view dst, bool overwrite) {
-        if (IO::exists(src) && fs::is_regular_file(src)) {
-            if (IO::exists(dst)) {
-                if (overwrite) {
-                    auto copyOption{ std::filesystem::copy_options::update_existing };
-                    std::filesystem::copy_file(src, dst, copyOption);
-                    std::filesystem::remove(src);
-                }
-            }
-            else {
-                fs::rename(src, dst);
+    bool moveFile(std::string_view src, std::string_view dst, bool overwrite, const CopyProgressCB& onProgress) {
+        std::error_code err{};
+        if (!fs::is_regular_file(src, err)) { return false; }
+        if (!overwrite && fs::exists(dst, err)) { return false; }
+
+        fs::rename(src, dst, err);
+        if (!err) {
+            if (onProgress) {
+                const size_t size = size_t(fs::file_size(dst, err));
+                onProgress(size, size);
             }
+            return true;
         }
+
+        //Renames can't cross volumes, copy & only drop the source if the copy went through
+        if (!copyTo(fs::path(src), fs::path(dst), onProgress)) { return false; }
+        fs::remove(src, err);
+        return true;
     }
 
     std::string_view getName(std::string_view path, bool noExtension) {
@@ -366,12 +549,18 @@ namespace JCore::IO {
         fs::create_directories(fs::path(path));
     }
 
-    bool copyTo(const char* src, const char* dest) {
-        return fs::copy_file(fs::path(src), fs::path(dest), fs::copy_options::overwrite_existing);
+    bool copyTo(const char* src, const char* dest, const CopyProgressCB& onProgress) {
+        return copyTo(fs::path(src), fs::path(dest), onProgress);
     }
 
-    bool copyTo(const fs::path& src, const fs::path& dest) {
-        return fs::copy_file(src, dest, fs::copy_options::overwrite_existing);
+    bool copyTo(const fs::path& src, const fs::path& dest, const CopyProgressCB& onProgress) {
+        if (!onProgress) {
+            std::error_code err{};
+            return fs::copy_file(src, dest, fs::copy_options::overwrite_existing, err);
+        }
+
+        //CopyFileEx keeps the copy in the kernel & reports progress per chunk on its own
+        return CopyFileExW(src.c_str(), dest.c_str(), copyProgressRoutine, const_cast<CopyProgressCB*>(&onProgress), nullptr, 0) != FALSE;
     }
 
     void fixPath(char* path) {
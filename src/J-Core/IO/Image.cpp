@@ -1,4 +1,5 @@
 #include <J-Core/IO/Image.h>
+#include <J-Core/IO/ImageCache.h>
 #include <iostream>
 #include <J-Core/Log.h>
 #include <J-Core/Math/Color24.h>
@@ -8,6 +9,10 @@
 #include <J-Core/Util/DataUtils.h>
 #include <J-Core/Util/Span.h>
 #include <J-Core/IO/FileStream.h>
+#include <J-Core/IO/MappedFileStream.h>
+#include <J-Core/IO/BufferedStream.h>
+#include <J-Core/IO/DeflateStream.h>
+#include <J-Core/IO/InflateStream.h>
 #include <J-Core/IO/ZLib.h>
 #include <J-Core/IO/MemoryStream.h>
 #include <J-Core/Rendering/Texture.h>
@@ -69,7 +74,8 @@ namespace JCore {
             FileStream stream(path, "rb");
 
             if (stream.isOpen()) {
-                return getInfo(stream, imgData);
+                BufferedStream buffered(stream, BufferedStream::HEADER_BUFFER_SIZE);
+                return getInfo(buffered, imgData);
             }
 
             JCORE_ERROR("[Image-IO] (BMP) Error: Failed to open '{0}'!", path);
@@ -142,7 +148,8 @@ namespace JCore {
             FileStream stream(path, "rb");
 
             if (stream.isOpen()) {
-                return decode(stream, imgData, params);
+                BufferedStream buffered(stream);
+                return decode(buffered, imgData, params);
             }
 
             JCORE_ERROR("[Image-IO] (BMP) Error: Failed to open '{0}'!", path);
@@ -210,7 +217,8 @@ namespace JCore {
             const uint32_t pixelDataSize = rawScanSize * header.height;
             const uint32_t outSize = pixelDataSize + paletteOff;
 
-            if (!imgData.doAllocate(outSize)) {
+            //Pixels are fully overwritten, only the palette needs clearing
+            if (!imgData.doAllocate(outSize, paletteOff > 0)) {
                 JCORE_ERROR("[Image-IO] (BMP) Decode Error: Failed to allocate pixel buffer of size {0} bytes!", scanSize);
                 _freea(scan);
                 return false;
@@ -298,7 +306,7 @@ namespace JCore {
             return true;
         }
 
-        bool encode(std::string_view path, const ImageData& imgData, uint32_t dpi) {
+        bool encode(std::string_view path, const ImageView& imgData, uint32_t dpi) {
             FileStream fs(path);
             if (fs.open("wb")) {
                 return encode(fs, imgData, dpi);
@@ -307,7 +315,7 @@ namespace JCore {
             return false;
         }
 
-        bool encode(const Stream& stream, const ImageData& imgData, uint32_t dpi) {
+        bool encode(const Stream& stream, const ImageView& imgData, uint32_t dpi) {
 
             if (!stream.isOpen()) {
                 JCORE_ERROR("[Image-IO] (BMP) Encode Error: Stream isn't open!");
@@ -398,7 +406,9 @@ namespace JCore {
                     break;
                 case TextureFormat::Indexed8: {
                     Color32 palette[256]{};
-                    memcpy(palette, imgData.data, 1024);
+                    if (imgData.palette) {
+                        memcpy(palette, imgData.palette, size_t(Math::clamp(imgData.paletteSize, 0, 256)) * sizeof(Color32));
+                    }
                     for (size_t i = 0; i < 256; i++) {
                         palette[i].flipRB();
                         palette[i].a = 0x00;
@@ -408,8 +418,8 @@ namespace JCore {
                                             break;
             }
 
-            for (size_t y = 0, yP = size_t(imgData.height) * scanSR - size_t(scanSR); y < imgData.height; y++, yP -= scanSR) {
-                memcpy(scan, imgData.data + yP, scanSR);
+            for (int32_t y = imgData.height - 1; y >= 0; y--) {
+                memcpy(scan, imgData.getRow(y), scanSR);
                 flipRB(scan, imgData.width, bpp);
                 stream.write(scan, scanSP);
             }
@@ -896,7 +906,7 @@ namespace JCore {
         }
 
         bool decode(std::string_view path, ImageData& imgData, const ImageDecodeParams params) {
-            FileStream stream(path, "rb");
+            MappedFileStream stream(path);
             if (stream.isOpen()) {
                 return decode(stream, imgData, params);
             }
@@ -1013,49 +1023,63 @@ namespace JCore {
                 return false;
             }
 
-            uint8_t* rawBuffer = reinterpret_cast<uint8_t*>(_malloca(rawSize));
+            //Work buffers come from the pool so decoding a sequence of frames doesn't hit the heap
+            BufferPool& pool = BufferPool::getGlobal();
+            size_t rawCapacity = 0, compCapacity = 0, scanCapacity = 0;
+
+            uint8_t* rawBuffer = pool.allocate(rawSize, rawCapacity);
             if (!rawBuffer) {
-                free(imgData.data);
-                imgData.data = nullptr;
+                imgData.replaceData(nullptr, true);
                 JCORE_ERROR("[Image-IO] (PNG) Decode Error: Failed to allocate decompress buffer! ({0} bytes)", rawSize);
                 return false;
             }
 
-            uint8_t* compBuffer = reinterpret_cast<uint8_t*>(_malloca(totalIdat));
-            if (!compBuffer) {
-                _freea(rawBuffer);
-                free(imgData.data);
-                imgData.data = nullptr;
-                JCORE_ERROR("[Image-IO] (PNG) Decode Error: Failed to allocate IDAT buffer! ({0} bytes)", totalIdat);
-                return false;
+            //A single IDAT can be inflated straight from the stream's memory if it exposes it
+            const uint8_t* compData = nullptr;
+            if (idats.size() == 1) {
+                stream.seek(idats[0].position, SEEK_SET);
+                compData = stream.tryGetView(idats[0].length);
             }
 
-            size_t pos = 0;
-            for (const auto& ch : idats) {
-                stream.seek(ch.position, SEEK_SET);
-                stream.read(compBuffer + pos, ch.length, false);
-                pos += ch.length;
+            uint8_t* compBuffer = nullptr;
+            if (!compData) {
+                compBuffer = pool.allocate(totalIdat, compCapacity);
+                if (!compBuffer) {
+                    pool.deallocate(rawBuffer, rawCapacity);
+                    imgData.replaceData(nullptr, true);
+                    JCORE_ERROR("[Image-IO] (PNG) Decode Error: Failed to allocate IDAT buffer! ({0} bytes)", totalIdat);
+                    return false;
+                }
+
+                size_t pos = 0;
+                for (const auto& ch : idats) {
+                    stream.seek(ch.position, SEEK_SET);
+                    stream.read(compBuffer + pos, ch.length, false);
+                    pos += ch.length;
+                }
+                compData = compBuffer;
+            }
+
+            int32_t ret = ZLib::inflateData(compData, totalIdat, rawBuffer, rawSize);
+            if (compBuffer) {
+                pool.deallocate(compBuffer, compCapacity);
             }
-            int32_t ret = ZLib::inflateData(compBuffer, totalIdat, rawBuffer, rawSize);
-            _freea(compBuffer);
 
             if (ret == -1) {
                 JCORE_ERROR("[Image-IO] (PNG) Decode Error: ZLib Inflate failed!");
-                _freea(rawBuffer);
+                pool.deallocate(rawBuffer, rawCapacity);
 
-                free(imgData.data);
-                imgData.data = nullptr;
+                imgData.replaceData(nullptr, true);
                 return false;
             }
 
             size_t scanBuffered = size_t(scanSP) + bpp;
-            uint8_t* scanBuffer = reinterpret_cast<uint8_t*>(_malloca(scanBuffered * 2));
+            uint8_t* scanBuffer = pool.allocate(scanBuffered * 2, scanCapacity);
             if (!scanBuffer) {
                 JCORE_ERROR("[Image-IO] (PNG) Decode Error: Failed to allocate scan buffer!");
-                _freea(rawBuffer);
+                pool.deallocate(rawBuffer, rawCapacity);
 
-                free(imgData.data);
-                imgData.data = nullptr;
+                imgData.replaceData(nullptr, true);
                 return false;
             }
             memset(scanBuffer, 0, scanBuffered * 2);
@@ -1143,20 +1167,21 @@ namespace JCore {
 
                 JCORE_TRACE("[Image-IO] (PNG) Decode: Building palette with {0} colors!", colorCount);
                 totalSize = colorCount * 4 + (imgData.width * imgData.height * 2);
-                uint8_t* temp = reinterpret_cast<uint8_t*>(malloc(totalSize));
+                size_t tempCapacity = 0;
+                uint8_t* temp = pool.allocate(totalSize, tempCapacity);
 
                 if (!temp) {
                     JCORE_ERROR("[Image-IO] (PNG) Decode Error: Failed to allocate Indexed pixel buffer! ({0} bytes)", totalSize);
+                    pool.deallocate(scanBuffer, scanCapacity);
+                    pool.deallocate(rawBuffer, rawCapacity);
                     return false;
                 }
                 applyPalette(imgData.data, imgData.width, imgData.height, colorCount, imgData.format, temp, fmt, -1);
-
-                free(imgData.data);
-                imgData.data = temp;
+                imgData.replaceData(temp, true, tempCapacity, true);
             }
 
-            _freea(scanBuffer);
-            _freea(rawBuffer);
+            pool.deallocate(scanBuffer, scanCapacity);
+            pool.deallocate(rawBuffer, rawCapacity);
             return true;
         }
 
@@ -1164,7 +1189,8 @@ namespace JCore {
             FileStream stream(path, "rb");
 
             if (stream.isOpen()) {
-                return getInfo(stream, imgData);
+                BufferedStream buffered(stream, BufferedStream::HEADER_BUFFER_SIZE);
+                return getInfo(buffered, imgData);
             }
 
             JCORE_ERROR("[Image-IO] (PNG) Error: Failed to open '{0}'!", path);
@@ -1244,7 +1270,7 @@ namespace JCore {
             stream.writeValue(crc, 1, true);
         }
 
-        bool encode(std::string_view path, const ImageData& imgData, const uint32_t compression) {
+        bool encode(std::string_view path, const ImageView& imgData, const uint32_t compression) {
             FileStream fs(path);
             if (fs.open("wb")) {
                 return encode(fs, imgData, compression);
@@ -1253,17 +1279,22 @@ namespace JCore {
             return false;
         }
 
-        bool encode(const Stream& stream, const ImageData& imgData, const uint32_t compression) {
+        bool encode(const Stream& stream, const ImageView& imgData, const uint32_t compression) {
             if (!stream.isOpen()) {
                 JCORE_ERROR("[Image-IO] (PNG) Encode Error: Stream isn't open!");
                 return false;
             }
 
-            if (!imgData.data) {
+            if (!imgData.pixels) {
                 JCORE_ERROR("[Image-IO] (PNG) Encode Error: Given pixel array is null!");
                 return false;
             }
 
+            if (imgData.isIndexed() && !imgData.palette) {
+                JCORE_ERROR("[Image-IO] (PNG) Encode Error: Indexed image is missing its palette!");
+                return false;
+            }
+
             switch (imgData.format)
             {
                 default:
@@ -1301,7 +1332,7 @@ namespace JCore {
                     bufSpan.writeAt<uint8_t>(9, 0);
                     break;
                 case TextureFormat::Indexed16:
-                    if (hasAlpha(imgData.data, imgData.width, imgData.height, imgData.format, imgData.paletteSize)) {
+                    if (hasAlpha(imgData)) {
                         fmt = TextureFormat::RGBA32;
                         goto rgbaSet;
                     }
@@ -1332,9 +1363,10 @@ namespace JCore {
             if (imgData.format == TextureFormat::Indexed8) {
                 //Main palette, always 256
                 Color24 palette[256]{};
+                const size_t palCount = size_t(Math::clamp(imgData.paletteSize, 0, 256));
 
-                for (size_t i = 0, j = 0, k = 0; i < 256; i++, j += 3, k += 4) {
-                    memcpy(palette + i, imgData.data + k, 3);
+                for (size_t i = 0; i < palCount; i++) {
+                    memcpy(palette + i, imgData.palette + i, 3);
                 }
 
                 chunk.type = CH_PLTE;
@@ -1343,8 +1375,8 @@ namespace JCore {
 
                 //Transparency
                 uint8_t* alpha = reinterpret_cast<uint8_t*>(palette);
-                for (size_t i = 0, j = 3; i < 256; i++, j += 4) {
-                    alpha[i] = imgData.data[j];
+                for (size_t i = 0; i < 256; i++) {
+                    alpha[i] = i < palCount ? imgData.palette[i].a : 0x00;
                 }
                 chunk.type = CH_tRNS;
                 chunk.length = 256;
@@ -1354,9 +1386,11 @@ namespace JCore {
             int32_t bpp = getBitsPerPixel(fmt) >> 3;
             uint32_t scanSR = imgData.width * bpp;
             uint32_t scanSP = scanSR + 1;
-            uint8_t* scanBuffer = reinterpret_cast<uint8_t*>(malloc(scanSP * 6));
+            //Extra scanline at the end for expanding Indexed16 rows through the palette
+            size_t scanBufSize = size_t(scanSP) * 6 + scanSR;
+            uint8_t* scanBuffer = reinterpret_cast<uint8_t*>(malloc(scanBufSize));
             if (!scanBuffer) {
-                JCORE_ERROR("[Image-IO] (PNG) Encode Error: Couldn't allocate scan/filter buffer! ({0} bytes)", scanSP * 6);
+                JCORE_ERROR("[Image-IO] (PNG) Encode Error: Couldn't allocate scan/filter buffer! ({0} bytes)", scanBufSize);
                 return false;
             }
 
@@ -1369,11 +1403,10 @@ namespace JCore {
                 return false;
             }
 
-            bool indexed = imgData.format == TextureFormat::Indexed8 || imgData.format == TextureFormat::Indexed16;
             MemoryStream compStrm(compressBuf, 0, cmpBufSize);
-            uint8_t* pixData = imgData.data + (indexed ? imgData.paletteSize * 4 : 0);
+            uint8_t* expanded = scanBuffer + size_t(scanSP) * 6;
 
-            memset(scanBuffer, 0, scanSP * 6);
+            memset(scanBuffer, 0, scanBufSize);
             Span<uint8_t> prior(scanBuffer, scanSP);
             Span<uint8_t> current(scanBuffer + scanSP, scanSP);
 
@@ -1400,21 +1433,23 @@ namespace JCore {
 
             uint32_t compBufPos = 0;
 
-            int32_t bppR = getBitsPerPixel(imgData.format) >> 3;
-            for (int32_t y = 0, yP = 0, yPP = 0; y < imgData.height; y++, yP += scanSR, yPP += bppR) {
+            for (int32_t y = 0; y < imgData.height; y++) {
+                uint8_t* pixRow = imgData.getRow(y);
                 if (imgData.format == TextureFormat::Indexed16) {
-                    currentPix.write<uint8_t>(pixData + yPP, scanSR);
-                }
-                else {
-                    currentPix.write<uint8_t>(pixData + yP, scanSR);
+                    const uint16_t* indices = reinterpret_cast<const uint16_t*>(pixRow);
+                    for (int32_t x = 0, xP = 0; x < imgData.width; x++, xP += bpp) {
+                        memcpy(expanded + xP, imgData.palette + indices[x], bpp);
+                    }
+                    pixRow = expanded;
                 }
+                currentPix.write<uint8_t>(pixRow, scanSR);
 
                 if (imgData.format != TextureFormat::Indexed8) {
                     score = UINT64_MAX;
                     filter = 0;
                     calculateDiff(currentPix.get(), imgData.width, bpp, score);
 
-                    Span<uint8_t> pixScan(pixData + yP, scanSR);
+                    Span<uint8_t> pixScan(pixRow, scanSR);
                     for (uint8_t i = 0; i < 4; i++) {
                         applyFilter(pixScan, priorPix, filters[i], imgData.width, bpp, i + 1);
                         if (calculateDiff(filters[i].get(), imgData.width, bpp, score)) {
@@ -1427,7 +1462,7 @@ namespace JCore {
                     }
 
                     current[0] = filter;
-                    priorPix.write<uint8_t>(pixData + yP, scanSR);
+                    priorPix.write<uint8_t>(pixRow, scanSR);
                 }
 
                 ZLib::deflateSegment(context, current.get(), current.length(), compStrm, BUFFER, ZLIB_BUFFER_SIZE);
@@ -1793,7 +1828,7 @@ namespace JCore {
         }
 
         bool decode(std::string_view path, ImageData& imgData, const ImageDecodeParams params) {
-            FileStream stream(path, "rb");
+            MappedFileStream stream(path);
 
             if (stream.isOpen()) {
                 return decode(stream, imgData, params);
@@ -1866,17 +1901,11 @@ namespace JCore {
                     break;
             }
 
-            if (!imgData.doAllocate()) {
+            if (!imgData.doAllocate(imgData.getSize(), false)) {
                 JCORE_ERROR("[Image-IO] (DDS) Error: Failed to allocate image data!");
                 return false;
             }
 
-            uint8_t* scan = reinterpret_cast<uint8_t*>(_malloca(pitch));
-            if (!scan) {
-                JCORE_ERROR("[Image-IO] (DDS) Error: Failed to allocate scan buffer!");
-                return false;
-            }
-
             stream.seek(dataStart, SEEK_SET);
             const int32_t maskOffsets[4]{
                    Math::findFirstLSB(fmt.compMasks[0]),
@@ -1885,9 +1914,25 @@ namespace JCore {
                    Math::findFirstLSB(fmt.compMasks[3]),
             };
 
-            for (int32_t y = 0, yP = 0; y < imgData.height; y++, yP += scanSize) {
-                stream.read(scan, pitch, false);
-                memcpy(imgData.data + yP, scan, scanSize);
+            //Rows are copied straight out of the stream's memory if it exposes it, otherwise read through a scan buffer
+            if (const uint8_t* rows = stream.tryGetView(size_t(pitch) * imgData.height)) {
+                for (int32_t y = 0, yP = 0; y < imgData.height; y++, yP += scanSize, rows += pitch) {
+                    memcpy(imgData.data + yP, rows, scanSize);
+                }
+            }
+            else {
+                uint8_t* scan = reinterpret_cast<uint8_t*>(_malloca(pitch));
+                if (!scan) {
+                    imgData.replaceData(nullptr, true);
+                    JCORE_ERROR("[Image-IO] (DDS) Error: Failed to allocate scan buffer!");
+                    return false;
+                }
+
+                for (int32_t y = 0, yP = 0; y < imgData.height; y++, yP += scanSize) {
+                    stream.read(scan, pitch, false);
+                    memcpy(imgData.data + yP, scan, scanSize);
+                }
+                _freea(scan);
             }
 
             int32_t reso = imgData.width * imgData.height;
@@ -1936,12 +1981,10 @@ namespace JCore {
                     break;
                 }
             }
-
-            _freea(scan);
             return true;
         }
 
-        bool encode(std::string_view path, const ImageData& imgData) {
+        bool encode(std::string_view path, const ImageView& imgData) {
             FileStream fs(path);
             if (fs.open("wb")) {
                 return encode(fs, imgData);
@@ -1950,7 +1993,7 @@ namespace JCore {
             return false;
         }
 
-        bool encode(const Stream& stream, const ImageData& imgData) {
+        bool encode(const Stream& stream, const ImageView& imgData) {
             if (!stream.isOpen()) {
                 JCORE_ERROR("[Image-IO] (DDS) Encode Error: Stream isn't open!");
                 return false;
@@ -1969,6 +2012,11 @@ namespace JCore {
                     break;
             }
 
+            if (imgData.isIndexed() && !imgData.palette) {
+                JCORE_ERROR("[Image-IO] (DDS) Encode Error: Indexed image is missing its palette!");
+                return false;
+            }
+
             DDSFormat fmt{};
 
             fmt.compression = DDSCompression::DDS_None;
@@ -2031,9 +2079,11 @@ namespace JCore {
             switch (imgData.format)
             {
                 case TextureFormat::R8: {
-                    size_t scanS = size_t(imgData.width) * 3;
-                    for (size_t y = 0, yP = 0; y < imgData.height; y++, yP += imgData.width) {
-                        memset(scan, imgData.data[yP], scanS);
+                    for (int32_t y = 0; y < imgData.height; y++) {
+                        const uint8_t* row = imgData.getRow(y);
+                        for (size_t x = 0, xP = 0; x < imgData.width; x++, xP += 3) {
+                            memset(scan + xP, row[x], 3);
+                        }
                         stream.write(scan, pitch);
                     }
                     break;
@@ -2041,30 +2091,30 @@ namespace JCore {
                 case TextureFormat::RGB24:
                 case TextureFormat::RGBA4444:
                 case TextureFormat::RGBA32: {
-                    size_t scanS = size_t(getBitsPerPixel(imgData.format) >> 3) * imgData.width;
-                    for (size_t y = 0, yP = 0; y < imgData.height; y++, yP += scanS) {
-                        memcpy(scan, imgData.data + yP, scanS);
+                    size_t scanS = imgData.getScanSize();
+                    for (int32_t y = 0; y < imgData.height; y++) {
+                        memcpy(scan, imgData.getRow(y), scanS);
                         stream.write(scan, pitch);
                     }
                     break;
                 }
                 case TextureFormat::Indexed8: {
-                    const Color32* palette = reinterpret_cast<const Color32*>(imgData.data);
-                    const uint8_t* pixels = imgData.data + 1024;
-                    for (size_t y = 0, yP = 0; y < imgData.height; y++, yP += imgData.width) {
+                    const Color32* palette = imgData.palette;
+                    for (int32_t y = 0; y < imgData.height; y++) {
+                        const uint8_t* pixels = imgData.getRow(y);
                         for (size_t x = 0, xP = 0; x < imgData.width; x++, xP += 4) {
-                            memcpy(scan + xP, palette + pixels[yP + x], 4);
+                            memcpy(scan + xP, palette + pixels[x], 4);
                         }
                         stream.write(scan, pitch);
                     }
                     break;
                 }
                 case TextureFormat::Indexed16: {
-                    const Color32* palette = reinterpret_cast<const Color32*>(imgData.data);
-                    const uint16_t* pixels = reinterpret_cast<const uint16_t*>(imgData.data + (imgData.paletteSize * sizeof(Color32)));
-                    for (size_t y = 0, yP = 0; y < imgData.height; y++, yP += imgData.width) {
+                    const Color32* palette = imgData.palette;
+                    for (int32_t y = 0; y < imgData.height; y++) {
+                        const uint16_t* pixels = reinterpret_cast<const uint16_t*>(imgData.getRow(y));
                         for (size_t x = 0, xP = 0; x < imgData.width; x++, xP += 4) {
-                            memcpy(scan + xP, palette + pixels[yP + x], 4);
+                            memcpy(scan + xP, palette + pixels[x], 4);
                         }
                         stream.write(scan, pitch);
                     }
@@ -2107,7 +2157,8 @@ namespace JCore {
         bool decode(std::string_view path, ImageData& imgData, const ImageDecodeParams params) {
             FileStream stream(path, "rb");
             if (stream.isOpen()) {
-                return decode(stream, imgData, params);
+                BufferedStream buffered(stream);
+                return decode(buffered, imgData, params);
             }
             JCORE_ERROR("[Image-IO] (ICO) Decode Error: Failed to open '{0}'!", path);
             return false;
@@ -2170,7 +2221,7 @@ namespace JCore {
             return ret;
         }
 
-        bool encode(std::string_view path, const ImageData& imgData, bool compressed) {
+        bool encode(std::string_view path, const ImageView& imgData, bool compressed) {
             FileStream stream(path, "rb");
             if (stream.isOpen()) {
                 return encode(stream, imgData, compressed);
@@ -2179,7 +2230,7 @@ namespace JCore {
             return false;
         }
 
-        bool encode(const Stream& stream, const ImageData& imgData, bool compressed) {
+        bool encode(const Stream& stream, const ImageView& imgData, bool compressed) {
             return false;
         }
 
@@ -2196,35 +2247,24 @@ namespace JCore {
             JTEX_Compressed = 0x1,
         };
 
-        bool getInfo(std::string_view path, ImageData& imgData) {
-            FileStream stream(path, "rb");
-
-            if (stream.isOpen()) {
-                return getInfo(stream, imgData);
-            }
-
-            JCORE_ERROR("[Image-IO] (JTEX) Error: Failed to open '{0}'!", path);
-            return false;
-        }
+#pragma pack(push, 1)
+        struct Header {
+            uint32_t sig;
+            JTEXFlags flags;
+            int32_t width;
+            int32_t height;
+            TextureFormat format;
+            int32_t paletteSize;
+            uint8_t imgFlags;
+        };
+#pragma pack(pop, 1)
 
-        bool getInfo(const Stream& stream, ImageData& imgData) {
+        static bool readHeader(const Stream& stream, ImageData& imgData, JTEXFlags& flags) {
             if (!stream.isOpen()) {
                 JCORE_ERROR("[Image-IO] (JTEX) Decode Error: Stream isn't open!");
                 return false;
             }
 
-#pragma pack(push, 1)
-            struct Header {
-                uint32_t sig;
-                JTEXFlags flags;
-                int32_t width;
-                int32_t height;
-                TextureFormat format;
-                int32_t paletteSize;
-                uint8_t imgFlags;
-            };
-#pragma pack(pop, 1)
-
             Header hdr{};
             stream.readValue(hdr, false);
 
@@ -2233,6 +2273,7 @@ namespace JCore {
                 return false;
             }
 
+            flags = hdr.flags;
             imgData.width = hdr.width;
             imgData.height = hdr.height;
             imgData.format = hdr.format;
@@ -2241,9 +2282,42 @@ namespace JCore {
             return true;
         }
 
-        bool decode(std::string_view path, ImageData& imgData, const ImageDecodeParams params) {
+        static bool writeData(const Stream& stream, const ImageView& imgData) {
+            if (imgData.isIndexed()) {
+                stream.write(imgData.palette, imgData.getPaletteBytes(), false);
+            }
+
+            if (imgData.isContiguous()) {
+                stream.write(imgData.pixels, imgData.getScanSize() * imgData.height, false);
+                return true;
+            }
+
+            const size_t scanS = imgData.getScanSize();
+            for (int32_t y = 0; y < imgData.height; y++) {
+                stream.write(imgData.getRow(y), scanS, false);
+            }
+            return true;
+        }
+
+        bool getInfo(std::string_view path, ImageData& imgData) {
             FileStream stream(path, "rb");
 
+            if (stream.isOpen()) {
+                return getInfo(stream, imgData);
+            }
+
+            JCORE_ERROR("[Image-IO] (JTEX) Error: Failed to open '{0}'!", path);
+            return false;
+        }
+
+        bool getInfo(const Stream& stream, ImageData& imgData) {
+            JTEXFlags flags{};
+            return readHeader(stream, imgData, flags);
+        }
+
+        bool decode(std::string_view path, ImageData& imgData, const ImageDecodeParams params) {
+            MappedFileStream stream(path);
+
             if (stream.isOpen()) {
                 return decode(stream, imgData, params);
             }
@@ -2253,42 +2327,64 @@ namespace JCore {
         }
 
         bool decode(const Stream& stream, ImageData& imgData, const ImageDecodeParams params) {
-            if (!getInfo(stream, imgData)) {
+            JTEXFlags flags{};
+            if (!readHeader(stream, imgData, flags)) {
                 return false;
             }
 
-            if (!imgData.doAllocate()) {
+            const size_t size = imgData.getSize();
+            if (!imgData.doAllocate(size, false)) {
                 JCORE_ERROR("[Image-IO] (JTEX) Decode Error: Failed to allocate pixel buffer!");
                 return false;
             }
-            stream.read(imgData.data, imgData.getSize(), false);
+
+            if (flags & JTEX_Compressed) {
+                //Inflated straight into the pixel buffer
+                InflateStream inflate(stream, size);
+                if (inflate.read(imgData.data, 1, size, false) != size) {
+                    JCORE_ERROR("[Image-IO] (JTEX) Decode Error: Failed to decompress pixel data!");
+                    return false;
+                }
+                return true;
+            }
+            stream.read(imgData.data, size, false);
             return true;
         }
 
-        bool encode(std::string_view path, const ImageData& imgData) {
+        bool encode(std::string_view path, const ImageView& imgData, const int32_t compression) {
             FileStream fs(path);
             if (fs.open("wb")) {
-                return encode(fs, imgData);
+                return encode(fs, imgData, compression);
             }
             JCORE_ERROR("[Image-IO] (JTEX) Encode Error: Failed to open file '{0}' for writing!", path);
             return false;
         }
 
-        bool encode(const Stream& stream, const ImageData& imgData) {
+        bool encode(const Stream& stream, const ImageView& imgData, const int32_t compression) {
             if (!stream.isOpen()) {
                 JCORE_ERROR("[Image-IO] (JTEX) Encode Error: Stream isn't open!");
                 return false;
             }
 
+            if (!imgData.pixels || (imgData.isIndexed() && !imgData.palette)) {
+                JCORE_ERROR("[Image-IO] (JTEX) Encode Error: Given image has no pixel or palette data!");
+                return false;
+            }
+
             stream.writeValue(JTEX_SIG);
-            stream.writeValue(0U);
+            stream.writeValue(uint32_t(compression > 0 ? JTEX_Compressed : JTEX_None));
             stream.writeValue(imgData.width);
             stream.writeValue(imgData.height);
             stream.writeValue(imgData.format);
             stream.writeValue(imgData.paletteSize);
             stream.writeValue(imgData.flags);
-            stream.write(imgData.data, imgData.getSize(), false);
-            return true;
+
+            if (compression > 0) {
+                //Rows are compressed as they're written, nothing gets staged in between
+                DeflateStream deflate(stream, Math::min(compression, 9));
+                return writeData(deflate, imgData) && deflate.finish();
+            }
+            return writeData(stream, imgData);
         }
     }
 
@@ -2328,10 +2424,20 @@ namespace JCore {
         }
 
         bool tryDecode(std::string_view path, ImageData& imgData, DataFormat& format, const ImageDecodeParams params) {
-            FileStream stream(path, "rb");
+            ImageCache& cache = ImageCache::getGlobal();
+            const uint64_t cacheKey = (params.flags & F_IMG_SKIP_CACHE) == 0 && cache.isOpen() ? cache.getKey(path, params) : 0;
+            if (cacheKey && cache.tryLoad(cacheKey, imgData, format)) {
+                return true;
+            }
+
+            MappedFileStream stream(path);
 
             if (stream.isOpen()) {
                 if (tryDecode(stream, imgData, format, params)) {
+                    //JTEX sources already load as fast as a cache entry would
+                    if (cacheKey && format != DataFormat::FMT_JTEX) {
+                        cache.store(cacheKey, imgData, format);
+                    }
                     return true;
                 }
                 JCORE_ERROR("[Image-IO] Error: Failed to decode '{0}'!", path);
@@ -2365,7 +2471,7 @@ namespace JCore {
             }
         }
 
-        bool tryEncode(std::string_view path, const ImageData& imgData, DataFormat format, const ImageEncodeParams& encodeParams) {
+        bool tryEncode(std::string_view path, const ImageView& imgData, DataFormat format, const ImageEncodeParams& encodeParams) {
             FileStream fs(path);
             if (fs.open("wb")) {
                 return tryEncode(fs, imgData, format, encodeParams);
@@ -2374,7 +2480,7 @@ namespace JCore {
             return false;
         }
 
-        bool tryEncode(const Stream& stream, const ImageData& imgData, DataFormat format, const ImageEncodeParams& encodeParams) {
+        bool tryEncode(const Stream& stream, const ImageView& imgData, DataFormat format, const ImageEncodeParams& encodeParams) {
             switch (format) {
                 default:
                     JCORE_WARN("[Image-IO] Warning: Given encoding format is unsupported! ({0})", Enum::nameOf(format));
@@ -0,0 +1,325 @@
+#include <J-Core/IO/ImageCache.h>
+#include <J-Core/IO/MappedFileStream.h>
+#include <J-Core/IO/IOUtils.h>
+#include <J-Core/Util/DataUtils.h>
+#include <J-Core/Log.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace JCore {
+    namespace {
+        constexpr uint32_t CACHE_SIG = 0x434D494AU;
+        //Bump whenever decoders change their output, old entries then just stop matching & age out
+        constexpr uint32_t CACHE_VERSION = 1;
+        constexpr const char* CACHE_EXTENSION = ".jtc";
+        constexpr const char* TEMP_EXTENSION = ".tmp";
+
+#pragma pack(push, 1)
+        struct EntryHeader {
+            uint32_t signature;
+            uint32_t version;
+            uint64_t key;
+            uint32_t format;
+            uint32_t reserved;
+        };
+
+        struct KeyInfo {
+            uint64_t size;
+            int64_t time;
+            uint64_t flags;
+        };
+#pragma pack(pop)
+
+        bool statSource(const fs::path& path, uint64_t& size, int64_t& time) {
+#ifdef _WIN32
+            WIN32_FILE_ATTRIBUTE_DATA info{};
+            if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &info) || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) { return false; }
+
+            size = (uint64_t(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+            time = int64_t((uint64_t(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime);
+            return true;
+#else
+            struct stat info {};
+            if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) { return false; }
+
+            size = uint64_t(info.st_size);
+            time = int64_t(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+            return true;
+#endif
+        }
+    }
+
+    ImageCache::ImageCache() : _mutex(), _directory(), _isOpen(false), _compression(0), _maxBytes(DEFAULT_MAX_BYTES),
+        _totalBytes(0), _useCounter(0), _tempCounter(0), _entries() {}
+
+    ImageCache::~ImageCache() {
+        close();
+    }
+
+    ImageCache& ImageCache::getGlobal() {
+        static ImageCache cache{};
+        return cache;
+    }
+
+    bool ImageCache::open(const fs::path& directory, uint64_t maxBytes, int32_t compression) {
+        close();
+
+        std::error_code err{};
+        fs::create_directories(directory, err);
+        if (!fs::is_directory(directory, err)) {
+            JCORE_ERROR("[J-Core - ImageCache] Error: Failed to create cache directory '{0}'!", directory.string());
+            return false;
+        }
+
+        struct Found {
+            uint64_t key;
+            uint64_t size;
+            fs::file_time_type time;
+        };
+
+        std::vector<Found> found{};
+        for (fs::directory_iterator it(directory, err), end; !err && it != end; it.increment(err)) {
+            std::error_code fileErr{};
+            const fs::path& file = it->path();
+            if (!it->is_regular_file(fileErr)) { continue; }
+
+            //Temp files are only left behind by a crash mid store
+            const fs::path extension = file.extension();
+            if (extension == TEMP_EXTENSION) {
+                fs::remove(file, fileErr);
+                continue;
+            }
+
+            const std::string stem = file.stem().string();
+            if (extension != CACHE_EXTENSION || stem.length() != 16) { continue; }
+
+            char* stemEnd = nullptr;
+            const uint64_t key = strtoull(stem.c_str(), &stemEnd, 16);
+            if (stemEnd != stem.c_str() + stem.length() || key == 0) { continue; }
+
+            Found entry{ key, uint64_t(it->file_size(fileErr)), it->last_write_time(fileErr) };
+            if (!fileErr) {
+                found.push_back(entry);
+            }
+        }
+
+        if (err) {
+            JCORE_WARN("[J-Core - ImageCache] Warning: Failed to list cache directory '{0}'! ({1})", directory.string(), err.message());
+        }
+
+        //Entries are touched on every hit, so modification times give the use order of previous runs
+        std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time < b.time; });
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _directory = directory;
+        _maxBytes = maxBytes;
+        _compression = compression;
+        _entries.reserve(found.size());
+        for (const Found& entry : found) {
+            CacheEntry& cached = _entries[entry.key];
+            cached.size = entry.size;
+            cached.lastUse = ++_useCounter;
+            _totalBytes += entry.size;
+        }
+        _isOpen = true;
+
+        if (_totalBytes > _maxBytes) {
+            trimLocked(_maxBytes);
+        }
+        return true;
+    }
+
+    void ImageCache::close() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isOpen = false;
+        _entries.clear();
+        _totalBytes = 0;
+        _useCounter = 0;
+    }
+
+    bool ImageCache::isOpen() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _isOpen;
+    }
+
+    uint64_t ImageCache::getKey(std::string_view path, const ImageDecodeParams& params) const {
+        std::error_code err{};
+        const fs::path source = fs::absolute(fs::path(path), err).lexically_normal();
+        if (err) { return 0; }
+
+        KeyInfo info{};
+        if (!statSource(source, info.size, info.time)) { return 0; }
+        info.flags = params.flags & ~F_IMG_SKIP_CACHE;
+
+        const std::string name = source.generic_string();
+        const uint64_t key = Data::hash64(&info, sizeof(info), Data::hash64(name.data(), name.length(), CACHE_VERSION));
+        return key ? key : 1;
+    }
+
+    bool ImageCache::tryLoad(uint64_t key, ImageData& imgData, DataFormat& format) {
+        fs::path file{};
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            CacheEntry* entry = _isOpen && key ? _entries.tryGet(key) : nullptr;
+            if (!entry) { return false; }
+
+            entry->lastUse = ++_useCounter;
+            file = getEntryPath(key);
+        }
+
+        {
+            MappedFileStream stream(file.string());
+            EntryHeader header{};
+            const bool valid = stream.isOpen() && stream.read(&header, sizeof(header), 1, false) == sizeof(header) &&
+                header.signature == CACHE_SIG && header.version == CACHE_VERSION && header.key == key;
+
+            if (valid && JTEX::decode(stream, imgData)) {
+                format = DataFormat(header.format);
+                std::error_code err{};
+                fs::last_write_time(file, fs::file_time_type::clock::now(), err);
+                return true;
+            }
+        }
+
+        JCORE_WARN("[J-Core - ImageCache] Warning: Cache entry '{0}' is corrupted, removing it!", file.string());
+        removeEntry(key);
+        return false;
+    }
+
+    bool ImageCache::store(uint64_t key, const ImageView& imgData, DataFormat format) {
+        if (key == 0) { return false; }
+
+        fs::path file{};
+        fs::path temp{};
+        int32_t compression = 0;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_isOpen) { return false; }
+
+            file = getEntryPath(key);
+            temp = file;
+            temp += fmt::format(".{0}{1}", ++_tempCounter, TEMP_EXTENSION);
+            compression = _compression;
+        }
+
+        bool written = false;
+        {
+            FileStream stream(temp.string(), "wb");
+            if (stream.isOpen()) {
+                const EntryHeader header{ CACHE_SIG, CACHE_VERSION, key, uint32_t(format), 0 };
+                written = stream.write(&header, sizeof(header), 1, false) == sizeof(header) &&
+                    JTEX::encode(stream, imgData, compression) && stream.flush();
+            }
+        }
+
+        std::error_code err{};
+        const uint64_t size = written ? uint64_t(fs::file_size(temp, err)) : 0;
+        if (written && !err) {
+            //Readers either see the old entry or the complete new one, never a partial file
+            fs::rename(temp, file, err);
+        }
+
+        if (!written || err) {
+            JCORE_WARN("[J-Core - ImageCache] Warning: Failed to write cache entry '{0}'!", file.string());
+            fs::remove(temp, err);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_isOpen) { return false; }
+
+        CacheEntry& entry = _entries[key];
+        _totalBytes = _totalBytes - entry.size + size;
+        entry.size = size;
+        entry.lastUse = ++_useCounter;
+
+        //Trimmed a bit below the limit so every store after hitting it doesn't end up evicting
+        if (_totalBytes > _maxBytes) {
+            trimLocked(_maxBytes - (_maxBytes >> 3));
+        }
+        return true;
+    }
+
+    void ImageCache::trim(uint64_t targetBytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        trimLocked(targetBytes);
+    }
+
+    void ImageCache::clear() {
+        trim(0);
+    }
+
+    uint64_t ImageCache::getSize() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _totalBytes;
+    }
+
+    size_t ImageCache::getEntryCount() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _entries.size();
+    }
+
+    uint64_t ImageCache::getMaxBytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _maxBytes;
+    }
+
+    void ImageCache::setMaxBytes(uint64_t maxBytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxBytes = maxBytes;
+        if (_totalBytes > _maxBytes) {
+            trimLocked(_maxBytes);
+        }
+    }
+
+    fs::path ImageCache::getEntryPath(uint64_t key) const {
+        return _directory / fmt::format("{0:016x}{1}", key, CACHE_EXTENSION);
+    }
+
+    void ImageCache::removeEntry(uint64_t key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!removeEntryFile(key)) { return; }
+
+        if (const CacheEntry* entry = _entries.tryGet(key)) {
+            _totalBytes -= entry->size;
+            _entries.erase(key);
+        }
+    }
+
+    bool ImageCache::removeEntryFile(uint64_t key) const {
+        //Not an error if the file is already gone, only if it's still there (e.g. open in another thread on Windows)
+        std::error_code err{};
+        fs::remove(getEntryPath(key), err);
+        if (err) {
+            JCORE_WARN("[J-Core - ImageCache] Warning: Failed to remove cache entry '{0:016x}'! ({1})", key, err.message());
+            return false;
+        }
+        return true;
+    }
+
+    void ImageCache::trimLocked(uint64_t targetBytes) {
+        if (_totalBytes <= targetBytes) { return; }
+
+        std::vector<std::pair<uint64_t, uint64_t>> order{};
+        order.reserve(_entries.size());
+        for (const auto& entry : _entries) {
+            order.emplace_back(entry.second.lastUse, entry.first);
+        }
+        std::sort(order.begin(), order.end());
+
+        for (size_t i = 0; i < order.size() && _totalBytes > targetBytes; i++) {
+            //Entries that can't be deleted right now stay counted & are retried by the next trim
+            const uint64_t key = order[i].second;
+            if (!removeEntryFile(key)) { continue; }
+
+            _totalBytes -= _entries.tryGet(key)->size;
+            _entries.erase(key);
+        }
+    }
+}
@@ -2,7 +2,9 @@
 #include <J-Core/Log.h>
 #include <J-Core/Math/Math.h>
 #include <J-Core/TaskManager.h>
+#include <J-Core/Util/Parallel.h>
 #include <unordered_set>
+#include <emmintrin.h>
 #include <glm.hpp>
 #include <stack>
 #include <queue>
@@ -126,7 +128,7 @@ namespace JCore {
         return true;
     }
 
-    bool tryBuildPalette(Color32 pixel, int32_t& colors, TextureFormat& format, uint8_t* newPalette, std::unordered_map<uint32_t, int32_t>& paletteLut, int32_t alphaClip, int32_t absoluteMax) {
+    bool tryBuildPalette(Color32 pixel, int32_t& colors, TextureFormat& format, uint8_t* newPalette, FlatMap<uint32_t, int32_t>& paletteLut, int32_t alphaClip, int32_t absoluteMax) {
         absoluteMax = absoluteMax <= 0 ? 256 * 256 : absoluteMax;
 
         uint32_t& colorInt = reinterpret_cast<uint32_t&>(pixel);
@@ -135,10 +137,7 @@ namespace JCore {
         }
 
         Color32* palette = reinterpret_cast<Color32*>(newPalette);
-        auto find = paletteLut.find(colorInt);
-
-        if (find == paletteLut.end()) {
-            paletteLut[colorInt] = colors;
+        if (paletteLut.tryEmplace(colorInt, colors).second) {
             palette[colors++] = pixel;
 
             if (colors > absoluteMax) {
@@ -368,22 +367,16 @@ namespace JCore {
         JCORE_ASSERT(index >= 0 && index < 4, "Index out of range");
         uint8_t flag = (1 << index);
         auto& buf = _buffers[index];
-        if (_flags & flag) {
-            void* reloc = realloc(buf.data, size);
-            if (!reloc) {
-                JCORE_ERROR("[ImageUtils - Alloc] Failed to reallocate buffer! ({0} bytes)", size);
-                return;
-            }
-            buf.data = reinterpret_cast<uint8_t*>(reloc);
+        if (!(_flags & flag)) {
+            //Not ours to release, just drop the reference
+            buf.replaceData(nullptr, false);
         }
-        else {
-            buf.data = reinterpret_cast<uint8_t*>(malloc(size));
-            if (!buf.data) {
-                JCORE_ERROR("[ImageUtils - Alloc] Failed to allocate buffer! ({0} bytes)", size);
-                return;
-            }
+
+        if (!buf.doAllocate(size, false)) {
+            JCORE_ERROR("[ImageUtils - Alloc] Failed to allocate buffer! ({0} bytes)", size);
+            return;
         }
-        _flags |= (1 << index);
+        _flags |= flag;
     }
 
     void ImageBuffers::clear() {
@@ -393,33 +386,42 @@ namespace JCore {
     }
 
     void ImageData::resize(int32_t newWidth, int32_t newHeight, bool linear, ImageData* tempBuffer) {
-        if ((newWidth == width && newHeight == height) || ((newHeight & newWidth) & 0x7FFFFFFF) == 0 || !data) { return; }
+        if ((newWidth == width && newHeight == height) || newWidth < 1 || newHeight < 1 || !data) { return; }
 
         ImageData tmpIM{};
         ImageData& tmp = tempBuffer ? *tempBuffer : tmpIM;
 
-        int32_t oldW = width;
-        int32_t oldH = height;
-
-        int32_t bpp = (getBitsPerPixel(format) >> 3);
-        int32_t resoNew = newWidth * newHeight;
-        int32_t resoOld = width * height;
-
-        if (!tmp.doAllocate(width, height, format, paletteSize, flags)) {
+        if (!tmp.copyFrom(*this)) {
             return;
         }
-        memcpy(tmp.data, data, getSize());
-
-        if (!doAllocate(newWidth, newHeight, format)) {
-            width = oldW;
-            height = oldH;
 
+        if (!doAllocate(newWidth, newHeight, format, paletteSize, isAligned())) {
             if (!tempBuffer) {
                 tmp.clear(true);
             }
             return;
         }
-        switch (format)
+
+        ImageView src = tmp.getView();
+        ImageView dst = getView();
+        if (src.palette && dst.palette) {
+            memcpy(dst.palette, src.palette, dst.getPaletteBytes());
+        }
+        resizeImage(src, dst, linear);
+
+        if (!tempBuffer) {
+            tmp.clear(true);
+        }
+    }
+
+    bool resizeImage(const ImageView& src, const ImageView& dst, bool linear) {
+        if (!src.isValid() || !dst.isValid()) { return false; }
+        if (src.format != dst.format) {
+            JCORE_WARN("[J-Core - ImageUtils] Warning: Can't resize from '{0}' to '{1}', formats must match!", getTextureFormatName(src.format), getTextureFormatName(dst.format));
+            return false;
+        }
+
+        switch (src.format)
         {
         default:
             linear = false;
@@ -429,12 +431,13 @@ namespace JCore {
             break;
         }
 
+        const int32_t bpp = src.getBytesPerPixel();
+        const int32_t oldW = src.width;
+        const int32_t oldH = src.height;
+        const int32_t newWidth = dst.width;
+        const int32_t newHeight = dst.height;
 
-        int32_t scan = newWidth * bpp;
-        int32_t scanOld = oldW * bpp;
         if (linear) {
-            const uint8_t* bufferIn = tmp.getData();
-            uint8_t* bufferOut = this->getData();
             Color32 clr32[4]{
                 {0x00, 0x00, 0x00, 0x00},
                 {0x00, 0x00, 0x00, 0x00},
@@ -442,18 +445,16 @@ namespace JCore {
                 {0x00, 0x00, 0x00, 0x00},
             };
 
-            float xs = (float)oldW / width;
-            float ys = (float)oldH / height;
+            float xs = (float)oldW / newWidth;
+            float ys = (float)oldH / newHeight;
 
             float fracx{ 0 }, fracy{ 0 }, ifracx{ 0 }, ifracy{ 0 }, sx{ 0 }, sy{ 0 }, l0{ 0 }, l1{ 0 }, rf{ 0 }, gf{ 0 }, bf{ 0 };
             int32_t  x0{ 0 }, x1{ 0 }, y0{ 0 }, y1{ 0 };
 
             Color32 out{ 0x00, 0x00, 0x00, 0xFF };
-
-            int32_t srcIdx = 0;
-
-            for (int32_t y = 0, yP = 0; y < newHeight; y++, yP += scan) {
-                for (int32_t x = 0, xP = yP; x < newWidth; x++, xP += bpp) {
+            for (int32_t y = 0; y < newHeight; y++) {
+                uint8_t* bufferOut = dst.getRow(y);
+                for (int32_t x = 0, xP = 0; x < newWidth; x++, xP += bpp) {
                     sx = x * xs;
                     sy = y * ys;
                     x0 = (int)sx;
@@ -476,17 +477,10 @@ namespace JCore {
                     }
 
                     // Read source color
-                    const uint8_t* c = (bufferIn + (y0 * scanOld) + x0 * bpp);
-                    memcpy(clr32 + 0, c, bpp);
-
-                    c = bufferIn + (y0 * scanOld + x1 * bpp);
-                    memcpy(clr32 + 1, c, bpp);
-
-                    c = bufferIn + (y1 * scanOld + x0 * bpp);
-                    memcpy(clr32 + 2, c, bpp);
-
-                    c = bufferIn + (y1 * scanOld + x1 * bpp);
-                    memcpy(clr32 + 3, c, bpp);
+                    memcpy(clr32 + 0, src.getPixel(x0, y0), bpp);
+                    memcpy(clr32 + 1, src.getPixel(x1, y0), bpp);
+                    memcpy(clr32 + 2, src.getPixel(x0, y1), bpp);
+                    memcpy(clr32 + 3, src.getPixel(x1, y1), bpp);
 
                     // Calculate colors
                     // Alpha
@@ -529,35 +523,79 @@ namespace JCore {
             }
         }
         else {
-            const uint8_t* bufferIn = tmp.getData();
-            uint8_t* bufferOut = this->getData();
-            for (int32_t y = 0, yP = 0; y < newHeight; y++, yP += scan) {
-                int32_t srY = int32_t((oldH - 1) * (y / float(newHeight - 1.0f))) * scanOld;
-                for (int32_t x = 0, xP = yP; x < newWidth; x++, xP += bpp) {
-                    int32_t srX = int32_t((oldW - 1) * x / float(newWidth - 1.0f)) * bpp;
-                    memcpy(bufferOut + xP, bufferIn + srY + srX, bpp);
+            const float stepX = newWidth > 1 ? (oldW - 1) / float(newWidth - 1.0f) : 0.0f;
+            const float stepY = newHeight > 1 ? (oldH - 1) / float(newHeight - 1.0f) : 0.0f;
+            for (int32_t y = 0; y < newHeight; y++) {
+                const uint8_t* bufferIn = src.getRow(int32_t(y * stepY));
+                uint8_t* bufferOut = dst.getRow(y);
+                for (int32_t x = 0, xP = 0; x < newWidth; x++, xP += bpp) {
+                    memcpy(bufferOut + xP, bufferIn + size_t(x * stepX) * bpp, bpp);
                 }
             }
         }
+        return true;
+    }
 
+    bool ImageData::doAllocate(size_t size, bool clear) {
+        return allocateBuffer(size, data ? getSize() : 0, clear);
+    }
 
-        if (!tempBuffer) {
-            tmp.clear(true);
+    bool ImageData::allocateBuffer(size_t size, size_t keepSize, bool clear) {
+        if (data && size <= _bufferSize) {
+            if (clear) {
+                memset(data, 0, size);
+            }
+            return true;
+        }
+
+        size_t capacity = 0;
+        uint8_t* buffer = BufferPool::getGlobal().allocate(size, capacity);
+        if (!buffer) { return false; }
+
+        if (data) {
+            if (!clear) {
+                //Buffers handed over through replaceData may not know their capacity, only the image in them is known to be valid
+                memcpy(buffer, data, Math::min(_bufferSize ? _bufferSize : keepSize, capacity));
+            }
+            releaseBuffer();
         }
+
+        data = buffer;
+        _bufferSize = capacity;
+        _pooled = true;
+
+        if (clear) {
+            memset(data, 0, size);
+        }
+        return true;
     }
 
-    void ImageData::replaceData(uint8_t* newData, bool destroy) {
-        if (destroy && data) {
+    void ImageData::releaseBuffer() {
+        if (!data) { return; }
+        if (_pooled) {
+            BufferPool::getGlobal().deallocate(data, _bufferSize);
+        }
+        else {
             free(data);
         }
+    }
+
+    void ImageData::replaceData(uint8_t* newData, bool destroy, size_t bufferSize, bool pooled) {
+        if (destroy) {
+            releaseBuffer();
+        }
         data = newData;
+        _bufferSize = bufferSize;
+        _pooled = pooled;
     }
 
     void ImageData::clear(bool destroy) {
-        if (destroy && data) {
-            free(data);
+        if (destroy) {
+            releaseBuffer();
         }
         data = nullptr;
+        _bufferSize = 0;
+        _pooled = false;
         format = TextureFormat::Unknown;
         paletteSize = 0;
         width = 0;
@@ -565,27 +603,83 @@ namespace JCore {
         flags = 0;
     }
 
-    uint8_t calculateColorVariance(const ImageData& img, bool ignoreClear) {
-        if (!img.data) { return 0; }
-        const Color32* pixels = reinterpret_cast<const Color32*>(img.data);
+    bool hasAlpha(const ImageView& img) {
+        if (!img.isValid()) { return false; }
+        switch (img.format) {
+            default: return false;
+
+            case JCore::TextureFormat::RGBA32: {
+                for (int32_t y = 0; y < img.height; y++) {
+                    const uint8_t* row = img.getRow(y);
+                    for (size_t x = 0, j = 3; x < img.width; x++, j += 4) {
+                        if (row[j] < 0xFF) { return true; }
+                    }
+                }
+                return false;
+            }
+
+            case JCore::TextureFormat::RGBA4444: {
+                for (int32_t y = 0; y < img.height; y++) {
+                    const uint16_t* row = reinterpret_cast<const uint16_t*>(img.getRow(y));
+                    for (size_t x = 0; x < img.width; x++) {
+                        if ((row[x] & 0xF000) != 0xF000) { return true; }
+                    }
+                }
+                return false;
+            }
+
+            case JCore::TextureFormat::Indexed8:
+            case JCore::TextureFormat::Indexed16:
+                break;
+        }
+
+        const Color32* palette = img.palette;
+        if (!palette) { return false; }
+
+        bool alpha = false;
+        for (size_t i = 0; i < img.paletteSize; i++) {
+            if (palette[i].a < 0xFF) { alpha = true; break; }
+        }
+        if (!alpha) { return false; }
+
+        for (int32_t y = 0; y < img.height; y++) {
+            const uint8_t* row = img.getRow(y);
+            if (img.format == TextureFormat::Indexed8) {
+                for (size_t x = 0; x < img.width; x++) {
+                    if (palette[row[x]].a < 255) { return true; }
+                }
+                continue;
+            }
+
+            const uint16_t* row16 = reinterpret_cast<const uint16_t*>(row);
+            for (size_t x = 0; x < img.width; x++) {
+                if (palette[row16[x]].a < 255) { return true; }
+            }
+        }
+        return false;
+    }
+
+    uint8_t calculateColorVariance(const ImageView& img, bool ignoreClear) {
+        if (!img.isValid()) { return 0; }
+        const Color32* palette = img.palette;
+        if (img.isIndexed() && !palette) { return 0; }
 
-        size_t offset = img.paletteSize * 4;
-        std::function<bool(Color24&, int32_t)> formats[]{
+        std::function<bool(Color24&, const uint8_t*)> formats[]{
             {},
 
-            [&img](Color24& color, int32_t index) {
-                color.r = color.g = color.b = img.data[index];
+            [](Color24& color, const uint8_t* pix) {
+                color.r = color.g = color.b = pix[0];
                 return true;
             },
 
-            [&img](Color24& color, int32_t index) {
-                color = reinterpret_cast<const Color24*>(img.data)[index];
+            [](Color24& color, const uint8_t* pix) {
+                memcpy(&color, pix, sizeof(Color24));
                 return true;
             },
 
             //RGB48
-            [&img](Color24& color, int32_t index) {
-                const uint16_t* data = reinterpret_cast<const uint16_t*>(img.data) + index * 3;
+            [](Color24& color, const uint8_t* pix) {
+                const uint16_t* data = reinterpret_cast<const uint16_t*>(pix);
                 color.r = remapUI16ToUI8(data[0]);
                 color.g = remapUI16ToUI8(data[1]);
                 color.b = remapUI16ToUI8(data[2]);
@@ -593,16 +687,16 @@ namespace JCore {
             },
             
             
-            [&img, pixels, ignoreClear](Color24& color, int32_t index) {
-                const Color32& tmp = pixels[index];
+            [ignoreClear](Color24& color, const uint8_t* pix) {
+                const Color32& tmp = *reinterpret_cast<const Color32*>(pix);
                 if (tmp.a < 1 && ignoreClear) { return false; }
                 memcpy(&color, &tmp, sizeof(Color24));
                 return true;
             },
             
             //RGBA64
-            [&img, ignoreClear](Color24& color, int32_t index) {
-                 const uint16_t* data = reinterpret_cast<const uint16_t*>(img.data) + index * 4;
+            [ignoreClear](Color24& color, const uint8_t* pix) {
+                 const uint16_t* data = reinterpret_cast<const uint16_t*>(pix);
                  if (data[3] < 1 && ignoreClear) { return false; }
                  color.r = remapUI16ToUI8(data[0]);
                  color.g = remapUI16ToUI8(data[1]);
@@ -610,33 +704,146 @@ namespace JCore {
                  return true;
             },
             
-            [&img, pixels, ignoreClear](Color24& color, int32_t index) {
-                 auto& tmp = pixels[img.data[index + 1024]];
+            [palette, ignoreClear](Color24& color, const uint8_t* pix) {
+                 auto& tmp = palette[pix[0]];
                  if (tmp.a < 1 && ignoreClear) { return false; }
                  memcpy(&color, &tmp, sizeof(Color24));
                  return true;
             },
             
-            [&img, pixels, offset, ignoreClear](Color24& color, int32_t index) {
-                 auto& tmp = pixels[reinterpret_cast<const uint16_t*>(img.data + offset)[index]];;
+            [palette, ignoreClear](Color24& color, const uint8_t* pix) {
+                 auto& tmp = palette[*reinterpret_cast<const uint16_t*>(pix)];
                  if (tmp.a < 1 && ignoreClear) { return false; }
                  memcpy(&color, &tmp, sizeof(Color24));
                  return true;
             },
 
         };
+        if (img.format >= TextureFormat::RGBA4444) { return 0; }
+
         auto& func = formats[(int32_t)img.format];
         Color24 temp{};
 
-        size_t reso = img.width * img.height;
+        const int32_t bpp = img.getBytesPerPixel();
         std::unordered_set<Color24> colors{};
         size_t total = 0;
-        for (int32_t i = 0; i < reso; i++) {
-            if (func(temp, i)) {
-                colors.insert(temp);
-                total++;
+        for (int32_t y = 0; y < img.height; y++) {
+            const uint8_t* row = img.getRow(y);
+            for (int32_t x = 0; x < img.width; x++, row += bpp) {
+                if (func(temp, row)) {
+                    colors.insert(temp);
+                    total++;
+                }
             }
         }
         return total < 1 ? 0 : uint8_t((colors.size() / float(total)) * 255.0f);
     }
-}
\ No newline at end of file
+
+    static void colorToAlphaRun(Color32* pixels, size_t count, float r1, float r2, float r3, float mA, float mX) {
+        size_t i = 0;
+
+        // 4 pixels per iteration, the per pixel division is replaced by a reciprocal 
+        // estimate refined with one Newton-Raphson step which keeps results within 1 LSB.
+        const __m128 vByteToFloat = _mm_set1_ps(1.0f / 255.0f);
+        const __m128 vR1 = _mm_set1_ps(r1);
+        const __m128 vR2 = _mm_set1_ps(r2);
+        const __m128 vR3 = _mm_set1_ps(r3);
+        const __m128 vMA = _mm_set1_ps(mA);
+        const __m128 vMX = _mm_set1_ps(mX);
+        const __m128 vInvMX = _mm_set1_ps(1.0f / mX);
+        const __m128 vTDiff = _mm_set1_ps(mX - mA);
+        const __m128 vInvTDiff = _mm_set1_ps(1.0f / (mX - mA));
+        const __m128 vZero = _mm_setzero_ps();
+        const __m128 vOne = _mm_set1_ps(1.0f);
+        const __m128 vTwo = _mm_set1_ps(2.0f);
+        const __m128 v255 = _mm_set1_ps(255.0f);
+        const __m128 vAbs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128i vByte = _mm_set1_epi32(0xFF);
+        const __m128i vRGB = _mm_set1_epi32(0x00FFFFFF);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+
+            __m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(px, vByte)), vByteToFloat);
+            __m128 g = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 8), vByte)), vByteToFloat);
+            __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 16), vByte)), vByteToFloat);
+            __m128 a = _mm_cvtepi32_ps(_mm_srli_epi32(px, 24));
+
+            __m128 dR = _mm_sub_ps(r, vR1);
+            __m128 dG = _mm_sub_ps(g, vR2);
+            __m128 dB = _mm_sub_ps(b, vR3);
+            __m128 dist = _mm_max_ps(_mm_max_ps(_mm_and_ps(dR, vAbs), _mm_and_ps(dG, vAbs)), _mm_and_ps(dB, vAbs));
+
+            __m128 mClear = _mm_cmple_ps(dist, vMA);
+            __m128 mKeep = _mm_cmpge_ps(dist, vMX);
+            if (_mm_movemask_ps(_mm_andnot_ps(mClear, mKeep)) == 0xF) { continue; }
+
+            __m128 alpha = _mm_mul_ps(_mm_sub_ps(dist, vTDiff), vInvTDiff);
+            alpha = _mm_min_ps(_mm_max_ps(alpha, vZero), vOne);
+
+            __m128 oProp = _mm_mul_ps(dist, vInvMX);
+            __m128 rcp = _mm_rcp_ps(oProp);
+            rcp = _mm_mul_ps(rcp, _mm_sub_ps(vTwo, _mm_mul_ps(oProp, rcp)));
+
+            __m128 oR = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(dR, rcp), vR1), v255);
+            __m128 oG = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(dG, rcp), vR2), v255);
+            __m128 oB = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(dB, rcp), vR3), v255);
+            __m128 oA = _mm_mul_ps(a, alpha);
+
+            // Truncate and keep the low byte, same as the uint8_t casts in the scalar version
+            __m128i iR = _mm_and_si128(_mm_cvttps_epi32(oR), vByte);
+            __m128i iG = _mm_and_si128(_mm_cvttps_epi32(oG), vByte);
+            __m128i iB = _mm_and_si128(_mm_cvttps_epi32(oB), vByte);
+            __m128i iA = _mm_and_si128(_mm_cvttps_epi32(oA), vByte);
+
+            __m128i out = _mm_or_si128(
+                _mm_or_si128(iR, _mm_slli_epi32(iG, 8)),
+                _mm_or_si128(_mm_slli_epi32(iB, 16), _mm_slli_epi32(iA, 24)));
+
+            __m128i iKeep = _mm_castps_si128(mKeep);
+            __m128i iClear = _mm_castps_si128(mClear);
+            out = _mm_or_si128(_mm_and_si128(iKeep, px), _mm_andnot_si128(iKeep, out));
+            out = _mm_or_si128(_mm_and_si128(iClear, _mm_and_si128(px, vRGB)), _mm_andnot_si128(iClear, out));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), out);
+        }
+
+        for (; i < count; i++) {
+            colorToAlpha(pixels[i], r1, r2, r3, mA, mX);
+        }
+    }
+
+    bool colorToAlpha(const ImageView& img, Color32 key, float mA, float mX) {
+        if (!img.isValid()) { return false; }
+
+        const float r1 = key.r * UINT8_TO_FLOAT;
+        const float r2 = key.g * UINT8_TO_FLOAT;
+        const float r3 = key.b * UINT8_TO_FLOAT;
+
+        switch (img.format) {
+            default:
+                JCORE_WARN("[J-Core - ImageUtils] Warning: Color to alpha isn't supported for format '{0}'!", getTextureFormatName(img.format));
+                return false;
+            case TextureFormat::Indexed8:
+            case TextureFormat::Indexed16:
+                if (!img.palette) { return false; }
+                colorToAlphaRun(img.palette, size_t(img.paletteSize), r1, r2, r3, mA, mX);
+                return true;
+            case TextureFormat::RGBA32:
+                break;
+        }
+
+        static constexpr size_t MIN_BAND_ROWS = 64;
+        Parallel::forRange(size_t(img.height), MIN_BAND_ROWS, [&img, r1, r2, r3, mA, mX](size_t begin, size_t end) {
+            if (img.isContiguous()) {
+                Color32* pixels = reinterpret_cast<Color32*>(img.getRow(int32_t(begin)));
+                colorToAlphaRun(pixels, (end - begin) * img.width, r1, r2, r3, mA, mX);
+                return;
+            }
+
+            for (size_t y = begin; y < end; y++) {
+                colorToAlphaRun(reinterpret_cast<Color32*>(img.getRow(int32_t(y))), size_t(img.width), r1, r2, r3, mA, mX);
+            }
+        });
+        return true;
+    }
+}
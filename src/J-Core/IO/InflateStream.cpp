@@ -0,0 +1,172 @@
+#include <J-Core/IO/InflateStream.h>
+#include <J-Core/IO/ZLib.h>
+#include <J-Core/Util/BufferPool.h>
+#include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
+
+using namespace JCore;
+
+InflateStream::InflateStream(const Stream& stream, const size_t length, const size_t bufferSize) :
+    Stream(READ_FLAG, length), _stream(stream), _streamStart(stream.tell()), _zStream(), _initialized(false), _finished(false), _failed(false),
+    _buffer(nullptr), _bufferSize(bufferSize < 64 ? 64 : bufferSize), _bufferCapacity(0) {
+
+    _buffer = BufferPool::getGlobal().allocate(_bufferSize, _bufferCapacity);
+    if (!_buffer) {
+        JCORE_ERROR("[J-Core - InflateStream] Error: Failed to allocate buffer! ({0} bytes)", _bufferSize);
+        return;
+    }
+
+    const int32_t ret = inflateInit(&_zStream);
+    if (ret != Z_OK) {
+        JCORE_ERROR("[J-Core - InflateStream] Error: Failed to initialize inflate! ({0})", ZLib::zerr(ret));
+        return;
+    }
+    _initialized = true;
+}
+
+InflateStream::~InflateStream() {
+    if (_initialized) {
+        inflateEnd(&_zStream);
+    }
+
+    if (_buffer) {
+        BufferPool::getGlobal().deallocate(_buffer, _bufferCapacity);
+    }
+}
+
+size_t InflateStream::read(void* buffer, size_t elementSize, size_t count, const bool bigEndian) const {
+    if (!canRead() || isEOF()) { return 0; }
+
+    uint8_t* output = reinterpret_cast<uint8_t*>(buffer);
+    const size_t bRead = inflateOutput(output, Math::min(elementSize * count, _length - _position));
+    _position += bRead;
+    if (_finished) {
+        _length = _position;
+    }
+
+    if (bigEndian && elementSize > 1) {
+        Data::reverseEndianess(output, elementSize, bRead / elementSize);
+    }
+    return bRead;
+}
+
+bool InflateStream::close() const {
+    if (_initialized) {
+        inflateEnd(&_zStream);
+        _initialized = false;
+    }
+    _position = 0;
+    _length = 0;
+    return _stream.close();
+}
+
+size_t InflateStream::seek(int64_t offset, int origin) const {
+    if (!_initialized) { return _position; }
+
+    size_t target = _position;
+    switch (origin) {
+        case SEEK_SET: target = offset < 0 ? 0 : size_t(offset); break;
+        case SEEK_CUR: target = offset < 0 && size_t(-offset) > _position ? 0 : _position + offset; break;
+        case SEEK_END:
+            //The end isn't known until everything has been inflated once
+            if (_length == UNKNOWN_LENGTH) {
+                seek(INT64_MAX, SEEK_SET);
+            }
+            target = offset < 0 || size_t(offset) > _length ? (offset < 0 ? _length : 0) : _length - offset;
+            break;
+    }
+
+    if (target < _position && !restart()) { return _position; }
+
+    uint8_t temp[16384];
+    while (_position < target && canRead() && !isEOF()) {
+        const size_t bRead = inflateOutput(temp, Math::min(sizeof(temp), target - _position));
+        if (bRead < 1) { break; }
+        _position += bRead;
+    }
+
+    if (_finished) {
+        _length = _position;
+    }
+    return _position;
+}
+
+size_t InflateStream::inflateOutput(uint8_t* output, const size_t size) const {
+    size_t done = 0;
+    while (done < size && !_finished && !_failed) {
+        if (_zStream.avail_in == 0 && !refill()) {
+            JCORE_ERROR("[J-Core - InflateStream] Error: Compressed data ended before the end of the stream!");
+            _failed = true;
+            break;
+        }
+
+        const uInt slice = uInt(Math::min<size_t>(size - done, UINT32_MAX));
+        const uInt inBefore = _zStream.avail_in;
+        _zStream.next_out = output + done;
+        _zStream.avail_out = slice;
+
+        const int32_t ret = inflate(&_zStream, Z_NO_FLUSH);
+        const size_t produced = slice - _zStream.avail_out;
+        done += produced;
+
+        switch (ret) {
+            case Z_STREAM_END:
+                //Whatever is left in the input belongs to whatever follows the compressed data in the wrapped stream
+                _finished = true;
+                if (_zStream.avail_in > 0) {
+                    _stream.seek(-int64_t(_zStream.avail_in), SEEK_CUR);
+                    _zStream.avail_in = 0;
+                }
+                break;
+            case Z_NEED_DICT:
+            case Z_DATA_ERROR:
+            case Z_MEM_ERROR:
+            case Z_STREAM_ERROR:
+                JCORE_ERROR("[J-Core - InflateStream] Error: Inflate failed! ({0})", ZLib::zerr(ret == Z_NEED_DICT ? Z_DATA_ERROR : ret));
+                _failed = true;
+                break;
+            default:
+                if (produced < 1 && inBefore == _zStream.avail_in && inBefore > 0) {
+                    JCORE_ERROR("[J-Core - InflateStream] Error: Inflate made no progress!");
+                    _failed = true;
+                }
+                break;
+        }
+    }
+    return done;
+}
+
+bool InflateStream::refill() const {
+    //Memory backed streams hand over the compressed bytes directly, no copy into the buffer
+    const size_t position = _stream.tell();
+    const size_t left = _stream.size() > position ? _stream.size() - position : 0;
+    if (left > 0) {
+        const size_t viewSize = Math::min<size_t>(left, UINT32_MAX);
+        if (const uint8_t* view = _stream.tryGetView(viewSize)) {
+            _zStream.next_in = const_cast<uint8_t*>(view);
+            _zStream.avail_in = uInt(viewSize);
+            return true;
+        }
+    }
+
+    const size_t bRead = _stream.read(_buffer, 1, _bufferSize, false);
+    if (bRead < 1) { return false; }
+
+    _zStream.next_in = _buffer;
+    _zStream.avail_in = uInt(bRead);
+    return true;
+}
+
+bool InflateStream::restart() const {
+    if (inflateReset(&_zStream) != Z_OK) {
+        _failed = true;
+        return false;
+    }
+
+    _stream.seek(_streamStart, SEEK_SET);
+    _zStream.avail_in = 0;
+    _finished = false;
+    _failed = false;
+    _position = 0;
+    return true;
+}
@@ -0,0 +1,484 @@
+#include <J-Core/IO/JPak.h>
+#include <J-Core/IO/FileStream.h>
+#include <J-Core/IO/DeflateStream.h>
+#include <J-Core/Util/Parallel.h>
+#include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
+#include <algorithm>
+#include <atomic>
+
+namespace JCore {
+    namespace {
+        //Files are packed in batches so only this much source data/compressed output is held at once
+        constexpr size_t PACK_BATCH_BYTES = 256 * 1024 * 1024;
+        constexpr size_t PACK_BATCH_FILES = 256;
+        //Anything smaller isn't worth the inflate setup when read
+        constexpr size_t PACK_MIN_DEFLATE = 256;
+
+        constexpr size_t MAX_BUCKET_BITS = 20;
+
+        struct PackItem {
+            fs::path path{};
+            std::string name{};
+            uint64_t fileSize{ 0 };
+            JPak::Entry entry{};
+
+            MappedFileStream source{};
+            std::unique_ptr<MemoryStream> compressed{};
+            //Either the mapped file or the compressed buffer, whichever ends up in the archive
+            const uint8_t* stored{ nullptr };
+        };
+
+        //zlib's crc32 is used over Data::updateCRC since the packer computes these from several threads at once
+        uint32_t crcOf(uint32_t crc, const uint8_t* data, size_t size) {
+            while (size > 0) {
+                const uInt slice = uInt(Math::min<size_t>(size, UINT32_MAX));
+                crc = uint32_t(crc32(crc, data, slice));
+                data += slice;
+                size -= slice;
+            }
+            return crc;
+        }
+
+        bool writePadding(const Stream& stream, const size_t alignment) {
+            static const uint8_t ZEROS[JPak::ALIGNMENT]{ 0 };
+            const size_t padding = (alignment - (stream.tell() % alignment)) % alignment;
+            return stream.write(ZEROS, 1, padding, false) == padding;
+        }
+
+        void prepareEntry(PackItem& item, const JPak::PackParams& params) {
+            JPak::Entry& entry = item.entry;
+            const uint8_t* data = item.source.getData();
+            const size_t rawSize = item.source.size();
+
+            entry.rawSize = rawSize;
+            entry.size = rawSize;
+            entry.flags = JPak::ENTRY_None;
+            item.stored = data;
+
+            if (params.compression != 0 && rawSize >= PACK_MIN_DEFLATE) {
+                item.compressed = std::make_unique<MemoryStream>(rawSize / 2 + 64, true);
+                {
+                    DeflateStream deflate(*item.compressed, params.compression);
+                    deflate.write(data, 1, rawSize, false);
+                    deflate.finish();
+                }
+
+                const size_t packed = item.compressed->size();
+                if (packed > 0 && double(packed) <= double(rawSize) * params.maxRatio) {
+                    entry.size = packed;
+                    entry.flags |= JPak::ENTRY_Deflated;
+                    item.compressed->seek(0, SEEK_SET);
+                    item.stored = item.compressed->tryGetView(packed);
+                }
+                else {
+                    item.compressed.reset();
+                }
+            }
+            entry.crc = crcOf(0, item.stored, size_t(entry.size));
+        }
+    }
+
+    JPak::JPak() : _file(), _entries(nullptr), _entryCount(0), _paths(nullptr), _pathsSize(0), _buckets(), _bucketShift(0) {}
+    JPak::JPak(std::string_view path) : JPak() {
+        mount(path);
+    }
+    JPak::~JPak() {
+        unmount();
+    }
+
+    bool JPak::mount(std::string_view path) {
+        unmount();
+
+        if (!_file.open(path, MappedFileStream::AccessHint::Normal)) {
+            JCORE_ERROR("[J-Core - JPak] Error: Failed to open archive '{0}'!", path);
+            return false;
+        }
+
+        const uint8_t* data = _file.getData();
+        const size_t length = _file.size();
+
+        Header header{};
+        if (!data || length < sizeof(Header)) {
+            JCORE_ERROR("[J-Core - JPak] Error: '{0}' is too small to be an archive!", path);
+            unmount();
+            return false;
+        }
+        memcpy(&header, data, sizeof(Header));
+
+        if (header.signature != SIGNATURE) {
+            JCORE_ERROR("[J-Core - JPak] Error: '{0}' is not a JPAK archive!", path);
+            unmount();
+            return false;
+        }
+
+        if (header.version != VERSION) {
+            JCORE_ERROR("[J-Core - JPak] Error: Unsupported archive version {0} in '{1}'!", header.version, path);
+            unmount();
+            return false;
+        }
+
+        const uint64_t indexSize = uint64_t(header.entryCount) * sizeof(Entry);
+        if (header.indexOffset > length || indexSize > length - header.indexOffset ||
+            header.pathsOffset > length || header.pathsSize > length - header.pathsOffset) {
+            JCORE_ERROR("[J-Core - JPak] Error: Index of '{0}' is out of bounds!", path);
+            unmount();
+            return false;
+        }
+
+        uint32_t crc = crcOf(0, data + header.indexOffset, size_t(indexSize));
+        crc = crcOf(crc, data + header.pathsOffset, size_t(header.pathsSize));
+        if (crc != header.indexCrc) {
+            JCORE_ERROR("[J-Core - JPak] Error: Index CRC mismatch in '{0}'! ({1:#010x} != {2:#010x})", path, crc, header.indexCrc);
+            unmount();
+            return false;
+        }
+
+        const Entry* entries = reinterpret_cast<const Entry*>(data + header.indexOffset);
+        const size_t count = header.entryCount;
+        for (size_t i = 0; i < count; i++) {
+            const Entry& entry = entries[i];
+            const bool inBounds = entry.offset <= length && entry.size <= length - entry.offset &&
+                uint64_t(entry.pathOffset) + entry.pathLength <= header.pathsSize;
+            if (!inBounds || (i > 0 && entries[i - 1].hash >= entry.hash)) {
+                JCORE_ERROR("[J-Core - JPak] Error: Entry #{0} of '{1}' is corrupted!", i, path);
+                unmount();
+                return false;
+            }
+        }
+
+        //Bucket on the top bits of the hash, the hashes are uniform so each bucket holds about one entry
+        uint32_t bits = 1;
+        while (bits < MAX_BUCKET_BITS && (size_t(1) << bits) < count) {
+            bits++;
+        }
+
+        const size_t bucketCount = size_t(1) << bits;
+        _bucketShift = 64 - bits;
+        _buckets.resize(bucketCount + 1);
+
+        size_t current = 0;
+        for (size_t i = 0; i < bucketCount; i++) {
+            while (current < count && (entries[current].hash >> _bucketShift) < i) {
+                current++;
+            }
+            _buckets[i] = uint32_t(current);
+        }
+        _buckets[bucketCount] = uint32_t(count);
+
+        _entries = entries;
+        _entryCount = count;
+        _paths = reinterpret_cast<const char*>(data + header.pathsOffset);
+        _pathsSize = size_t(header.pathsSize);
+        return true;
+    }
+
+    void JPak::unmount() {
+        _file.close();
+        _entries = nullptr;
+        _entryCount = 0;
+        _paths = nullptr;
+        _pathsSize = 0;
+        _buckets.clear();
+        _bucketShift = 0;
+    }
+
+    std::string_view JPak::getEntryPath(const Entry& entry) const {
+        if (!isMounted()) { return std::string_view(); }
+        return std::string_view(_paths + entry.pathOffset, entry.pathLength);
+    }
+
+    const JPak::Entry* JPak::find(std::string_view path) const {
+        return find(hashPath(path));
+    }
+
+    const JPak::Entry* JPak::find(StringId id) const {
+        if (!isMounted() || !id.isValid()) { return nullptr; }
+
+        const uint64_t hash = id.getHash();
+        const size_t bucket = size_t(hash >> _bucketShift);
+        for (size_t i = _buckets[bucket], end = _buckets[bucket + 1]; i < end; i++) {
+            const uint64_t current = _entries[i].hash;
+            if (current == hash) { return _entries + i; }
+            if (current > hash) { break; }
+        }
+        return nullptr;
+    }
+
+    const uint8_t* JPak::getStoredData(const Entry& entry) const {
+        if (!isMounted()) { return nullptr; }
+        return _file.getData() + entry.offset;
+    }
+
+    bool JPak::verify(const Entry& entry) const {
+        const uint8_t* data = getStoredData(entry);
+        return data && crcOf(0, data, size_t(entry.size)) == entry.crc;
+    }
+
+    StringId JPak::hashPath(std::string_view path) {
+        //Same FNV-1a as StringId, just normalized on the fly so lookups don't allocate
+        while (path.length() > 0) {
+            if (path[0] == '/' || path[0] == '\\') {
+                path.remove_prefix(1);
+                continue;
+            }
+
+            if (path.length() > 1 && path[0] == '.' && (path[1] == '/' || path[1] == '\\')) {
+                path.remove_prefix(2);
+                continue;
+            }
+            break;
+        }
+
+        if (path.length() < 1) { return StringId(); }
+
+        uint64_t hash = StringId::FNV_OFFSET;
+        for (char ch : path) {
+            ch = ch == '\\' ? '/' : ch;
+            ch = ch >= 'A' && ch <= 'Z' ? char(ch + ('a' - 'A')) : ch;
+            hash = (hash ^ uint8_t(ch)) * StringId::FNV_PRIME;
+        }
+
+        return StringId::fromHash(hash ? hash : 1);
+    }
+
+    bool JPak::pack(const fs::path& directory, const fs::path& output) {
+        return pack(directory, output, PackParams{});
+    }
+
+    bool JPak::pack(const fs::path& directory, const fs::path& output, const PackParams& params) {
+        if (!fs::is_directory(directory)) {
+            JCORE_ERROR("[J-Core - JPak] Error: '{0}' is not a directory!", directory.string());
+            return false;
+        }
+
+        //Entries end up sorted by hash, so the order files are found in doesn't matter
+        IO::WalkParams walkParams{};
+        walkParams.flags = IO::F_TYPE_FILE;
+        walkParams.recursive = params.recursive;
+        walkParams.check = params.check;
+
+        std::vector<fs::path> files{};
+        if (!IO::walk(directory, walkParams, files)) {
+            JCORE_ERROR("[J-Core - JPak] Error: No files found in '{0}'!", directory.string());
+            return false;
+        }
+
+        if (files.size() > UINT32_MAX) {
+            JCORE_ERROR("[J-Core - JPak] Error: Too many files in '{0}'! ({1})", directory.string(), files.size());
+            return false;
+        }
+
+        const size_t count = files.size();
+        std::unique_ptr<PackItem[]> items = std::make_unique<PackItem[]>(count);
+        std::vector<uint32_t> order(count);
+        size_t pathsSize = 0;
+        for (size_t i = 0; i < count; i++) {
+            PackItem& item = items[i];
+            std::error_code err{};
+            item.path = std::move(files[i]);
+            item.name = item.path.lexically_relative(directory).generic_string();
+            item.fileSize = fs::file_size(item.path, err);
+            item.entry.hash = hashPath(item.name).getHash();
+            item.entry.pathOffset = uint32_t(pathsSize);
+            item.entry.pathLength = uint32_t(item.name.length());
+            pathsSize += item.name.length();
+            order[i] = uint32_t(i);
+        }
+
+        if (pathsSize > UINT32_MAX) {
+            JCORE_ERROR("[J-Core - JPak] Error: Path table of '{0}' is too large! ({1} bytes)", directory.string(), pathsSize);
+            return false;
+        }
+
+        //Data is laid out in index order so reading entries in hash order walks the file forward
+        std::sort(order.begin(), order.end(), [&items](uint32_t a, uint32_t b) { return items[a].entry.hash < items[b].entry.hash; });
+        for (size_t i = 1; i < count; i++) {
+            const PackItem& prev = items[order[i - 1]];
+            const PackItem& item = items[order[i]];
+            if (prev.entry.hash == item.entry.hash) {
+                JCORE_ERROR("[J-Core - JPak] Error: Paths '{0}' and '{1}' have the same hash!", prev.name, item.name);
+                return false;
+            }
+        }
+
+        FileStream stream(output.string(), "wb");
+        if (!stream.isOpen()) {
+            JCORE_ERROR("[J-Core - JPak] Error: Failed to open '{0}' for writing!", output.string());
+            return false;
+        }
+
+        //Written again once the index is done, for now it just reserves the space
+        Header header{};
+        header.entryCount = uint32_t(count);
+        if (stream.write(&header, sizeof(Header), 1, false) != sizeof(Header) || !writePadding(stream, ALIGNMENT)) {
+            JCORE_ERROR("[J-Core - JPak] Error: Failed to write header to '{0}'!", output.string());
+            return false;
+        }
+
+        for (size_t begin = 0; begin < count;) {
+            size_t end = begin;
+            for (size_t bytes = 0; end < count && end - begin < PACK_BATCH_FILES && (end == begin || bytes + items[order[end]].fileSize <= PACK_BATCH_BYTES); end++) {
+                bytes += items[order[end]].fileSize;
+            }
+
+            std::atomic<bool> failed{ false };
+            Parallel::forEach(end - begin, [&](size_t i) {
+                PackItem& item = items[order[begin + i]];
+                if (!item.source.open(item.path.string(), MappedFileStream::AccessHint::Sequential)) {
+                    JCORE_ERROR("[J-Core - JPak] Error: Failed to open '{0}'!", item.path.string());
+                    failed = true;
+                    return;
+                }
+                prepareEntry(item, params);
+            });
+
+            if (failed) { return false; }
+
+            //Written out on this thread in order, entries start on ALIGNMENT boundaries so they map/read in whole pages
+            for (size_t i = begin; i < end; i++) {
+                PackItem& item = items[order[i]];
+                const size_t size = size_t(item.entry.size);
+                const bool padded = writePadding(stream, ALIGNMENT);
+                item.entry.offset = stream.tell();
+                if (!padded || (size > 0 && stream.write(item.stored, 1, size, false) != size)) {
+                    JCORE_ERROR("[J-Core - JPak] Error: Failed to write '{0}' to '{1}'!", item.name, output.string());
+                    return false;
+                }
+
+                item.source.close();
+                item.compressed.reset();
+                item.stored = nullptr;
+            }
+            begin = end;
+        }
+
+        writePadding(stream, alignof(uint64_t));
+        header.indexOffset = stream.tell();
+
+        uint32_t crc = 0;
+        for (size_t i = 0; i < count; i++) {
+            const Entry& entry = items[order[i]].entry;
+            crc = crcOf(crc, reinterpret_cast<const uint8_t*>(&entry), sizeof(Entry));
+            stream.write(&entry, sizeof(Entry), 1, false);
+        }
+
+        header.pathsOffset = stream.tell();
+        header.pathsSize = pathsSize;
+        for (size_t i = 0; i < count; i++) {
+            const std::string& name = items[i].name;
+            crc = crcOf(crc, reinterpret_cast<const uint8_t*>(name.data()), name.length());
+            stream.write(name.data(), 1, name.length(), false);
+        }
+        header.indexCrc = crc;
+
+        if (stream.tell() != header.pathsOffset + pathsSize) {
+            JCORE_ERROR("[J-Core - JPak] Error: Failed to write index to '{0}'!", output.string());
+            return false;
+        }
+
+        stream.seek(0, SEEK_SET);
+        if (stream.write(&header, sizeof(Header), 1, false) != sizeof(Header)) {
+            JCORE_ERROR("[J-Core - JPak] Error: Failed to write header to '{0}'!", output.string());
+            return false;
+        }
+        return stream.flush();
+    }
+
+    JPakStream::JPakStream() : Stream(READ_FLAG), _data(nullptr), _isOpen(false), _source(), _inflate() {}
+    JPakStream::JPakStream(const JPak& pak, std::string_view path) : JPakStream() {
+        open(pak, path);
+    }
+    JPakStream::JPakStream(const JPak& pak, const JPak::Entry& entry) : JPakStream() {
+        open(pak, entry);
+    }
+    JPakStream::~JPakStream() {
+        close();
+    }
+
+    bool JPakStream::open(const JPak& pak, std::string_view path) const {
+        const JPak::Entry* entry = pak.find(path);
+        if (!entry) {
+            close();
+            return false;
+        }
+        return open(pak, *entry);
+    }
+
+    bool JPakStream::open(const JPak& pak, const JPak::Entry& entry) const {
+        close();
+
+        const uint8_t* data = pak.getStoredData(entry);
+        if (!data) { return false; }
+
+        if (entry.isDeflated()) {
+            //Input always comes from the mapping through tryGetView, the inflate buffer is never used
+            _source = std::make_unique<MemoryStream>(data, size_t(entry.size), size_t(entry.size));
+            _inflate = std::make_unique<InflateStream>(*_source, size_t(entry.rawSize), 64);
+            if (!_inflate->canRead()) {
+                close();
+                return false;
+            }
+        }
+
+        _data = data;
+        _position = 0;
+        _length = size_t(entry.rawSize);
+        _isOpen = true;
+        return true;
+    }
+
+    size_t JPakStream::read(void* buffer, size_t elementSize, size_t count, const bool bigEndian) const {
+        if (!canRead()) { return 0; }
+        if (_inflate) {
+            //Mirrored so the base helpers (readLine, copyTo...) see the inflater's position
+            const size_t bRead = _inflate->read(buffer, elementSize, count, bigEndian);
+            _position = _inflate->tell();
+            return bRead;
+        }
+
+        const size_t size = Math::min(elementSize * count, _length - _position);
+        if (size < 1) { return 0; }
+
+        memcpy(buffer, _data + _position, size);
+        if (bigEndian && elementSize > 1) {
+            Data::reverseEndianess(reinterpret_cast<uint8_t*>(buffer), elementSize, size / elementSize);
+        }
+        _position += size;
+        return size;
+    }
+
+    bool JPakStream::close() const {
+        const bool wasOpen = _isOpen;
+        _inflate.reset();
+        _source.reset();
+        _data = nullptr;
+        _isOpen = false;
+        _position = 0;
+        _length = 0;
+        return wasOpen;
+    }
+
+    size_t JPakStream::seek(int64_t offset, int origin) const {
+        if (!_isOpen) { return 0; }
+        if (_inflate) {
+            _position = _inflate->seek(offset, origin);
+            return _position;
+        }
+
+        switch (origin) {
+            case SEEK_SET: _position = offset < 0 ? 0 : Math::min(size_t(offset), _length); break;
+            case SEEK_CUR: _position = offset < 0 && size_t(-offset) > _position ? 0 : Math::min(_position + offset, _length); break;
+            case SEEK_END: _position = offset < 0 || size_t(offset) > _length ? (offset < 0 ? _length : 0) : _length - offset; break;
+        }
+        return _position;
+    }
+
+    const uint8_t* JPakStream::tryGetView(const size_t size) const {
+        if (!_isOpen || _inflate || size > _length - _position) { return nullptr; }
+
+        const uint8_t* view = _data + _position;
+        _position += size;
+        return view;
+    }
+}
@@ -0,0 +1,183 @@
+#include <J-Core/IO/MappedFileStream.h>
+#include <J-Core/Log.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFileStream::MappedFileStream() : Stream(READ_FLAG), _filepath(), _data(nullptr), _isOpen(false), _file(INVALID_HANDLE_VALUE), _mapping(nullptr) {}
+#else
+MappedFileStream::MappedFileStream() : Stream(READ_FLAG), _filepath(), _data(nullptr), _isOpen(false), _file(-1) {}
+#endif
+
+MappedFileStream::MappedFileStream(std::string_view filepath, AccessHint hint) : MappedFileStream() {
+    open(filepath, hint);
+}
+
+MappedFileStream::~MappedFileStream() { close(); }
+
+bool MappedFileStream::open(std::string_view filepath, AccessHint hint) const {
+    if (isOpen()) { return false; }
+
+    _filepath.assign(filepath.data(), filepath.length());
+    _position = 0;
+    _length = 0;
+    _capacity = 0;
+
+#ifdef _WIN32
+    int32_t len = MultiByteToWideChar(CP_UTF8, 0, _filepath.c_str(), -1, NULL, 0);
+    wchar_t* widePath = reinterpret_cast<wchar_t*>(_malloca(len * sizeof(wchar_t)));
+    if (!widePath) { return false; }
+    MultiByteToWideChar(CP_UTF8, 0, _filepath.c_str(), -1, widePath, len);
+
+    const DWORD fileFlags = hint == AccessHint::Random ? FILE_FLAG_RANDOM_ACCESS : hint == AccessHint::Normal ? FILE_ATTRIBUTE_NORMAL : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE file = CreateFileW(widePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, fileFlags, NULL);
+    _freea(widePath);
+
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    _file = file;
+    _length = size_t(fileSize.QuadPart);
+    _capacity = _length;
+    _isOpen = true;
+
+    //Empty files can't be mapped, they're still valid streams though
+    if (_length < 1) { return true; }
+
+    _mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    _data = _mapping ? reinterpret_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!_data) {
+        JCORE_ERROR("[J-Core - MappedFileStream] Error: Failed to map '{0}' ({1})!", _filepath, GetLastError());
+        close();
+        return false;
+    }
+
+    if (hint == AccessHint::WillNeed) {
+        WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(_data), _length };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+    return true;
+#else
+    const int file = ::open(_filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) { return false; }
+
+    struct stat info {};
+    if (fstat(file, &info) != 0) {
+        ::close(file);
+        return false;
+    }
+
+    _file = file;
+    _length = size_t(info.st_size);
+    _capacity = _length;
+    _isOpen = true;
+
+    //Empty files can't be mapped, they're still valid streams though
+    if (_length < 1) { return true; }
+
+    void* mapped = mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, file, 0);
+    if (mapped == MAP_FAILED) {
+        JCORE_ERROR("[J-Core - MappedFileStream] Error: Failed to map '{0}' ({1})!", _filepath, errno);
+        close();
+        return false;
+    }
+    _data = reinterpret_cast<const uint8_t*>(mapped);
+
+    switch (hint) {
+        case AccessHint::Sequential: madvise(mapped, _length, MADV_SEQUENTIAL); break;
+        case AccessHint::Random:     madvise(mapped, _length, MADV_RANDOM); break;
+        case AccessHint::WillNeed:
+            madvise(mapped, _length, MADV_SEQUENTIAL);
+            madvise(mapped, _length, MADV_WILLNEED);
+            break;
+        default: break;
+    }
+    return true;
+#endif
+}
+
+bool MappedFileStream::close() const {
+    const bool wasOpen = _isOpen;
+
+#ifdef _WIN32
+    if (_data) { UnmapViewOfFile(_data); }
+    if (_mapping) { CloseHandle(_mapping); }
+    if (_file != INVALID_HANDLE_VALUE) { CloseHandle(_file); }
+    _mapping = nullptr;
+    _file = INVALID_HANDLE_VALUE;
+#else
+    if (_data) { munmap(const_cast<uint8_t*>(_data), _length); }
+    if (_file >= 0) { ::close(_file); }
+    _file = -1;
+#endif
+
+    _data = nullptr;
+    _isOpen = false;
+    _position = 0;
+    _length = 0;
+    _capacity = 0;
+    return wasOpen;
+}
+
+size_t MappedFileStream::read(void* buffer, size_t elementSize, size_t count, const bool bigEndian) const {
+    if (!canRead() || _position >= _length) { return 0; }
+
+    //Only whole elements are read, like fread
+    const size_t available = elementSize > 0 ? (_length - _position) / elementSize : 0;
+    count = count > available ? available : count;
+    const size_t size = count * elementSize;
+    memcpy(buffer, _data + _position, size);
+    _position += size;
+
+    if (bigEndian) {
+        JCore::Data::reverseEndianess(reinterpret_cast<uint8_t*>(buffer), elementSize, count);
+    }
+    return size;
+}
+
+size_t MappedFileStream::seek(int64_t offset, int origin) const {
+    if (!isOpen()) { return _position; }
+
+    switch (origin) {
+        case SEEK_SET: _position = offset < 0 ? 0 : size_t(offset); break;
+        case SEEK_CUR: _position = offset < 0 && size_t(-offset) > _position ? 0 : _position + offset; break;
+        case SEEK_END: _position = offset < 0 || size_t(offset) > _length ? (offset < 0 ? _length : 0) : _length - offset; break;
+    }
+    _position = _position > _length ? _length : _position;
+    return _position;
+}
+
+const uint8_t* MappedFileStream::tryGetView(const size_t size) const {
+    if (!_data || size > _length - _position) { return nullptr; }
+
+    const uint8_t* view = _data + _position;
+    _position += size;
+    return view;
+}
+
+void MappedFileStream::adviseReadAhead(const size_t offset, const size_t length) const {
+    if (!_data || offset >= _length) { return; }
+    const size_t size = length > _length - offset ? _length - offset : length;
+
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(_data + offset), size };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    //madvise wants a page aligned start
+    const size_t pageMask = size_t(sysconf(_SC_PAGESIZE)) - 1;
+    const size_t start = offset & ~pageMask;
+    madvise(const_cast<uint8_t*>(_data + start), size + (offset - start), MADV_WILLNEED);
+#endif
+}
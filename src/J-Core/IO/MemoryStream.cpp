@@ -27,6 +27,14 @@ size_t MemoryStream::read(void* buffer, size_t elementSize, size_t count, const
     return size;
 }
 
+const uint8_t* MemoryStream::tryGetView(const size_t size) const {
+    if (!canRead() || _position > _length || size > _length - _position) { return nullptr; }
+
+    const uint8_t* view = _cBuffer + _position;
+    _position += size;
+    return view;
+}
+
 size_t MemoryStream::write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian) const {
     if (!canWrite()) { return 0; }
 
@@ -39,6 +47,7 @@ size_t MemoryStream::write(const void* buffer, const size_t elementSize, const s
         JCore::Data::reverseEndianess(_buffer + _position, elementSize, count);
     }
     _position += size;
+    _length = _position > _length ? _position : _length;
     return size;
 }
 
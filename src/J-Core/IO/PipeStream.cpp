@@ -0,0 +1,267 @@
+#include <J-Core/IO/PipeStream.h>
+#include <J-Core/Util/BufferPool.h>
+#include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
+#include <thread>
+
+using namespace JCore;
+
+static constexpr uint32_t SPIN_COUNT = 256;
+
+PipeStream::PipeStream(const size_t capacity, const WaitMode mode) :
+    Stream(READ_FLAG | WRITE_FLAG), _buffer(nullptr), _bufferCapacity(0), _mask(0), _mode(mode),
+    _head(0), _tail(0), _writeClosed(false), _readClosed(false), _sleepers(0), _mutex(), _cv() {
+
+    //Power of two so positions can keep counting up & wrap with a mask
+    size_t ringSize = 64;
+    while (ringSize < capacity) {
+        ringSize <<= 1;
+    }
+
+    _buffer = BufferPool::getGlobal().allocate(ringSize, _bufferCapacity);
+    if (!_buffer) {
+        JCORE_ERROR("[J-Core - PipeStream] Error: Failed to allocate ring buffer! ({0} bytes)", ringSize);
+        return;
+    }
+    _capacity = ringSize;
+    _mask = ringSize - 1;
+}
+
+PipeStream::~PipeStream() {
+    if (_buffer) {
+        BufferPool::getGlobal().deallocate(_buffer, _bufferCapacity);
+    }
+}
+
+bool PipeStream::isEOF() const {
+    //Head is final once the close is seen
+    return isWriteClosed() && tell() >= size();
+}
+
+size_t PipeStream::read(void* buffer, size_t elementSize, size_t count, const bool bigEndian) const {
+    if (!canRead()) { return 0; }
+
+    uint8_t* output = reinterpret_cast<uint8_t*>(buffer);
+    const size_t bRead = readRaw(output, elementSize * count, true);
+    if (bigEndian && elementSize > 1) {
+        Data::reverseEndianess(output, elementSize, bRead / elementSize);
+    }
+    return bRead;
+}
+
+size_t PipeStream::write(const void* buffer, const size_t elementSize, const size_t count, const bool bigEndian) const {
+    if (!canWrite()) { return 0; }
+
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(buffer);
+    if (!bigEndian || elementSize < 2) {
+        return writeRaw(input, elementSize * count, true);
+    }
+
+    //The source is const, swap through a small buffer so elements never straddle the ring's wrap point mid-swap
+    uint8_t temp[4096];
+    const size_t perBatch = Math::max<size_t>(sizeof(temp) / elementSize, 1);
+    size_t written = 0;
+    for (size_t i = 0; i < count; i += perBatch) {
+        const size_t batch = Math::min(count - i, perBatch);
+        memcpy(temp, input + i * elementSize, batch * elementSize);
+        Data::reverseEndianess(temp, elementSize, batch);
+
+        const size_t bWritten = writeRaw(temp, batch * elementSize, true);
+        written += bWritten;
+        if (bWritten < batch * elementSize) { break; }
+    }
+    return written;
+}
+
+size_t PipeStream::tryRead(void* buffer, const size_t size) const {
+    return canRead() ? readRaw(reinterpret_cast<uint8_t*>(buffer), size, false) : 0;
+}
+
+size_t PipeStream::tryWrite(const void* buffer, const size_t size) const {
+    return canWrite() ? writeRaw(reinterpret_cast<const uint8_t*>(buffer), size, false) : 0;
+}
+
+bool PipeStream::close() const {
+    if (!_buffer || _writeClosed.exchange(true, std::memory_order_acq_rel)) { return false; }
+    wake();
+    return true;
+}
+
+bool PipeStream::closeRead() const {
+    if (!_buffer || _readClosed.exchange(true, std::memory_order_acq_rel)) { return false; }
+    wake();
+    return true;
+}
+
+size_t PipeStream::seek(int64_t offset, int origin) const {
+    const size_t position = tell();
+    if (!canRead()) { return position; }
+
+    //Only skipping ahead is possible, the bytes behind the read position are gone
+    size_t target = position;
+    switch (origin) {
+        case SEEK_CUR: target = offset > 0 ? position + size_t(offset) : position; break;
+        case SEEK_SET: target = offset > 0 && size_t(offset) > position ? size_t(offset) : position; break;
+    }
+
+    if (target > position) {
+        readRaw(nullptr, target - position, true);
+    }
+    return tell();
+}
+
+template<typename OnBytes>
+bool PipeStream::readUntil(const uint8_t delimiter, OnBytes&& onBytes) const {
+    //Scans the readable part of the ring in place & only advances the tail past what was taken (+ the delimiter)
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    bool consumed = false;
+    while (true) {
+        size_t head = _head.load(std::memory_order_acquire);
+        if (head == tail) {
+            waitFor([this, tail]() {
+                return _head.load(std::memory_order_acquire) != tail || isWriteClosed() || isReadClosed();
+            });
+
+            head = _head.load(std::memory_order_acquire);
+            if (head == tail || isReadClosed()) { break; }
+        }
+
+        const size_t offset = tail & _mask;
+        const size_t chunk = Math::min(head - tail, _capacity - offset);
+        const uint8_t* start = _buffer + offset;
+        const uint8_t* found = reinterpret_cast<const uint8_t*>(memchr(start, delimiter, chunk));
+        const size_t length = found ? size_t(found - start) : chunk;
+
+        const size_t taken = onBytes(start, length);
+        const bool done = found || taken < length;
+        tail += taken + (found && taken == length ? 1 : 0);
+        consumed = true;
+
+        _tail.store(tail, std::memory_order_release);
+        wake();
+        if (done) { break; }
+    }
+    return consumed;
+}
+
+bool PipeStream::readLine(std::string& output) const {
+    output.clear();
+    if (!canRead()) { return false; }
+
+    return readUntil('\n', [&output](const uint8_t* data, const size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            if (data[i] != '\r') {
+                output.push_back(char(data[i]));
+            }
+        }
+        return size;
+    });
+}
+
+int32_t PipeStream::readCString(char* str, int32_t maxLen) const {
+    if (!canRead() || maxLen < 1) { return 0; }
+
+    const size_t maxChars = size_t(maxLen - 1);
+    size_t len = 0;
+    readUntil(0, [str, maxChars, &len](const uint8_t* data, const size_t size) {
+        const size_t take = Math::min(size, maxChars - len);
+        memcpy(str + len, data, take);
+        len += take;
+        return take;
+    });
+    str[len] = 0;
+    return int32_t(len);
+}
+
+size_t PipeStream::readRaw(uint8_t* buffer, const size_t size, const bool wait) const {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    size_t done = 0;
+    while (done < size) {
+        size_t head = _head.load(std::memory_order_acquire);
+        if (head == tail) {
+            if (!wait) { break; }
+
+            waitFor([this, tail]() {
+                return _head.load(std::memory_order_acquire) != tail || isWriteClosed() || isReadClosed();
+            });
+
+            head = _head.load(std::memory_order_acquire);
+            if (head == tail || isReadClosed()) { break; }
+        }
+
+        const size_t chunk = Math::min(head - tail, size - done);
+        const size_t offset = tail & _mask;
+        const size_t first = Math::min(chunk, _capacity - offset);
+        if (buffer) {
+            memcpy(buffer + done, _buffer + offset, first);
+            memcpy(buffer + done + first, _buffer, chunk - first);
+        }
+
+        tail += chunk;
+        done += chunk;
+        _tail.store(tail, std::memory_order_release);
+        wake();
+    }
+    return done;
+}
+
+size_t PipeStream::writeRaw(const uint8_t* buffer, const size_t size, const bool wait) const {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t done = 0;
+    while (done < size) {
+        size_t free = _capacity - (head - _tail.load(std::memory_order_acquire));
+        if (free < 1) {
+            if (!wait) { break; }
+
+            waitFor([this, head]() {
+                return head - _tail.load(std::memory_order_acquire) < _capacity || isReadClosed();
+            });
+
+            free = _capacity - (head - _tail.load(std::memory_order_acquire));
+            if (free < 1 || isReadClosed()) { break; }
+        }
+
+        const size_t chunk = Math::min(free, size - done);
+        const size_t offset = head & _mask;
+        const size_t first = Math::min(chunk, _capacity - offset);
+        memcpy(_buffer + offset, buffer + done, first);
+        memcpy(_buffer, buffer + done + first, chunk - first);
+
+        head += chunk;
+        done += chunk;
+        _head.store(head, std::memory_order_release);
+        wake();
+    }
+    return done;
+}
+
+template<typename Pred>
+void PipeStream::waitFor(Pred&& ready) const {
+    for (uint32_t i = 0; i < SPIN_COUNT; i++) {
+        if (ready()) { return; }
+    }
+
+    if (_mode == WaitMode::Spin) {
+        while (!ready()) {
+            std::this_thread::yield();
+        }
+        return;
+    }
+
+    //Pairs with the fence in wake(), either the other side sees the sleeper or this side sees its progress
+    _sleepers.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, ready);
+    }
+    _sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void PipeStream::wake() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleepers.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cv.notify_all();
+    }
+}
@@ -0,0 +1,53 @@
+#include <J-Core/IO/Stream.h>
+#include <J-Core/Util/BufferPool.h>
+#include <J-Core/Math/Math.h>
+
+using namespace JCore;
+
+static constexpr size_t COPY_CHUNK_SIZE = 1024 * 1024;
+
+size_t Stream::copyTo(const Stream& other, const CopyProgressCB& onProgress) const {
+    //Goes through the virtual accessors, decorators & pipes track their position themselves
+    const size_t start = tell();
+    const size_t length = size();
+    if (!canRead() || !other.canWrite() || start >= length) { return 0; }
+
+    const size_t total = length - start;
+    if (!other.tryReserve(other.tell() + total)) { return 0; }
+
+    size_t copied = 0;
+    bool keepGoing = true;
+
+    //Memory backed sources are written straight from their storage, memory to memory this ends up as plain memcpys
+    const uint8_t* view = tryGetView(total);
+    if (view) {
+        while (keepGoing && copied < total) {
+            const size_t chunk = Math::min(total - copied, onProgress ? COPY_CHUNK_SIZE : total - copied);
+            const size_t written = other.write(view, chunk);
+            if (written < 1) { break; }
+
+            view += written;
+            copied += written;
+            keepGoing = !onProgress || onProgress(copied, total);
+        }
+    }
+    else {
+        size_t capacity = 0;
+        uint8_t* buffer = BufferPool::getGlobal().allocate(Math::min(total, COPY_CHUNK_SIZE), capacity);
+        if (buffer) {
+            while (keepGoing && copied < total) {
+                const size_t bRead = read(buffer, Math::min(total - copied, COPY_CHUNK_SIZE), false);
+                if (bRead < 1) { break; }
+
+                const size_t written = other.write(buffer, bRead);
+                copied += written;
+                if (written < bRead) { break; }
+                keepGoing = !onProgress || onProgress(copied, total);
+            }
+            BufferPool::getGlobal().deallocate(buffer, capacity);
+        }
+    }
+
+    seek(start, SEEK_SET);
+    return copied;
+}
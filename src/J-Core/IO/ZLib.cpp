@@ -6,11 +6,11 @@ namespace JCore::ZLib {
         return 0;
     }
 
-    int32_t inflateData(void* dataIn, const size_t lenIn, void* dataOut, const size_t lenOut) {
+    int32_t inflateData(const void* dataIn, const size_t lenIn, void* dataOut, const size_t lenOut) {
         z_stream zInfo = { 0 };
         zInfo.total_in = zInfo.avail_in = uInt(lenIn);
         zInfo.total_out = zInfo.avail_out = uInt(lenOut);
-        zInfo.next_in = reinterpret_cast<uint8_t*>(dataIn);
+        zInfo.next_in = const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(dataIn));
         zInfo.next_out = reinterpret_cast<uint8_t*>(dataOut);
 
         int32_t nErr, nRet = -1;
@@ -39,8 +39,7 @@ namespace JCore::ZLib {
     }
 
     int32_t deflateSegment(ZLibContext& context, void* dataIn, const size_t lenIn, const Stream& streamIn, void* buffer, const size_t bufferSize) {
-        static 
-        int32_t nErr = Z_OK, nRet = -1;
+        int32_t nErr = Z_OK;
 
         context.refreshNext(dataIn, lenIn);
         while (context.stream.avail_in != 0) {
@@ -116,8 +115,8 @@ namespace JCore::ZLib {
         int ret, flush{};
         unsigned have;
         z_stream strm{};
-        static uint8_t in[CHUNK]{};
-        static uint8_t out[CHUNK]{};
+        uint8_t in[CHUNK];
+        uint8_t out[CHUNK];
 
         strm.zalloc = Z_NULL;
         strm.zfree = Z_NULL;
@@ -156,8 +155,8 @@ namespace JCore::ZLib {
         int ret;
         unsigned have;
         z_stream strm{};
-        static uint8_t in[CHUNK]{};
-        static uint8_t out[CHUNK]{};
+        uint8_t in[CHUNK];
+        uint8_t out[CHUNK];
 
         strm.zalloc = Z_NULL;
         strm.zfree = Z_NULL;
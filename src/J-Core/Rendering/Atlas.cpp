@@ -1,8 +1,453 @@
 #include <J-Core/Rendering/Atlas.h>
 #include <J-Core/Rendering/Texture.h>
 #include <J-Core/Log.h>
+#include <J-Core/Util/Parallel.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <cmath>
 
 namespace JCore {
+    static void blitRow(const ImageView& src, int32_t y, uint8_t* dst, int32_t width, TextureFormat format) {
+        const uint8_t* row = src.getRow(y);
+        if (src.format == format) {
+            memcpy(dst, row, size_t(width) * src.getBytesPerPixel());
+            return;
+        }
+
+        const int32_t srcBpp = src.getBytesPerPixel();
+        const uint8_t* palette = reinterpret_cast<const uint8_t*>(src.palette);
+        Color32 color{};
+        switch (format) {
+            case TextureFormat::RGBA32: {
+                Color32* out = reinterpret_cast<Color32*>(dst);
+                switch (src.format) {
+                    case TextureFormat::Indexed8:
+                        for (int32_t x = 0; x < width; x++) {
+                            out[x] = src.palette[row[x]];
+                        }
+                        return;
+                    case TextureFormat::Indexed16: {
+                        const uint16_t* indices = reinterpret_cast<const uint16_t*>(row);
+                        for (int32_t x = 0; x < width; x++) {
+                            out[x] = src.palette[indices[x]];
+                        }
+                        return;
+                    }
+                    default:
+                        for (int32_t x = 0; x < width; x++, row += srcBpp) {
+                            convertPixel<Color32>(src.format, palette, row, out[x]);
+                        }
+                        return;
+                }
+            }
+            case TextureFormat::RGB24:
+                for (int32_t x = 0; x < width; x++, row += srcBpp, dst += 3) {
+                    convertPixel<Color32>(src.format, palette, row, color);
+                    memcpy(dst, &color, 3);
+                }
+                return;
+        }
+    }
+
+    /// <summary>
+    /// Writes 'src' turned 90 degrees clockwise so that target(x + ax, y + ay) = src(ay, rows - 1 - ax).
+    /// Works in small tiles, each tile is converted into a scratch block first so both the reads & the transposed writes stay in cache.
+    /// </summary>
+    static void blitRotated(const ImageView& src, int32_t rows, int32_t cols, const ImageView& target, int32_t x, int32_t y, TextureFormat format) {
+        static constexpr int32_t TILE = 32;
+        const size_t bpp = getBitsPerPixel(format) >> 3;
+        uint8_t tile[TILE * TILE * 8];
+
+        for (int32_t ty = 0; ty < rows; ty += TILE) {
+            const int32_t th = std::min(TILE, rows - ty);
+            for (int32_t tx = 0; tx < cols; tx += TILE) {
+                const int32_t tw = std::min(TILE, cols - tx);
+                const ImageView block = src.getSubView(tx, ty, tw, th);
+                for (int32_t r = 0; r < th; r++) {
+                    blitRow(block, r, tile + size_t(r) * TILE * bpp, tw, format);
+                }
+
+                //Source column 'tx + c' becomes target row 'y + tx + c', source rows are written right to left
+                const int32_t left = x + rows - (ty + th);
+                for (int32_t c = 0; c < tw; c++) {
+                    uint8_t* dst = target.getPixel(left, y + tx + c);
+                    for (int32_t r = th - 1; r >= 0; r--, dst += bpp) {
+                        memcpy(dst, tile + (size_t(r) * TILE + c) * bpp, bpp);
+                    }
+                }
+            }
+        }
+    }
+
+    static void extrudeEdges(const ImageView& target, int32_t x, int32_t y, int32_t width, int32_t height, int32_t extrude) {
+        const int32_t bpp = target.getBytesPerPixel();
+        const int32_t left = std::min(extrude, x);
+        const int32_t right = std::min(extrude, target.width - (x + width));
+        const int32_t top = std::min(extrude, y);
+        const int32_t bottom = std::min(extrude, target.height - (y + height));
+
+        if (left > 0 || right > 0) {
+            for (int32_t yy = y; yy < y + height; yy++) {
+                const uint8_t* first = target.getPixel(x, yy);
+                const uint8_t* last = target.getPixel(x + width - 1, yy);
+                for (int32_t i = 1; i <= left; i++) {
+                    memcpy(target.getPixel(x - i, yy), first, bpp);
+                }
+                for (int32_t i = 1; i <= right; i++) {
+                    memcpy(target.getPixel(x + width - 1 + i, yy), last, bpp);
+                }
+            }
+        }
+
+        const size_t span = size_t(left + width + right) * bpp;
+        for (int32_t i = 1; i <= top; i++) {
+            memcpy(target.getPixel(x - left, y - i), target.getPixel(x - left, y), span);
+        }
+        for (int32_t i = 1; i <= bottom; i++) {
+            memcpy(target.getPixel(x - left, y + height - 1 + i), target.getPixel(x - left, y + height - 1), span);
+        }
+    }
+
+    static bool isSamePixels(const ImageView& lhs, const ImageView& rhs) {
+        if (lhs.width != rhs.width || lhs.height != rhs.height || lhs.format != rhs.format) { return false; }
+        if (lhs.isIndexed()) {
+            if (lhs.paletteSize != rhs.paletteSize) { return false; }
+            if (lhs.palette != rhs.palette && memcmp(lhs.palette, rhs.palette, lhs.getPaletteBytes()) != 0) { return false; }
+        }
+
+        const size_t scan = lhs.getScanSize();
+        for (int32_t y = 0; y < lhs.height; y++) {
+            if (memcmp(lhs.getRow(y), rhs.getRow(y), scan) != 0) { return false; }
+        }
+        return true;
+    }
+
+    size_t findDuplicateSprites(const ImageView* sprites, size_t count, std::vector<uint32_t>& duplicateOf) {
+        duplicateOf.resize(count);
+        if (count < 1) { return 0; }
+
+        std::vector<uint64_t> hashes(count);
+        Parallel::forEach(count, [sprites, &hashes](size_t i) {
+            const ImageView& sprite = sprites[i];
+            uint64_t header[2]{ (uint64_t(uint32_t(sprite.width)) << 32) | uint32_t(sprite.height), uint64_t(sprite.format) };
+            uint64_t hash = Data::hash64(header, sizeof(header));
+            if (sprite.isIndexed() && sprite.palette) {
+                hash = Data::hash64(sprite.palette, sprite.getPaletteBytes(), hash);
+            }
+
+            if (sprite.pixels) {
+                const size_t scan = sprite.getScanSize();
+                if (sprite.isContiguous()) {
+                    hash = Data::hash64(sprite.pixels, scan * sprite.height, hash);
+                }
+                else {
+                    for (int32_t y = 0; y < sprite.height; y++) {
+                        hash = Data::hash64(sprite.getRow(y), scan, hash);
+                    }
+                }
+            }
+            hashes[i] = hash;
+        });
+
+        size_t unique = 0;
+        std::unordered_multimap<uint64_t, uint32_t> seen{};
+        seen.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            duplicateOf[i] = uint32_t(i);
+            if (!sprites[i].pixels) {
+                unique++;
+                continue;
+            }
+
+            auto range = seen.equal_range(hashes[i]);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (isSamePixels(sprites[it->second], sprites[i])) {
+                    duplicateOf[i] = it->second;
+                    break;
+                }
+            }
+
+            if (duplicateOf[i] == i) {
+                seen.emplace(hashes[i], uint32_t(i));
+                unique++;
+            }
+        }
+        return unique;
+    }
+
+    void appendDuplicateRegions(const uint32_t* duplicateOf, size_t spriteCount, std::vector<AtlasDefiniton>& results, size_t firstPage) {
+        FlatMap<uint32_t, std::pair<size_t, TextureRegion>> placed{};
+        for (size_t page = firstPage; page < results.size(); page++) {
+            for (const auto& region : results[page].atlas) {
+                placed[region.original] = { page, region };
+            }
+        }
+
+        for (size_t i = 0; i < spriteCount; i++) {
+            if (duplicateOf[i] == i) { continue; }
+
+            const auto* find = placed.tryGet(duplicateOf[i]);
+            if (!find) { continue; }
+            const TextureRegion& region = find->second;
+            results[find->first].atlas.emplace_back(uint32_t(i), region.rect, region.flags);
+        }
+    }
+
+    static int32_t ceilPow2(int32_t value) {
+        int32_t pow = 16;
+        while (pow < value) { pow <<= 1; }
+        return pow;
+    }
+
+    template<typename Bin>
+    static bool growBin(Bin& bin, int32_t maxSize) {
+        int32_t width = bin.getWidth();
+        int32_t height = bin.getHeight();
+        if (width >= maxSize && height >= maxSize) { return false; }
+
+        if ((width <= height && width < maxSize) || height >= maxSize) {
+            width = std::min(width << 1, maxSize);
+        }
+        else {
+            height = std::min(height << 1, maxSize);
+        }
+        bin.grow(width, height);
+        return true;
+    }
+
+    template<typename Bin>
+    static void packPages(Bin& bin, std::vector<const PackingItem*> pending, int32_t maxSize, int32_t padding, bool allowRotation, std::vector<AtlasDefiniton>& results) {
+        std::vector<const PackingItem*> deferred{};
+        while (pending.size() > 0) {
+            uint64_t area = 0;
+            int32_t maxW = 0, maxH = 0;
+            for (const PackingItem* item : pending) {
+                const int32_t pW = item->width + padding;
+                const int32_t pH = item->height + padding;
+                area += uint64_t(pW) * uint64_t(pH);
+                maxW = std::max(maxW, pW);
+                maxH = std::max(maxH, pH);
+            }
+
+            //Start from the smallest power of two square-ish page that could hold everything, growing in place from there
+            const int32_t width = std::min(ceilPow2(std::max<int32_t>(maxW, int32_t(std::ceil(std::sqrt(double(area)))))), maxSize);
+            const int32_t height = std::min(ceilPow2(std::max<int32_t>(maxH, int32_t((area + width - 1) / width))), maxSize);
+            bin.reset(width, height);
+
+            AtlasDefiniton res{};
+            res.atlas.reserve(pending.size());
+            deferred.clear();
+            for (const PackingItem* item : pending) {
+                const int32_t pW = item->width + padding;
+                PackRect rect{};
+                bool placed = bin.insert(pW, item->height + padding, rect, allowRotation);
+                while (!placed && growBin(bin, maxSize)) {
+                    placed = bin.insert(pW, item->height + padding, rect, allowRotation);
+                }
+
+                if (placed) {
+                    //Padding is the same on both axes so a rotated placement is the only way the width can differ
+                    res.atlas.emplace_back(item->index, SpriteRect(rect.x, rect.y, rect.width, rect.height), rect.width != pW ? Spr_Rotated : Spr_None);
+                    continue;
+                }
+                deferred.push_back(item);
+            }
+
+            res.width = uint16_t(bin.getWidth());
+            res.height = uint16_t(bin.getHeight());
+            results.push_back(std::move(res));
+            pending.swap(deferred);
+        }
+    }
+
+    static void sortItems(std::vector<const PackingItem*>& items, PackingSort sortBy) {
+        //Stable so equal keys keep their input order and the same input always packs the same way
+        auto bySize = [sortBy](const PackingItem* a, const PackingItem* b) {
+            const uint32_t wA = a->width, hA = a->height;
+            const uint32_t wB = b->width, hB = b->height;
+            switch (sortBy) {
+                default:
+                    return wA * hA > wB * hB;
+                case PackingSort::Height:
+                    return hA != hB ? hA > hB : wA > wB;
+                case PackingSort::Width:
+                    return wA != wB ? wA > wB : hA > hB;
+                case PackingSort::Perimeter:
+                    return wA + hA > wB + hB;
+                case PackingSort::MaxSide: {
+                    const uint32_t maxA = std::max(wA, hA), maxB = std::max(wB, hB);
+                    return maxA != maxB ? maxA > maxB : std::min(wA, hA) > std::min(wB, hB);
+                }
+            }
+        };
+        std::stable_sort(items.begin(), items.end(), bySize);
+    }
+
+    static bool packWith(PackingMethod method, MaxRectsHeuristic heuristic, const std::vector<const PackingItem*>& items, const RectPackingSpecs& specs, std::vector<AtlasDefiniton>& results) {
+        switch (method) {
+            case PackingMethod::MaxRects: {
+                MaxRectsBin bin(heuristic);
+                packPages(bin, items, specs.maxSize, specs.padding, specs.allowRotation, results);
+                return true;
+            }
+            case PackingMethod::Skyline: {
+                SkylineBin bin{};
+                packPages(bin, items, specs.maxSize, specs.padding, specs.allowRotation, results);
+                return true;
+            }
+            default:
+                JCORE_ERROR("[J-Core - Atlas] Error: packRects only handles the MaxRects, Skyline & Search methods!");
+                return false;
+        }
+    }
+
+    static bool searchPacking(const std::vector<const PackingItem*>& items, const RectPackingSpecs& specs, std::vector<AtlasDefiniton>& results) {
+        struct Candidate {
+            PackingMethod method{ PackingMethod::MaxRects };
+            MaxRectsHeuristic heuristic{ MaxRectsHeuristic::BestShortSideFit };
+            PackingSort sortBy{ PackingSort::Area };
+            std::vector<AtlasDefiniton> pages{};
+            uint64_t area{ 0 };
+        };
+
+        std::vector<Candidate> candidates{};
+        const size_t sortCount = specs.sort ? size_t(PackingSort::Count) : 1;
+        for (size_t i = 0; i < sortCount; i++) {
+            for (size_t j = 0; j < size_t(MaxRectsHeuristic::Count); j++) {
+                candidates.push_back({ PackingMethod::MaxRects, MaxRectsHeuristic(j), PackingSort(i) });
+            }
+            candidates.push_back({ PackingMethod::Skyline, MaxRectsHeuristic::BestShortSideFit, PackingSort(i) });
+        }
+
+        Parallel::forEach(candidates.size(), [&](size_t i) {
+            Candidate& candidate = candidates[i];
+            std::vector<const PackingItem*> order = items;
+            if (specs.sort) {
+                sortItems(order, candidate.sortBy);
+            }
+
+            packWith(candidate.method, candidate.heuristic, order, specs, candidate.pages);
+            for (const auto& page : candidate.pages) {
+                candidate.area += uint64_t(page.width) * page.height;
+            }
+        });
+
+        //Every candidate packs the same sprites, so the smallest total page area is also the highest occupancy.
+        //Ties go to the earlier candidate which keeps the pick deterministic regardless of thread timing.
+        size_t best = 0;
+        for (size_t i = 1; i < candidates.size(); i++) {
+            const Candidate& cur = candidates[i];
+            const Candidate& sel = candidates[best];
+            if (cur.pages.size() < sel.pages.size() || (cur.pages.size() == sel.pages.size() && cur.area < sel.area)) {
+                best = i;
+            }
+        }
+
+        for (auto& page : candidates[best].pages) {
+            results.push_back(std::move(page));
+        }
+        return true;
+    }
+
+    bool packRects(const PackingItem* items, size_t count, const RectPackingSpecs& specs, std::vector<AtlasDefiniton>& results) {
+        bool success = true;
+        std::vector<const PackingItem*> valid{};
+        valid.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            const PackingItem& item = items[i];
+            if (item.width + specs.padding > specs.maxSize || item.height + specs.padding > specs.maxSize) {
+                JCORE_ERROR("[J-Core - Atlas] Error: Sprite #{0} ({1}x{2}) doesn't fit in the max atlas size of {3}!", item.index, item.width, item.height, specs.maxSize);
+                success = false;
+                continue;
+            }
+            valid.push_back(&item);
+        }
+
+        if (specs.method == PackingMethod::Search) {
+            return searchPacking(valid, specs, results) && success;
+        }
+
+        if (specs.sort) {
+            sortItems(valid, specs.sortBy);
+        }
+        return packWith(specs.method, specs.heuristic, valid, specs, results) && success;
+    }
+
+    SpriteRect blitSprite(const ImageView& src, const ImageView& target, int32_t x, int32_t y, bool rotated) {
+        const int32_t width = std::min<int32_t>(rotated ? src.height : src.width, target.width - x);
+        const int32_t height = std::min<int32_t>(rotated ? src.width : src.height, target.height - y);
+        if (!src.pixels || !target.pixels || x < 0 || y < 0 || width < 1 || height < 1) { return {}; }
+
+        if (rotated) {
+            blitRotated(src, width, height, target, x, y, target.format);
+        }
+        else {
+            for (int32_t yy = 0; yy < height; yy++) {
+                blitRow(src, yy, target.getPixel(x, y + yy), width, target.format);
+            }
+        }
+        return SpriteRect(x, y, width, height);
+    }
+
+    bool composeAtlas(const AtlasDefiniton& definition, const ImageView* sources, size_t sourceCount, ImageData& output, const AtlasCompositeSpecs& specs) {
+        switch (specs.format) {
+            case TextureFormat::Unknown:
+            case TextureFormat::Indexed8:
+            case TextureFormat::Indexed16:
+                JCORE_ERROR("[J-Core - Atlas] Error: Can't compose an atlas with format '{0}'!", getTextureFormatName(specs.format));
+                return false;
+            default: break;
+        }
+
+        const bool canConvert = specs.format == TextureFormat::RGBA32 || specs.format == TextureFormat::RGB24;
+        for (const auto& region : definition.atlas) {
+            if (region.original >= sourceCount) {
+                JCORE_ERROR("[J-Core - Atlas] Error: Region refers to source #{0}, only {1} sources given!", region.original, sourceCount);
+                return false;
+            }
+
+            const ImageView& src = sources[region.original];
+            if (src.isIndexed() && !src.palette) {
+                JCORE_ERROR("[J-Core - Atlas] Error: Indexed source #{0} is missing its palette!", region.original);
+                return false;
+            }
+
+            if (src.format != specs.format && !canConvert) {
+                JCORE_ERROR("[J-Core - Atlas] Error: Can't convert source #{0} from '{1}' to '{2}'!", region.original, 
+                    getTextureFormatName(src.format), getTextureFormatName(specs.format));
+                return false;
+            }
+        }
+
+        if (!output.doAllocate(definition.width, definition.height, specs.format, 0, false, 1, true, specs.clear)) {
+            JCORE_ERROR("[J-Core - Atlas] Error: Failed to allocate atlas of size {0}x{1}!", definition.width, definition.height);
+            return false;
+        }
+
+        //Regions sharing a position are duplicates of the same pixels, only blit them once
+        std::vector<const TextureRegion*> regions{};
+        std::unordered_set<uint32_t> positions{};
+        regions.reserve(definition.atlas.size());
+        positions.reserve(definition.atlas.size());
+        for (const auto& region : definition.atlas) {
+            if (positions.insert((uint32_t(region.rect.x) << 16) | region.rect.y).second) {
+                regions.push_back(&region);
+            }
+        }
+
+        const ImageView target = output.getView();
+        const int32_t extrude = std::min<int32_t>(specs.extrude, specs.padding >> 1);
+        Parallel::forEach(regions.size(), [&regions, sources, &target, extrude](size_t i) {
+            const TextureRegion& region = *regions[i];
+            const ImageView area = target.getSubView(region.rect.x, region.rect.y, region.rect.width, region.rect.height);
+            const SpriteRect written = blitSprite(sources[region.original], area, 0, 0, region.isRotated());
+            if (extrude > 0 && written.width > 0) {
+                extrudeEdges(target, region.rect.x, region.rect.y, written.width, written.height, extrude);
+            }
+        });
+        return true;
+    }
+
     Atlas::Atlas() : _texture(), _sprites{}, _nameToIndex{} { }
 
     Atlas::~Atlas() {
@@ -15,9 +460,14 @@ namespace JCore {
     void Atlas::setSprites(const SpriteInfo* frames, size_t frameCount) {
         _sprites.clear();
         _sprites.reserve(frameCount);
+        _nameToIndex.clear();
+        _nameToIndex.reserve(frameCount);
 
         for (size_t i = 0; i < frameCount; i++)  {
             _sprites.emplace_back(frames[i], _texture).assignAtlas(this, frames[i].flags & Spr_Rotated);
+            if (frames[i].name.length() > 0) {
+                _nameToIndex.tryEmplace(StringId::intern(frames[i].name), int32_t(i));
+            }
         }
     }
 
@@ -30,7 +480,7 @@ namespace JCore {
         }
 
         if (_texture){
-            if (_texture->getWidth() != imageData.width || _texture->getHeight() != imageData.height) {
+            if (_texture->isValid() && (_texture->getWidth() != imageData.width || _texture->getHeight() != imageData.height)) {
                 JCORE_ERROR("[J-Core - Atlas] Error: Failed to apply pixel data to atlas! (Invalid resolution '{0}x{1}' should be '{2}x{3}')", 
                     _texture->getWidth(), _texture->getHeight(), imageData.width, imageData.height);
                 return;
@@ -40,12 +490,9 @@ namespace JCore {
         JCORE_ERROR("[J-Core - Atlas] Error: Failed to apply pixel data to atlas!");
     }
 
-    const Sprite* Atlas::findByName(const std::string& str) const {
-        auto find = _nameToIndex.find(str);
-        if (find != _nameToIndex.end()) {
-            return &_sprites[find->second];
-        }
-        return nullptr;
+    const Sprite* Atlas::findByName(StringId name) const {
+        const int32_t* index = _nameToIndex.tryGet(name);
+        return index ? &_sprites[*index] : nullptr;
     }
 
     bool Atlas::isValid() const {
@@ -29,9 +29,8 @@ namespace JCore {
             return nullptr;
         }
 
-        auto find = _bufferLut.find(id);
-        if (find != _bufferLut.end()) {
-            int32_t ind = find->second;
+        if (const int32_t* find = _bufferLut.tryGet(id)) {
+            int32_t ind = *find;
             _buffers[ind].id = id;
             _buffers[ind].ticksLeft = FB_POOL_MAX_TICKS_ACTIVE;
             newInstance = false;
@@ -42,14 +41,14 @@ namespace JCore {
         for (int32_t i = 0; i < _buffers.size(); i++) {
             auto& buf = _buffers[i];
             if (buf.ticksLeft == 0 || buf.id == 0) {
-                _bufferLut.insert(std::make_pair(id, i));
-                _buffers[i].ticksLeft = id;
+                _bufferLut.tryEmplace(id, i);
+                _buffers[i].id = id;
                 _buffers[i].ticksLeft = FB_POOL_MAX_TICKS_ACTIVE;
                 return &_buffers[i].buffer;
             }
         }
 
-        _bufferLut.insert(std::make_pair(id, int32_t(_buffers.size())));
+        _bufferLut.tryEmplace(id, int32_t(_buffers.size()));
         auto& bufOut = _buffers.emplace_back();
         bufOut.id = id;
         bufOut.ticksLeft = FB_POOL_MAX_TICKS_ACTIVE;
@@ -0,0 +1,207 @@
+#include <J-Core/Rendering/DynamicAtlas.h>
+#include <J-Core/Rendering/Atlas.h>
+#include <J-Core/Rendering/Texture.h>
+#include <J-Core/Log.h>
+
+namespace JCore {
+    static constexpr uint32_t NO_ENTRY = UINT32_MAX;
+
+    DynamicAtlas::DynamicAtlas(uint16_t width, uint16_t height, uint8_t padding) :
+        _allocator(width, height), _pixels{}, _texture(std::make_shared<Texture>()), _entries{}, _freeEntries{}, _nameToIndex{}, _dirty{},
+        _lruHead(NO_ENTRY), _lruTail(NO_ENTRY), _frame(0), _evictions(0), _padding(padding) {
+        if (!_pixels.doAllocate(width, height, TextureFormat::RGBA32)) {
+            JCORE_ERROR("[J-Core - DynamicAtlas] Error: Failed to allocate atlas of size {0}x{1}!", width, height);
+            _allocator.reset(0, 0);
+        }
+    }
+
+    DynamicAtlas::~DynamicAtlas() {
+        _pixels.clear(true);
+    }
+
+    DynamicAtlas::Handle DynamicAtlas::add(const ImageView& image, const std::string& name) {
+        if (!image.pixels || image.width < 1 || image.height < 1) { return {}; }
+        if (image.isIndexed() && !image.palette) {
+            JCORE_ERROR("[J-Core - DynamicAtlas] Error: Indexed image is missing its palette!");
+            return {};
+        }
+
+        PackRect rect{};
+        uint32_t allocation = _allocator.allocate(image.width + _padding, image.height + _padding, rect);
+        while (allocation == ShelfAllocator::INVALID_ID && _lruTail != NO_ENTRY && _entries[_lruTail].lastUsed < _frame) {
+            release(_lruTail);
+            _evictions++;
+            allocation = _allocator.allocate(image.width + _padding, image.height + _padding, rect);
+        }
+
+        if (allocation == ShelfAllocator::INVALID_ID) {
+            JCORE_WARN("[J-Core - DynamicAtlas] Warning: No room for a {0}x{1} sprite, even after evicting unused sprites!", image.width, image.height);
+            return {};
+        }
+
+        //Padding is cleared too since evicted sprites leave their pixels behind
+        const ImageView target = _pixels.getView();
+        for (int32_t y = 0; y < rect.height; y++) {
+            memset(target.getPixel(rect.x, rect.y + y), 0, size_t(rect.width) * sizeof(Color32));
+        }
+        blitSprite(image, target, rect.x, rect.y);
+        markDirty(rect);
+
+        uint32_t index = uint32_t(_entries.size());
+        if (_freeEntries.size() > 0) {
+            index = _freeEntries.back();
+            _freeEntries.pop_back();
+        }
+        else {
+            _entries.emplace_back();
+        }
+
+        Entry& entry = _entries[index];
+        entry.sprite = Sprite(name, SpriteRect(rect.x, rect.y, image.width, image.height), _texture);
+        entry.name = StringId::intern(name);
+        entry.allocation = allocation;
+        entry.lastUsed = _frame;
+        linkFront(index);
+
+        if (entry.name.isValid()) {
+            _nameToIndex[entry.name] = index;
+        }
+        return { index, entry.generation };
+    }
+
+    bool DynamicAtlas::remove(Handle handle) {
+        if (!getEntry(handle)) { return false; }
+        release(handle.index);
+        return true;
+    }
+
+    bool DynamicAtlas::contains(Handle handle) const {
+        return getEntry(handle) != nullptr;
+    }
+
+    DynamicAtlas::Handle DynamicAtlas::findByName(StringId name) const {
+        const uint32_t* index = _nameToIndex.tryGet(name);
+        return index ? Handle{ *index, _entries[*index].generation } : Handle{};
+    }
+
+    const Sprite* DynamicAtlas::getSprite(Handle handle) const {
+        const Entry* entry = getEntry(handle);
+        return entry ? &entry->sprite : nullptr;
+    }
+
+    void DynamicAtlas::touch(Handle handle) {
+        if (!getEntry(handle)) { return; }
+        _entries[handle.index].lastUsed = _frame;
+        if (_lruHead != handle.index) {
+            unlink(handle.index);
+            linkFront(handle.index);
+        }
+    }
+
+    bool DynamicAtlas::flush() {
+        if (!_texture->isValid()) {
+            if (!_texture->create(_pixels.data, _pixels.format, 0, _pixels.width, _pixels.height, _pixels.flags)) {
+                JCORE_ERROR("[J-Core - DynamicAtlas] Error: Failed to create atlas texture!");
+                return false;
+            }
+
+            //UVs depend on the texture size, which is only known now
+            for (auto& entry : _entries) {
+                if (entry.allocation != ShelfAllocator::INVALID_ID) {
+                    entry.sprite.setTexture(_texture);
+                }
+            }
+            _dirty.clear();
+            return true;
+        }
+
+        bool success = true;
+        for (const auto& rect : _dirty) {
+            success &= _texture->update(_pixels.getSubView(rect.x, rect.y, rect.width, rect.height), rect.x, rect.y);
+        }
+        _dirty.clear();
+        return success;
+    }
+
+    const DynamicAtlas::Entry* DynamicAtlas::getEntry(Handle handle) const {
+        if (handle.index >= _entries.size()) { return nullptr; }
+        const Entry& entry = _entries[handle.index];
+        return entry.generation == handle.generation && entry.allocation != ShelfAllocator::INVALID_ID ? &entry : nullptr;
+    }
+
+    void DynamicAtlas::release(uint32_t index) {
+        Entry& entry = _entries[index];
+        _allocator.free(entry.allocation);
+        unlink(index);
+
+        if (entry.name.isValid()) {
+            auto find = _nameToIndex.find(entry.name);
+            if (find != _nameToIndex.end() && find->second == index) {
+                _nameToIndex.erase(find);
+            }
+        }
+
+        entry.sprite = Sprite();
+        entry.name = StringId();
+        entry.allocation = ShelfAllocator::INVALID_ID;
+        entry.generation++;
+        _freeEntries.push_back(index);
+    }
+
+    void DynamicAtlas::unlink(uint32_t index) {
+        Entry& entry = _entries[index];
+        if (entry.prev != NO_ENTRY) { _entries[entry.prev].next = entry.next; }
+        else { _lruHead = entry.next; }
+
+        if (entry.next != NO_ENTRY) { _entries[entry.next].prev = entry.prev; }
+        else { _lruTail = entry.prev; }
+
+        entry.prev = NO_ENTRY;
+        entry.next = NO_ENTRY;
+    }
+
+    void DynamicAtlas::linkFront(uint32_t index) {
+        Entry& entry = _entries[index];
+        entry.prev = NO_ENTRY;
+        entry.next = _lruHead;
+        if (_lruHead != NO_ENTRY) { _entries[_lruHead].prev = index; }
+        _lruHead = index;
+        if (_lruTail == NO_ENTRY) { _lruTail = index; }
+    }
+
+    void DynamicAtlas::markDirty(const PackRect& rect) {
+        //Overlapping or touching rects are merged, the union can reach more rects so scanning restarts after each merge
+        PackRect merged = rect;
+        for (size_t i = 0; i < _dirty.size();) {
+            const PackRect& dirty = _dirty[i];
+            if (dirty.x > merged.x + merged.width || merged.x > dirty.x + dirty.width ||
+                dirty.y > merged.y + merged.height || merged.y > dirty.y + dirty.height) {
+                i++;
+                continue;
+            }
+
+            const int32_t minX = std::min(merged.x, dirty.x);
+            const int32_t minY = std::min(merged.y, dirty.y);
+            const int32_t maxX = std::max(merged.x + merged.width, dirty.x + dirty.width);
+            const int32_t maxY = std::max(merged.y + merged.height, dirty.y + dirty.height);
+            merged = PackRect(minX, minY, maxX - minX, maxY - minY);
+
+            _dirty[i] = _dirty.back();
+            _dirty.pop_back();
+            i = 0;
+        }
+        _dirty.push_back(merged);
+
+        if (_dirty.size() > MAX_DIRTY_RECTS) {
+            int32_t minX = INT32_MAX, minY = INT32_MAX, maxX = 0, maxY = 0;
+            for (const auto& dirty : _dirty) {
+                minX = std::min(minX, dirty.x);
+                minY = std::min(minY, dirty.y);
+                maxX = std::max(maxX, dirty.x + dirty.width);
+                maxY = std::max(maxY, dirty.y + dirty.height);
+            }
+            _dirty.clear();
+            _dirty.emplace_back(minX, minY, maxX - minX, maxY - minY);
+        }
+    }
+}
@@ -17,6 +17,9 @@
 namespace JCore {
     Renderer* Renderer::Instance{ nullptr };
 
+    static const StringId MVP_UNIFORM = StringId::intern("_MVP");
+    static const StringId MAIN_TEX_UNIFORM = StringId::intern("_MainTex");
+
     struct RenderGroup {
         const Texture* texture { nullptr };
         uint32_t length   { 0 };
@@ -278,7 +281,7 @@ namespace JCore {
                     for (size_t i = 0; i < 2; i++) {
                         auto& shader = _shaders[i];
                         shader.bind();
-                        shader.setUniformMat4f("_MVP", proj);
+                        shader.setUniformMat4f(MVP_UNIFORM, proj);
                     }
 
                     uint32_t ind = 0;
@@ -296,7 +299,7 @@ namespace JCore {
                            }
 
                            shader.bind();
-                           shader.setTextures("_MainTex", grp.texture, 0);
+                           shader.setTextures(MAIN_TEX_UNIFORM, grp.texture, 0);
                            grp.texture->bind(0);
                            _dynamicBatch.drawBatch();
                            continue;
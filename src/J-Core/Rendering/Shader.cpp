@@ -29,6 +29,7 @@ namespace JCore {
     }
 
     void Shader::release() {
+        _uniformCache.clear();
         if (_shaderId) {
             glDeleteProgram(_shaderId);
             _shaderId = 0;
@@ -44,33 +45,55 @@ namespace JCore {
     }
     void Shader::unbind() const { glUseProgram(0); }
 
-    void Shader::setUniformMat4f(const std::string& name, const Matrix4f& mat) {
+    void Shader::setUniformMat4f(StringId name, const Matrix4f& mat) {
         if (!_shaderId) { return; }
-        glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0]);
+        glUniformMatrix4fv(getUniform(name, std::string_view()).location, 1, GL_FALSE, &mat[0]);
     }
 
-    uint32_t Shader::setTextures(const std::string& name, const Texture* texture, const uint32_t position) {
+    void Shader::setUniformMat4f(std::string_view name, const Matrix4f& mat) {
+        if (!_shaderId) { return; }
+        glUniformMatrix4fv(getUniform(StringId(name), name).location, 1, GL_FALSE, &mat[0]);
+    }
+
+    uint32_t Shader::setTextures(StringId name, const Texture* texture, const uint32_t position) {
+        return setTextures(name, std::string_view(), texture, position);
+    }
+
+    uint32_t Shader::setTextures(std::string_view name, const Texture* texture, const uint32_t position) {
+        return setTextures(StringId(name), name, texture, position);
+    }
+
+    uint32_t Shader::setTextures(StringId id, std::string_view name, const Texture* texture, const uint32_t position) {
         if (!texture || !_shaderId) { return position; }
 
         uint32_t pos = position;
-        int32_t uId = getUniformLocation(name);
+        UniformInfo& uniform = getUniform(id, name);
 
-        if (uId < 0) { return pos; }
-        glUniform1i(uId, pos++);
+        if (uniform.location < 0) { return pos; }
+        glUniform1i(uniform.location, pos++);
         if (texture->getFormat() == TextureFormat::Indexed8) {
-            uId = getUniformLocation(name + "_Pal");
-            if (uId > -1) {
-                glUniform1i(uId, pos++);
+            if (uniform.paletteLocation == UNRESOLVED_LOCATION) {
+                std::string palName(name.length() > 0 ? name : id.toString());
+                palName.append("_Pal");
+
+                uniform.paletteLocation = glGetUniformLocation(_shaderId, palName.c_str());
+                if (uniform.paletteLocation == -1) {
+                    JCORE_WARN("Warning: Shader uniform '{0}' doesn't exist!", palName);
+                }
+            }
+
+            if (uniform.paletteLocation > -1) {
+                glUniform1i(uniform.paletteLocation, pos++);
             }
         }
         return pos;
     }
 
-    uint32_t Shader::setTexture(const std::string& name, const uint32_t position) {
+    uint32_t Shader::setTexture(StringId name, const uint32_t position) {
         if (!_shaderId) { return position; }
 
         uint32_t pos = position;
-        int32_t uId = getUniformLocation(name);
+        int32_t uId = getUniform(name, std::string_view()).location;
 
         if (uId < 0) { return pos; }
         glUniform1i(uId, pos++);
@@ -78,16 +101,37 @@ namespace JCore {
         return pos;
     }
 
-    int32_t Shader::getUniformLocation(const std::string& name) {
-        if (!_shaderId) { return -1; }
-        if (_uniformCache.find(name) != _uniformCache.end()) { return _uniformCache[name]; }
+    uint32_t Shader::setTexture(std::string_view name, const uint32_t position) {
+        if (!_shaderId) { return position; }
+
+        uint32_t pos = position;
+        int32_t uId = getUniform(StringId(name), name).location;
+
+        if (uId < 0) { return pos; }
+        glUniform1i(uId, pos++);
+
+        return pos;
+    }
+
+    Shader::UniformInfo& Shader::getUniform(StringId id, std::string_view name) {
+        auto find = _uniformCache.tryEmplace(id);
+        UniformInfo& uniform = find.first->second;
+        if (!find.second) { return uniform; }
+
+        //'name' is only given by the string_view overloads, for ids the interned text is used
+        const std::string_view text = name.length() > 0 ? name : id.toString();
+        if (text.length() < 1) {
+            JCORE_WARN("Warning: Shader uniform id 0x{0:X} was never interned!", id.getHash());
+            return uniform;
+        }
 
-        int32_t location = glGetUniformLocation(_shaderId, name.c_str());
-        if (location == -1) {
-            JCORE_WARN("Warning: Shader uniform '{0}' doesn't exist!", name);
+        //Views aren't guaranteed to be null terminated
+        const std::string nameStr(text);
+        uniform.location = glGetUniformLocation(_shaderId, nameStr.c_str());
+        if (uniform.location == -1) {
+            JCORE_WARN("Warning: Shader uniform '{0}' doesn't exist!", text);
         }
-        _uniformCache[name] = location;
-        return location;
+        return uniform;
     }
 
     uint32_t Shader::compileShader(const char* shader, uint32_t type) {
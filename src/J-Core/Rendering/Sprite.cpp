@@ -25,20 +25,34 @@ namespace JCore {
 
     void Sprite::setTexture(std::weak_ptr<Texture> texture) {
         _texture = texture;
+        initVerts();
     }
 
     void Sprite::assignAtlas(Atlas* atlas, bool rotated) {
         _atlas = atlas;
         _info.flags = (rotated ? Spr_Rotated : 0) | (atlas ? Spr_FromAtlas : 0);
+        initVerts();
     }
 
     void Sprite::initVerts()  {
-        const auto& rect = _info.rect;
         auto texPtr = _texture.lock();
-        glm::i32vec2 reso = texPtr ? glm::i32vec2(texPtr->getWidth(), texPtr->getHeight()) : glm::i32vec2(0, 0);
-        _verts[0] = { {rect.width * -0.5f, rect.height * -0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x, rect.y}, reso) };
-        _verts[1] = { {rect.width * 0.5f, rect.height * -0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x + rect.width, rect.y}, reso) };
-        _verts[2] = { {rect.width * 0.5f, rect.height * 0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x + rect.width, rect.y + rect.height}, reso) };
-        _verts[3] = { {rect.width * -0.5f, rect.height * 0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x,              rect.y + rect.height}, reso) };
+        buildVerts(_info, texPtr ? glm::i32vec2(texPtr->getWidth(), texPtr->getHeight()) : glm::i32vec2(0, 0), _verts);
+    }
+
+    void Sprite::buildVerts(const SpriteInfo& info, const glm::i32vec2& reso, Vertex verts[4]) {
+        const auto& rect = info.rect;
+        if (info.flags & Spr_Rotated) {
+            //Texture holds the sprite turned clockwise, so the quad is rect.height wide and the UVs are rotated back
+            verts[0] = { {rect.height * -0.5f, rect.width * -0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x + rect.width, rect.y}, reso) };
+            verts[1] = { {rect.height * 0.5f, rect.width * -0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x + rect.width, rect.y + rect.height}, reso) };
+            verts[2] = { {rect.height * 0.5f, rect.width * 0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x,              rect.y + rect.height}, reso) };
+            verts[3] = { {rect.height * -0.5f, rect.width * 0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x,              rect.y}, reso) };
+            return;
+        }
+
+        verts[0] = { {rect.width * -0.5f, rect.height * -0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x, rect.y}, reso) };
+        verts[1] = { {rect.width * 0.5f, rect.height * -0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x + rect.width, rect.y}, reso) };
+        verts[2] = { {rect.width * 0.5f, rect.height * 0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x + rect.width, rect.y + rect.height}, reso) };
+        verts[3] = { {rect.width * -0.5f, rect.height * 0.5f}, {0xFF, 0xFF, 0xFF, 0xFF}, pixToUVCoord({rect.x,              rect.y + rect.height}, reso) };
     }
 }
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include <J-Core/Rendering/SpritePacking.h>
+#include <algorithm>
+#include <climits>
+
+namespace JCore {
+    void MaxRectsBin::reset(int32_t width, int32_t height) {
+        _width = width;
+        _height = height;
+        _usedArea = 0;
+        _freeRects.clear();
+        _newRects.clear();
+        _freeRects.emplace_back(0, 0, width, height);
+    }
+
+    void MaxRectsBin::grow(int32_t width, int32_t height) {
+        width = std::max(width, _width);
+        height = std::max(height, _height);
+        if (width == _width && height == _height) { return; }
+
+        //Free rects touching the old edge extend into the new area, the new strips themselves are free too.
+        //Everything is then pruned as new rects since the extended ones can now contain each other.
+        if (width > _width) {
+            for (auto& rect : _freeRects) {
+                if (rect.x + rect.width == _width) {
+                    rect.width = width - rect.x;
+                }
+            }
+            _freeRects.emplace_back(_width, 0, width - _width, _height);
+            _width = width;
+        }
+
+        if (height > _height) {
+            for (auto& rect : _freeRects) {
+                if (rect.y + rect.height == _height) {
+                    rect.height = height - rect.y;
+                }
+            }
+            _freeRects.emplace_back(0, _height, _width, height - _height);
+            _height = height;
+        }
+
+        _newRects.clear();
+        _newRects.swap(_freeRects);
+        pruneFreeRects();
+    }
+
+    bool MaxRectsBin::insert(int32_t width, int32_t height, PackRect& rect, bool allowRotation) {
+        int64_t bestPrimary = INT64_MAX;
+        int64_t bestSecondary = INT64_MAX;
+        findPosition(width, height, rect, bestPrimary, bestSecondary);
+        if (allowRotation && width != height) {
+            //Only strictly better scores replace the upright placement
+            findPosition(height, width, rect, bestPrimary, bestSecondary);
+        }
+
+        if (bestPrimary == INT64_MAX) { return false; }
+        place(rect);
+        _usedArea += uint64_t(width) * uint64_t(height);
+        return true;
+    }
+
+    void MaxRectsBin::findPosition(int32_t width, int32_t height, PackRect& rect, int64_t& bestPrimary, int64_t& bestSecondary) const {
+        for (const auto& free : _freeRects) {
+            if (free.width < width || free.height < height) { continue; }
+
+            const int32_t leftW = free.width - width;
+            const int32_t leftH = free.height - height;
+
+            int64_t primary = 0;
+            int64_t secondary = 0;
+            switch (_heuristic) {
+                default:
+                    primary = std::min(leftW, leftH);
+                    secondary = std::max(leftW, leftH);
+                    break;
+                case MaxRectsHeuristic::BestLongSideFit:
+                    primary = std::max(leftW, leftH);
+                    secondary = std::min(leftW, leftH);
+                    break;
+                case MaxRectsHeuristic::BestAreaFit:
+                    primary = int64_t(free.width) * free.height - int64_t(width) * height;
+                    secondary = std::min(leftW, leftH);
+                    break;
+                case MaxRectsHeuristic::BottomLeft:
+                    primary = free.y + height;
+                    secondary = free.x;
+                    break;
+            }
+
+            if (primary < bestPrimary || (primary == bestPrimary && secondary < bestSecondary)) {
+                rect = PackRect(free.x, free.y, width, height);
+                bestPrimary = primary;
+                bestSecondary = secondary;
+            }
+        }
+    }
+
+    void MaxRectsBin::place(const PackRect& rect) {
+        _newRects.clear();
+        for (size_t i = 0; i < _freeRects.size();) {
+            const PackRect free = _freeRects[i];
+            if (!free.overlaps(rect)) {
+                i++;
+                continue;
+            }
+
+            if (rect.x > free.x) {
+                _newRects.emplace_back(free.x, free.y, rect.x - free.x, free.height);
+            }
+
+            if (rect.x + rect.width < free.x + free.width) {
+                _newRects.emplace_back(rect.x + rect.width, free.y, free.x + free.width - (rect.x + rect.width), free.height);
+            }
+
+            if (rect.y > free.y) {
+                _newRects.emplace_back(free.x, free.y, free.width, rect.y - free.y);
+            }
+
+            if (rect.y + rect.height < free.y + free.height) {
+                _newRects.emplace_back(free.x, rect.y + rect.height, free.width, free.y + free.height - (rect.y + rect.height));
+            }
+
+            _freeRects[i] = _freeRects.back();
+            _freeRects.pop_back();
+        }
+        pruneFreeRects();
+    }
+
+    void MaxRectsBin::pruneFreeRects() {
+        //Only the new rects need to be compared against everything, old ones are already maximal among themselves.
+        for (size_t i = 0; i < _newRects.size();) {
+            const PackRect& rect = _newRects[i];
+            bool contained = false;
+            for (const auto& free : _freeRects) {
+                if (free.contains(rect)) {
+                    contained = true;
+                    break;
+                }
+            }
+
+            for (size_t j = 0; j < _newRects.size() && !contained; j++) {
+                if (j == i) { continue; }
+                contained = _newRects[j].contains(rect);
+            }
+
+            if (contained) {
+                _newRects[i] = _newRects.back();
+                _newRects.pop_back();
+                continue;
+            }
+            i++;
+        }
+
+        for (size_t i = 0; i < _freeRects.size();) {
+            bool contained = false;
+            for (const auto& rect : _newRects) {
+                if (rect.contains(_freeRects[i])) {
+                    contained = true;
+                    break;
+                }
+            }
+
+            if (contained) {
+                _freeRects[i] = _freeRects.back();
+                _freeRects.pop_back();
+                continue;
+            }
+            i++;
+        }
+
+        _freeRects.insert(_freeRects.end(), _newRects.begin(), _newRects.end());
+        _newRects.clear();
+    }
+
+    void SkylineBin::reset(int32_t width, int32_t height) {
+        _width = width;
+        _height = height;
+        _usedArea = 0;
+        _skyline.clear();
+        _skyline.push_back({ 0, 0, width });
+    }
+
+    void SkylineBin::grow(int32_t width, int32_t height) {
+        if (width > _width) {
+            if (_skyline.size() > 0 && _skyline.back().y == 0) {
+                _skyline.back().width += width - _width;
+            }
+            else {
+                _skyline.push_back({ _width, 0, width - _width });
+            }
+            _width = width;
+        }
+        _height = std::max(height, _height);
+    }
+
+    bool SkylineBin::insert(int32_t width, int32_t height, PackRect& rect, bool allowRotation) {
+        int32_t bestTop = INT32_MAX;
+        int32_t bestWidth = INT32_MAX;
+        size_t bestIndex = _skyline.size();
+
+        const int32_t turns = allowRotation && width != height ? 2 : 1;
+        for (int32_t turn = 0; turn < turns; turn++) {
+            const int32_t w = turn ? height : width;
+            const int32_t h = turn ? width : height;
+            for (size_t i = 0; i < _skyline.size(); i++) {
+                int32_t y = 0;
+                if (!fits(i, w, h, y)) { continue; }
+
+                const int32_t top = y + h;
+                if (top < bestTop || (top == bestTop && _skyline[i].width < bestWidth)) {
+                    bestTop = top;
+                    bestWidth = _skyline[i].width;
+                    bestIndex = i;
+                    rect = PackRect(_skyline[i].x, y, w, h);
+                }
+            }
+        }
+
+        if (bestIndex >= _skyline.size()) { return false; }
+        addLevel(bestIndex, rect);
+        _usedArea += uint64_t(width) * uint64_t(height);
+        return true;
+    }
+
+    bool SkylineBin::fits(size_t index, int32_t width, int32_t height, int32_t& y) const {
+        const int32_t x = _skyline[index].x;
+        if (x + width > _width) { return false; }
+
+        y = _skyline[index].y;
+        for (int32_t left = width; left > 0 && index < _skyline.size(); index++) {
+            y = std::max(y, _skyline[index].y);
+            if (y + height > _height) { return false; }
+            left -= _skyline[index].width;
+        }
+        return true;
+    }
+
+    void SkylineBin::addLevel(size_t index, const PackRect& rect) {
+        _skyline.insert(_skyline.begin() + index, { rect.x, rect.y + rect.height, rect.width });
+
+        for (size_t i = index + 1; i < _skyline.size();) {
+            const Segment& prev = _skyline[i - 1];
+            Segment& cur = _skyline[i];
+
+            const int32_t overlap = prev.x + prev.width - cur.x;
+            if (overlap <= 0) { break; }
+
+            cur.x += overlap;
+            cur.width -= overlap;
+            if (cur.width > 0) { break; }
+            _skyline.erase(_skyline.begin() + i);
+        }
+
+        for (size_t i = 0; i + 1 < _skyline.size();) {
+            if (_skyline[i].y == _skyline[i + 1].y) {
+                _skyline[i].width += _skyline[i + 1].width;
+                _skyline.erase(_skyline.begin() + i + 1);
+                continue;
+            }
+            i++;
+        }
+    }
+
+    void ShelfAllocator::reset(int32_t width, int32_t height) {
+        _width = width;
+        _height = height;
+        _top = 0;
+        _usedArea = 0;
+        _shelves.clear();
+        _allocations.clear();
+        _freeIds.clear();
+    }
+
+    uint32_t ShelfAllocator::allocate(int32_t width, int32_t height, PackRect& rect) {
+        if (width < 1 || height < 1 || width > _width || height > _height) { return INVALID_ID; }
+
+        //Tight shelves waste at most half of the rect's height, looser ones are only used once a new shelf doesn't fit.
+        //Empty shelves get split to the exact height so they never waste anything.
+        size_t tight = SIZE_MAX, loose = SIZE_MAX;
+        int32_t tightWaste = INT32_MAX, looseWaste = INT32_MAX;
+        for (size_t i = 0; i < _shelves.size(); i++) {
+            const Shelf& shelf = _shelves[i];
+            if (shelf.height < height || findSpan(shelf, width) < 0) { continue; }
+
+            const int32_t waste = shelf.isEmpty() ? 0 : shelf.height - height;
+            if (waste * 2 <= height) {
+                if (waste < tightWaste) {
+                    tight = i;
+                    tightWaste = waste;
+                }
+            }
+            else if (waste < looseWaste) {
+                loose = i;
+                looseWaste = waste;
+            }
+        }
+
+        size_t index = tight;
+        if (index == SIZE_MAX && _top + height <= _height) {
+            _shelves.push_back({ _top, height, { { 0, _width, INVALID_ID } } });
+            _top += height;
+            index = _shelves.size() - 1;
+        }
+
+        if (index == SIZE_MAX) { index = loose; }
+        if (index == SIZE_MAX) { return INVALID_ID; }
+
+        if (_shelves[index].isEmpty() && _shelves[index].height > height) {
+            Shelf rest{ _shelves[index].y + height, _shelves[index].height - height, { { 0, _width, INVALID_ID } } };
+            _shelves[index].height = height;
+            _shelves.insert(_shelves.begin() + index + 1, std::move(rest));
+        }
+
+        uint32_t id = uint32_t(_allocations.size());
+        if (_freeIds.size() > 0) {
+            id = _freeIds.back();
+            _freeIds.pop_back();
+        }
+        else {
+            _allocations.push_back({});
+        }
+
+        Shelf& shelf = _shelves[index];
+        const size_t spanIndex = size_t(findSpan(shelf, width));
+        const Span span = shelf.spans[spanIndex];
+        shelf.spans[spanIndex] = { span.x, width, id };
+        if (span.width > width) {
+            shelf.spans.insert(shelf.spans.begin() + spanIndex + 1, { span.x + width, span.width - width, INVALID_ID });
+        }
+
+        rect = PackRect(span.x, shelf.y, width, height);
+        _allocations[id] = { rect, true };
+        _usedArea += uint64_t(width) * uint64_t(height);
+        return id;
+    }
+
+    bool ShelfAllocator::free(uint32_t id) {
+        if (!isAllocated(id)) { return false; }
+
+        Allocation& alloc = _allocations[id];
+        alloc.used = false;
+        _freeIds.push_back(id);
+        _usedArea -= uint64_t(alloc.rect.width) * uint64_t(alloc.rect.height);
+
+        const size_t index = findShelf(alloc.rect.y);
+        auto& spans = _shelves[index].spans;
+        size_t spanIndex = size_t(std::lower_bound(spans.begin(), spans.end(), alloc.rect.x,
+            [](const Span& span, int32_t x) { return span.x < x; }) - spans.begin());
+        spans[spanIndex].id = INVALID_ID;
+
+        if (spanIndex + 1 < spans.size() && spans[spanIndex + 1].id == INVALID_ID) {
+            spans[spanIndex].width += spans[spanIndex + 1].width;
+            spans.erase(spans.begin() + spanIndex + 1);
+        }
+
+        if (spanIndex > 0 && spans[spanIndex - 1].id == INVALID_ID) {
+            spans[spanIndex - 1].width += spans[spanIndex].width;
+            spans.erase(spans.begin() + spanIndex);
+        }
+
+        if (_shelves[index].isEmpty()) {
+            mergeEmptyShelves(index);
+        }
+        return true;
+    }
+
+    bool ShelfAllocator::getRect(uint32_t id, PackRect& rect) const {
+        if (!isAllocated(id)) { return false; }
+        rect = _allocations[id].rect;
+        return true;
+    }
+
+    int32_t ShelfAllocator::findSpan(const Shelf& shelf, int32_t width) const {
+        int32_t best = -1;
+        for (size_t i = 0; i < shelf.spans.size(); i++) {
+            const Span& span = shelf.spans[i];
+            if (span.id != INVALID_ID || span.width < width) { continue; }
+            if (best < 0 || span.width < shelf.spans[best].width) {
+                best = int32_t(i);
+            }
+        }
+        return best;
+    }
+
+    size_t ShelfAllocator::findShelf(int32_t y) const {
+        auto find = std::upper_bound(_shelves.begin(), _shelves.end(), y,
+            [](int32_t y, const Shelf& shelf) { return y < shelf.y; });
+        return size_t(find - _shelves.begin()) - 1;
+    }
+
+    void ShelfAllocator::mergeEmptyShelves(size_t index) {
+        if (index + 1 < _shelves.size() && _shelves[index + 1].isEmpty()) {
+            _shelves[index].height += _shelves[index + 1].height;
+            _shelves.erase(_shelves.begin() + index + 1);
+        }
+
+        if (index > 0 && _shelves[index - 1].isEmpty()) {
+            _shelves[index - 1].height += _shelves[index].height;
+            _shelves.erase(_shelves.begin() + index);
+            index--;
+        }
+
+        //Space under the last shelf is handed out as new shelves so there's no point keeping an empty one there
+        if (index + 1 == _shelves.size()) {
+            _top = _shelves[index].y;
+            _shelves.pop_back();
+        }
+    }
+}
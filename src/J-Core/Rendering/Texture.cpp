@@ -94,6 +94,27 @@ namespace JCore {
         return true;
     }
 
+    bool Texture::update(const ImageView& view, int32_t x, int32_t y) {
+        if (!isValid() || !view.pixels) { return false; }
+        if (view.format != _format || view.isIndexed()) {
+            JCORE_WARN("Couldn't update texture, format '{0}' doesn't match '{1}' or is indexed!", getTextureFormatName(view.format), getTextureFormatName(_format));
+            return false;
+        }
+
+        if (x < 0 || y < 0 || x + view.width > _width || y + view.height > _height) {
+            JCORE_WARN("Couldn't update texture, area {0}x{1} at ({2}, {3}) is out of bounds! ({4}x{5})", view.width, view.height, x, y, _width, _height);
+            return false;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, _textureId);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, getGLPixelAlignment(_format));
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, GLint(view.stride / view.getBytesPerPixel()));
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, view.width, view.height, textureFormatToGLFormat(_format, false), textureFormatToGLType(_format), view.pixels);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return true;
+    }
+
 
     uint32_t Texture::bind(uint32_t slot) const {
         glActiveTexture(GL_TEXTURE0 + slot++);
@@ -1,16 +1,84 @@
 #include <J-Core/Util/Bitset.h>
 #include <J-Core/Math/Math.h>
+#include <J-Core/Log.h>
+#include <cstdlib>
+#include <cstring>
 #include <utility>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace JCore {
-    static inline void extractIndices(size_t i, size_t& bIndex, size_t& lIndex) {
-        size_t nI = i >> 3;
-        bIndex = nI;
-        lIndex = i - (nI << 3);
+    static inline uint64_t rangeMask(size_t start, size_t end) {
+        //Bits [start, end) of a single word, end can be 64
+        const uint64_t high = end >= 64 ? UINT64_MAX : (1ULL << end) - 1;
+        return high & ~((1ULL << start) - 1);
+    }
+
+    static inline uint32_t selectInWord(uint64_t word, uint32_t n) {
+        //Narrow down to a byte with popcounts, then drop the lowest set bits one by one
+        uint32_t offset = 0;
+        for (uint32_t width = 32; width >= 8; width >>= 1) {
+            const uint32_t low = detail::popCount64(word & ((1ULL << width) - 1));
+            if (n >= low) {
+                n -= low;
+                word >>= width;
+                offset += width;
+            }
+        }
+
+        for (; n > 0; n--) {
+            word &= word - 1;
+        }
+        return offset + detail::lowestBit64(word);
+    }
+
+    template<typename Op>
+    static void combineWords(uint64_t* dst, const uint64_t* src, size_t count, Op op) {
+        size_t i = 0;
+#ifdef __AVX2__
+        for (; i + 4 <= count; i += 4) {
+            const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            const __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), op(lhs, rhs));
+        }
+#endif
+        for (; i < count; i++) {
+            dst[i] = op(dst[i], src[i]);
+        }
     }
 
+    struct AndOp {
+        uint64_t operator()(uint64_t lhs, uint64_t rhs) const { return lhs & rhs; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i lhs, __m256i rhs) const { return _mm256_and_si256(lhs, rhs); }
+#endif
+    };
+
+    struct OrOp {
+        uint64_t operator()(uint64_t lhs, uint64_t rhs) const { return lhs | rhs; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i lhs, __m256i rhs) const { return _mm256_or_si256(lhs, rhs); }
+#endif
+    };
+
+    struct XorOp {
+        uint64_t operator()(uint64_t lhs, uint64_t rhs) const { return lhs ^ rhs; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i lhs, __m256i rhs) const { return _mm256_xor_si256(lhs, rhs); }
+#endif
+    };
+
+    struct AndNotOp {
+        uint64_t operator()(uint64_t lhs, uint64_t rhs) const { return lhs & ~rhs; }
+#ifdef __AVX2__
+        __m256i operator()(__m256i lhs, __m256i rhs) const { return _mm256_andnot_si256(rhs, lhs); }
+#endif
+    };
+
     Bitset::Bitset() : Bitset(8) {}
-    Bitset::Bitset(size_t bits) : _buffer(nullptr), _bits(0), _capacity(0) {
+    Bitset::Bitset(size_t bits) : _buffer(nullptr), _capacity(0), _bits(0), _rankIndex{}, _rankValid(false) {
         resize(bits);
     }
 
@@ -19,8 +87,10 @@ namespace JCore {
     }
     Bitset::Bitset(Bitset&& other) noexcept :
         _buffer(std::exchange(other._buffer, nullptr)),
+        _capacity(std::exchange(other._capacity, 0)),
         _bits(std::exchange(other._bits, 0)),
-        _capacity(std::exchange(other._capacity, 0))
+        _rankIndex(std::move(other._rankIndex)),
+        _rankValid(std::exchange(other._rankValid, false))
     {
     }
 
@@ -31,17 +101,29 @@ namespace JCore {
         }
     }
 
-    bool Bitset::operator[](size_t i) const {
-        size_t bInd{}, lInd{};
-        extractIndices(i, bInd, lInd);
-        uint8_t byte = _buffer[bInd];
-        return bool(byte & (1 << lInd));
+    Bitset& Bitset::operator=(const Bitset& other) {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    Bitset& Bitset::operator=(Bitset&& other) noexcept {
+        if (this != &other) {
+            if (_buffer) { free(_buffer); }
+            _buffer = std::exchange(other._buffer, nullptr);
+            _capacity = std::exchange(other._capacity, 0);
+            _bits = std::exchange(other._bits, 0);
+            _rankIndex = std::move(other._rankIndex);
+            _rankValid = std::exchange(other._rankValid, false);
+        }
+        return *this;
     }
 
     void Bitset::toString(char* buffer, int32_t width, int32_t height) const {
         for (int32_t y = 0, yP = 0, yPP = 0; y < height; y++, yP += width, yPP += width + 1) {
             for (int32_t x = 0; x < width; x++) {
-                buffer[yP + x] = (*this)[size_t(yP) + x] ? '1' : '0';
+                buffer[yPP + x] = (*this)[size_t(yP) + x] ? '1' : '0';
             }
 
             buffer[yPP + width] = '\n';
@@ -49,65 +131,230 @@ namespace JCore {
     }
 
     void Bitset::flip() {
-        for (size_t i = 0; i < _capacity; i++) {
+        const size_t words = wordCount();
+        for (size_t i = 0; i < words; i++) {
             _buffer[i] = ~_buffer[i];
         }
+        clearTail();
+        _rankValid = false;
     }
     void Bitset::andWith(const Bitset& other) {
-        for (size_t i = 0; i < _capacity; i++) {
-            _buffer[i] &= other._buffer[i];
-        }
+        combineWords(_buffer, other._buffer, Math::min(wordCount(), other.wordCount()), AndOp{});
+        _rankValid = false;
     }
     void Bitset::orWith(const Bitset& other) {
-        for (size_t i = 0; i < _capacity; i++) {
-            _buffer[i] |= other._buffer[i];
-        }
+        combineWords(_buffer, other._buffer, Math::min(wordCount(), other.wordCount()), OrOp{});
+        clearTail();
+        _rankValid = false;
     }
     void Bitset::xorWith(const Bitset& other) {
-        for (size_t i = 0; i < _capacity; i++) {
-            _buffer[i] ^= other._buffer[i];
-        }
+        combineWords(_buffer, other._buffer, Math::min(wordCount(), other.wordCount()), XorOp{});
+        clearTail();
+        _rankValid = false;
+    }
+    void Bitset::andNotWith(const Bitset& other) {
+        combineWords(_buffer, other._buffer, Math::min(wordCount(), other.wordCount()), AndNotOp{});
+        _rankValid = false;
     }
 
     void Bitset::copyFrom(const Bitset& other) {
         resize(other._bits);
-        memcpy(_buffer, other._buffer, _capacity);
+        memcpy(_buffer, other._buffer, other.wordCount() * sizeof(uint64_t));
+        _rankIndex = other._rankIndex;
+        _rankValid = other._rankValid;
+    }
+
+    void Bitset::setAll(bool value) {
+        memset(_buffer, value ? 0xFF : 0x00, wordCount() * sizeof(uint64_t));
+        clearTail();
+        _rankValid = false;
     }
 
-    void Bitset::set(size_t i, bool value) {
-        size_t bInd{}, lInd{};
-        extractIndices(i, bInd, lInd);
-        uint8_t mask = uint8_t(1 << lInd);
+    void Bitset::setRange(size_t start, size_t count, bool value) {
+        if (start >= _bits) { return; }
+        const size_t end = count > _bits - start ? _bits : start + count;
+        if (end <= start) { return; }
+
+        const size_t first = start >> 6;
+        const size_t last = (end - 1) >> 6;
+        _rankValid = false;
+
+        if (first == last) {
+            const uint64_t mask = rangeMask(start & 63, end - (first << 6));
+            _buffer[first] = value ? (_buffer[first] | mask) : (_buffer[first] & ~mask);
+            return;
+        }
 
-        uint8_t& byte = _buffer[bInd];
-        byte = value ? (byte | mask) : (byte & ~mask);
+        const uint64_t firstMask = rangeMask(start & 63, 64);
+        const uint64_t lastMask = rangeMask(0, end - (last << 6));
+        _buffer[first] = value ? (_buffer[first] | firstMask) : (_buffer[first] & ~firstMask);
+        memset(_buffer + first + 1, value ? 0xFF : 0x00, (last - first - 1) * sizeof(uint64_t));
+        _buffer[last] = value ? (_buffer[last] | lastMask) : (_buffer[last] & ~lastMask);
     }
 
-    void Bitset::setAll(bool value) {
-        memset(_buffer, value ? 0xFFFFFFFFU : 0x00, _capacity);
+    size_t Bitset::count() const {
+        size_t total = 0;
+        const size_t words = wordCount();
+        for (size_t i = 0; i < words; i++) {
+            total += detail::popCount64(_buffer[i]);
+        }
+        return total;
+    }
+
+    size_t Bitset::countRange(size_t start, size_t count) const {
+        if (start >= _bits) { return 0; }
+        const size_t end = count > _bits - start ? _bits : start + count;
+        return end > start ? rank(end) - rank(start) : 0;
+    }
+
+    bool Bitset::any() const {
+        const size_t words = wordCount();
+        for (size_t i = 0; i < words; i++) {
+            if (_buffer[i]) { return true; }
+        }
+        return false;
+    }
+
+    bool Bitset::all() const {
+        const size_t words = wordCount();
+        if (words < 1) { return true; }
+        for (size_t i = 0; i < words - 1; i++) {
+            if (_buffer[i] != UINT64_MAX) { return false; }
+        }
+        return _buffer[words - 1] == rangeMask(0, _bits - ((words - 1) << 6));
+    }
+
+    size_t Bitset::findNextSet(size_t from) const {
+        if (from >= _bits) { return npos; }
+
+        size_t index = from >> 6;
+        uint64_t word = _buffer[index] & ~((1ULL << (from & 63)) - 1);
+        const size_t words = wordCount();
+        while (!word) {
+            if (++index >= words) { return npos; }
+            word = _buffer[index];
+        }
+        return (index << 6) + detail::lowestBit64(word);
+    }
+
+    size_t Bitset::findNextClear(size_t from) const {
+        if (from >= _bits) { return npos; }
+
+        size_t index = from >> 6;
+        uint64_t word = ~_buffer[index] & ~((1ULL << (from & 63)) - 1);
+        const size_t words = wordCount();
+        while (!word) {
+            if (++index >= words) { return npos; }
+            word = ~_buffer[index];
+        }
+
+        //Cleared tail bits aren't part of the set
+        const size_t found = (index << 6) + detail::lowestBit64(word);
+        return found < _bits ? found : npos;
+    }
+
+    void Bitset::buildRankIndex() {
+        const size_t words = wordCount();
+        _rankIndex.resize(words / RANK_BLOCK_WORDS + 1);
+
+        uint64_t total = 0;
+        for (size_t i = 0; i < words; i++) {
+            if ((i % RANK_BLOCK_WORDS) == 0) {
+                _rankIndex[i / RANK_BLOCK_WORDS] = total;
+            }
+            total += detail::popCount64(_buffer[i]);
+        }
+
+        if ((words % RANK_BLOCK_WORDS) == 0) {
+            _rankIndex[words / RANK_BLOCK_WORDS] = total;
+        }
+        _rankValid = true;
+    }
+
+    size_t Bitset::rank(size_t i) const {
+        i = Math::min(i, _bits);
+        const size_t wordIndex = i >> 6;
+
+        size_t total = 0;
+        size_t word = 0;
+        if (_rankValid) {
+            word = (wordIndex / RANK_BLOCK_WORDS) * RANK_BLOCK_WORDS;
+            total = size_t(_rankIndex[wordIndex / RANK_BLOCK_WORDS]);
+        }
+
+        for (; word < wordIndex; word++) {
+            total += detail::popCount64(_buffer[word]);
+        }
+
+        if (i & 63) {
+            total += detail::popCount64(_buffer[wordIndex] & ((1ULL << (i & 63)) - 1));
+        }
+        return total;
+    }
+
+    size_t Bitset::select(size_t n) const {
+        const size_t words = wordCount();
+        size_t word = 0;
+        if (_rankValid && _rankIndex.size() > 1) {
+            //Last block whose starting rank is still <= n
+            size_t lo = 0, hi = (words - 1) / RANK_BLOCK_WORDS;
+            while (lo < hi) {
+                const size_t mid = (lo + hi + 1) >> 1;
+                if (_rankIndex[mid] <= n) { lo = mid; }
+                else { hi = mid - 1; }
+            }
+            word = lo * RANK_BLOCK_WORDS;
+            n -= size_t(_rankIndex[lo]);
+        }
+
+        for (; word < words; word++) {
+            const size_t bits = detail::popCount64(_buffer[word]);
+            if (n < bits) {
+                return (word << 6) + selectInWord(_buffer[word], uint32_t(n));
+            }
+            n -= bits;
+        }
+        return npos;
     }
 
     void Bitset::resize(size_t bits) {
-        size_t requiredBytes = Math::nextDivByPowOf2<size_t, 8>(bits) >> 3;
+        const size_t requiredWords = Math::max<size_t>((bits + 63) >> 6, 1);
+        const size_t oldWords = wordCount();
         _bits = bits;
+        _rankValid = false;
+
         if (_buffer) {
-            if (requiredBytes != _capacity) {
-                void* reloc = realloc(_buffer, requiredBytes);
-                if (reloc) {
-                    _buffer = reinterpret_cast<uint8_t*>(reloc);
-                    if (_capacity < requiredBytes) {
-                        memset(_buffer + _capacity, 0, requiredBytes - int64_t(_capacity));
-                    }
-                    _capacity = requiredBytes;
+            if (requiredWords != _capacity) {
+                void* reloc = realloc(_buffer, requiredWords * sizeof(uint64_t));
+                if (!reloc) {
+                    JCORE_ERROR("[J-Core - Bitset] Error: Failed to resize bitset to {0} bits!", bits);
+                    _bits = Math::min(_bits, oldWords << 6);
+                    clearTail();
+                    return;
                 }
+                _buffer = reinterpret_cast<uint64_t*>(reloc);
+                _capacity = requiredWords;
             }
+
+            //Growing exposes the old tail & any new words, both have to read as cleared
+            if (requiredWords > oldWords) {
+                memset(_buffer + oldWords, 0, (requiredWords - oldWords) * sizeof(uint64_t));
+            }
+            clearTail();
             return;
         }
 
-        _buffer = reinterpret_cast<uint8_t*>(malloc(requiredBytes));
-        _capacity = requiredBytes;
+        _buffer = reinterpret_cast<uint64_t*>(malloc(requiredWords * sizeof(uint64_t)));
+        _capacity = requiredWords;
         if (_buffer) {
-            memset(_buffer, 0, _capacity);
+            memset(_buffer, 0, _capacity * sizeof(uint64_t));
+        }
+    }
+
+    void Bitset::clearTail() {
+        const size_t used = _bits & 63;
+        if (used && _buffer) {
+            _buffer[_bits >> 6] &= (1ULL << used) - 1;
         }
     }
-}
\ No newline at end of file
+}
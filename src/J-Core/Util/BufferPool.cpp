@@ -0,0 +1,137 @@
+#include <J-Core/Util/BufferPool.h>
+#include <cstdlib>
+#include <malloc.h>
+
+namespace JCore {
+    static constexpr size_t MAX_POOLED = size_t(1) << BufferPool::MAX_CLASS_SHIFT;
+
+    static inline size_t floorLog2(size_t value) {
+        size_t bits = 0;
+        while (value >>= 1) { bits++; }
+        return bits;
+    }
+
+    BufferPool::BufferPool(size_t maxCachedBytes) : _mutex(), _classes{}, _cachedBytes(0), _maxCachedBytes(maxCachedBytes) {}
+    BufferPool::~BufferPool() {
+        trim(0);
+    }
+
+    BufferPool& BufferPool::getGlobal() {
+        static BufferPool pool{};
+        return pool;
+    }
+
+    size_t BufferPool::getClassIndex(size_t size) {
+        if (size <= ALIGNMENT) { return 0; }
+
+        size_t shift = floorLog2(size - 1);
+        size_t base = size_t(1) << shift;
+        size_t step = base >> 2;
+        size_t sub = (size - base + step - 1) / step;
+        if (sub >= 4) {
+            shift++;
+            sub = 0;
+        }
+        return (shift - MIN_CLASS_SHIFT) * 4 + sub;
+    }
+
+    size_t BufferPool::getClassSize(size_t index) {
+        size_t base = size_t(1) << (MIN_CLASS_SHIFT + (index >> 2));
+        return base + (index & 0x3) * (base >> 2);
+    }
+
+    size_t BufferPool::getCapacity(size_t size) {
+        if (size > MAX_POOLED) {
+            return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+        return getClassSize(getClassIndex(size));
+    }
+
+    uint8_t* BufferPool::allocateAligned(size_t size) {
+#ifdef _WIN32
+        return reinterpret_cast<uint8_t*>(_aligned_malloc(size, ALIGNMENT));
+#else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, ALIGNMENT, size) == 0 ? reinterpret_cast<uint8_t*>(ptr) : nullptr;
+#endif
+    }
+
+    void BufferPool::freeAligned(void* ptr) {
+        if (!ptr) { return; }
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+
+    uint8_t* BufferPool::allocate(size_t size, size_t& capacity) {
+        capacity = getCapacity(size);
+        if (capacity > MAX_POOLED) {
+            return allocateAligned(capacity);
+        }
+
+        size_t index = getClassIndex(size);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto& cls = _classes[index];
+            if (cls.size() > 0) {
+                void* ptr = cls.back();
+                cls.pop_back();
+                _cachedBytes -= capacity;
+                return reinterpret_cast<uint8_t*>(ptr);
+            }
+        }
+        return allocateAligned(capacity);
+    }
+
+    void BufferPool::deallocate(void* ptr, size_t capacity) {
+        if (!ptr) { return; }
+        if (capacity <= MAX_POOLED) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (capacity <= _maxCachedBytes) {
+                _classes[getClassIndex(capacity)].push_back(ptr);
+                _cachedBytes += capacity;
+
+                if (_cachedBytes > _maxCachedBytes) {
+                    trimLocked(_maxCachedBytes);
+                }
+                return;
+            }
+        }
+        freeAligned(ptr);
+    }
+
+    void BufferPool::trim(size_t targetBytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        trimLocked(targetBytes);
+    }
+
+    void BufferPool::trimLocked(size_t targetBytes) {
+        for (size_t i = CLASS_COUNT; i > 0 && _cachedBytes > targetBytes; i--) {
+            auto& cls = _classes[i - 1];
+            const size_t clsSize = getClassSize(i - 1);
+            while (cls.size() > 0 && _cachedBytes > targetBytes) {
+                freeAligned(cls.back());
+                cls.pop_back();
+                _cachedBytes -= clsSize;
+            }
+        }
+    }
+
+    size_t BufferPool::getCachedBytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cachedBytes;
+    }
+
+    size_t BufferPool::getMaxCachedBytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _maxCachedBytes;
+    }
+
+    void BufferPool::setMaxCachedBytes(size_t bytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxCachedBytes = bytes;
+        trimLocked(_maxCachedBytes);
+    }
+}
@@ -0,0 +1,83 @@
+#include <J-Core/Util/StringId.h>
+#include <J-Core/Log.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace JCore {
+    static constexpr size_t STRING_BLOCK_SIZE = 64 * 1024;
+
+    //Text is copied into large blocks that are never freed or moved, so handed out views stay valid
+    struct StringTable {
+        std::shared_mutex mutex{};
+        FlatMap<uint64_t, std::string_view> lut{};
+        std::vector<std::unique_ptr<char[]>> blocks{};
+        char* current{ nullptr };
+        size_t remaining{ 0 };
+
+        std::string_view store(std::string_view str) {
+            const size_t required = str.length() + 1;
+            char* ptr = nullptr;
+            if (required > STRING_BLOCK_SIZE / 4) {
+                //Long strings get a block of their own so they don't waste the rest of the current one
+                ptr = blocks.emplace_back(std::make_unique<char[]>(required)).get();
+            }
+            else {
+                if (required > remaining) {
+                    current = blocks.emplace_back(std::make_unique<char[]>(STRING_BLOCK_SIZE)).get();
+                    remaining = STRING_BLOCK_SIZE;
+                }
+                ptr = current;
+                current += required;
+                remaining -= required;
+            }
+
+            memcpy(ptr, str.data(), str.length());
+            ptr[str.length()] = 0;
+            return std::string_view(ptr, str.length());
+        }
+    };
+
+    static StringTable& getStringTable() {
+        static StringTable table{};
+        return table;
+    }
+
+    StringId StringId::intern(std::string_view str) {
+        const StringId id(str);
+        if (!id.isValid()) { return id; }
+
+        StringTable& table = getStringTable();
+        {
+            std::shared_lock<std::shared_mutex> lock(table.mutex);
+            const std::string_view* existing = table.lut.tryGet(id._hash);
+            if (existing && *existing == str) { return id; }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(table.mutex);
+        auto result = table.lut.tryEmplace(id._hash);
+        if (result.second) {
+            result.first->second = table.store(str);
+        }
+        else if (result.first->second != str) {
+            JCORE_ERROR("[J-Core - StringId] Error: Hash collision between '{0}' and '{1}' (0x{2:X})!", result.first->second, str, id._hash);
+        }
+        return id;
+    }
+
+    size_t StringId::getInternedCount() {
+        StringTable& table = getStringTable();
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        return table.lut.size();
+    }
+
+    std::string_view StringId::toString() const {
+        if (!isValid()) { return std::string_view(); }
+
+        StringTable& table = getStringTable();
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        const std::string_view* str = table.lut.tryGet(_hash);
+        return str ? *str : std::string_view();
+    }
+}
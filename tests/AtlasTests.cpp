@@ -0,0 +1,166 @@
+#include "Tests.h"
+#include <J-Core/Rendering/Atlas.h>
+#include <J-Core/Rendering/Sprite.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace JCore;
+
+namespace {
+    struct TestSprite {
+        ImageView view{};
+
+        int32_t getWidth() const { return view.width; }
+        int32_t getHeight() const { return view.height; }
+    };
+
+    //Random pixels in mostly long & thin sprites, so the packers actually have a reason to rotate some of them
+    void makeSprites(TextureFormat format, size_t count, uint32_t seed, std::vector<ImageData>& images) {
+        std::mt19937 rng(seed);
+        images.resize(count);
+        for (auto& image : images) {
+            int32_t width = 8 + int32_t(rng() % 56);
+            int32_t height = 2 + int32_t(rng() % 14);
+            if (rng() & 1) { std::swap(width, height); }
+
+            image.doAllocate(width, height, format);
+            const size_t bytes = size_t(width) * height * (getBitsPerPixel(format) >> 3);
+            for (size_t i = 0; i < bytes; i++) {
+                image.data[i] = uint8_t(rng());
+            }
+        }
+    }
+
+    void freeSprites(std::vector<ImageData>& images) {
+        for (auto& image : images) {
+            image.clear(true);
+        }
+        images.clear();
+    }
+
+    //Reads pixel (x, y) of a sprite back from the atlas through its quad, UVs are interpolated at the pixel's center
+    const uint8_t* samplePixel(const ImageView& atlas, const Vertex* verts, int32_t width, int32_t height, int32_t x, int32_t y) {
+        const float s = (x + 0.5f) / width;
+        const float t = (y + 0.5f) / height;
+        const glm::vec2 uv =
+            verts[0].uv * ((1.0f - s) * (1.0f - t)) + verts[1].uv * (s * (1.0f - t)) +
+            verts[2].uv * (s * t) + verts[3].uv * ((1.0f - s) * t);
+
+        const int32_t pX = int32_t(std::floor(uv.x * atlas.width));
+        const int32_t pY = int32_t(std::floor(uv.y * atlas.height));
+        if (pX < 0 || pY < 0 || pX >= atlas.width || pY >= atlas.height) { return nullptr; }
+        return atlas.getPixel(pX, pY);
+    }
+
+    bool checkPage(const AtlasDefiniton& page, const ImageView& atlas, const std::vector<ImageView>& sources, uint8_t padding, size_t& rotated) {
+        for (const auto& region : page.atlas) {
+            const ImageView& src = sources[region.original];
+
+            //Region rects include the padding, sprites only cover the pixels
+            SpriteInfo info("", SpriteRect(region.rect.x, region.rect.y, region.rect.width - padding, region.rect.height - padding), region.flags);
+            Vertex verts[4]{};
+            Sprite::buildVerts(info, { page.width, page.height }, verts);
+
+            JCORE_CHECK(int32_t(verts[1].position.x - verts[0].position.x) == src.width);
+            JCORE_CHECK(int32_t(verts[3].position.y - verts[0].position.y) == src.height);
+
+            for (int32_t y = 0; y < src.height; y++) {
+                for (int32_t x = 0; x < src.width; x++) {
+                    const uint8_t* pixel = samplePixel(atlas, verts, src.width, src.height, x, y);
+                    JCORE_CHECK(pixel != nullptr);
+                    JCORE_CHECK(memcmp(pixel, src.getPixel(x, y), src.getBytesPerPixel()) == 0);
+                }
+            }
+            rotated += region.isRotated() ? 1 : 0;
+        }
+        return true;
+    }
+
+    bool checkRoundTrip(TextureFormat format, const std::vector<AtlasDefiniton>& pages, const std::vector<ImageData>& images, uint8_t padding, size_t& rotated) {
+        std::vector<ImageView> sources{};
+        for (const auto& image : images) {
+            sources.push_back(image.getView());
+        }
+
+        AtlasCompositeSpecs specs{};
+        specs.format = format;
+        specs.padding = padding;
+
+        size_t regions = 0;
+        for (const auto& page : pages) {
+            ImageData atlas{};
+            JCORE_CHECK(composeAtlas(page, sources.data(), sources.size(), atlas, specs));
+
+            const bool passed = checkPage(page, atlas.getView(), sources, padding, rotated);
+            atlas.clear(true);
+            JCORE_CHECK(passed);
+            regions += page.atlas.size();
+        }
+        JCORE_CHECK(regions == images.size());
+        return true;
+    }
+
+    bool packRectsRoundTrip(TextureFormat format, uint32_t seed) {
+        std::vector<ImageData> images{};
+        makeSprites(format, 200, seed, images);
+
+        std::vector<PackingItem> items{};
+        for (size_t i = 0; i < images.size(); i++) {
+            items.emplace_back(uint32_t(i), uint16_t(images[i].width), uint16_t(images[i].height));
+        }
+
+        //Small pages so some sprites spill over to a second one
+        RectPackingSpecs specs{};
+        specs.allowRotation = true;
+        specs.maxSize = 256;
+        specs.padding = 2;
+
+        std::vector<AtlasDefiniton> pages{};
+        size_t rotated = 0;
+        const bool packed = packRects(items.data(), items.size(), specs, pages);
+        const bool passed = packed && checkRoundTrip(format, pages, images, specs.padding, rotated);
+        freeSprites(images);
+
+        JCORE_CHECK(packed);
+        JCORE_CHECK(passed);
+        JCORE_CHECK(rotated > 0);
+        return true;
+    }
+}
+
+JCORE_TEST(packRectsRotationRoundTripRGBA32) {
+    return packRectsRoundTrip(TextureFormat::RGBA32, 1);
+}
+
+JCORE_TEST(packRectsRotationRoundTripRGB24) {
+    return packRectsRoundTrip(TextureFormat::RGB24, 2);
+}
+
+JCORE_TEST(packSpritesGuillotineRotation) {
+    std::vector<ImageData> images{};
+    makeSprites(TextureFormat::RGBA32, 100, 3, images);
+
+    std::vector<TestSprite> sprites{};
+    for (const auto& image : images) {
+        sprites.push_back({ image.getView() });
+    }
+
+    //Guillotine can't rotate, so this has to go through MaxRects
+    TexturePackingSpecs<TestSprite> specs{};
+    specs.sprites = sprites.data();
+    specs.spriteCount = sprites.size();
+    specs.allowRotation = true;
+    specs.maxSize = 512;
+
+    std::vector<AtlasDefiniton> pages{};
+    size_t rotated = 0;
+    const bool packed = packSprites(specs, pages);
+    const bool passed = packed && checkRoundTrip(TextureFormat::RGBA32, pages, images, 0, rotated);
+    freeSprites(images);
+
+    JCORE_CHECK(packed);
+    JCORE_CHECK(passed);
+    JCORE_CHECK(rotated > 0);
+    return true;
+}
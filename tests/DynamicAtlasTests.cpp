@@ -0,0 +1,136 @@
+#include "Tests.h"
+#include <J-Core/Rendering/DynamicAtlas.h>
+#include <cstring>
+
+using namespace JCore;
+
+//Nothing here calls flush(), the only part of DynamicAtlas that needs a GL context
+
+namespace {
+    //Image 'i' is filled with bytes of first + i, so every sprite's pixels can be told apart in the atlas
+    struct SpriteImages {
+        std::vector<ImageData> images{};
+
+        SpriteImages(size_t count, int32_t width, int32_t height, uint8_t first = 1) : images(count) {
+            for (size_t i = 0; i < count; i++) {
+                images[i].doAllocate(width, height, TextureFormat::RGBA32);
+                memset(images[i].data, int(first + i), size_t(width) * height * sizeof(Color32));
+            }
+        }
+
+        ~SpriteImages() {
+            for (auto& image : images) {
+                image.clear(true);
+            }
+        }
+    };
+
+    size_t countPixels(const DynamicAtlas& atlas, uint8_t value) {
+        const ImageView pixels = atlas.getPixels().getView();
+        const uint8_t expected[4]{ value, value, value, value };
+
+        size_t count = 0;
+        for (int32_t y = 0; y < pixels.height; y++) {
+            for (int32_t x = 0; x < pixels.width; x++) {
+                count += memcmp(pixels.getPixel(x, y), expected, sizeof(expected)) == 0 ? 1 : 0;
+            }
+        }
+        return count;
+    }
+}
+
+JCORE_TEST(dynamicAtlasEvictsLeastRecentlyUsed) {
+    //Room for exactly four sprites
+    DynamicAtlas atlas(64, 64, 0);
+    SpriteImages sprites(6, 32, 32);
+
+    DynamicAtlas::Handle handles[6]{};
+    for (size_t i = 0; i < 4; i++) {
+        handles[i] = atlas.add(sprites.images[i], "sprite" + std::to_string(i));
+        JCORE_CHECK(handles[i].isValid());
+    }
+    JCORE_CHECK(atlas.getSpriteCount() == 4);
+    JCORE_CHECK(atlas.getEvictionCount() == 0);
+
+    //Sprite 0 is the oldest but was just used, so sprite 1 goes first & sprite 2 after it
+    atlas.nextFrame();
+    atlas.touch(handles[0]);
+
+    handles[4] = atlas.add(sprites.images[4], "sprite4");
+    JCORE_CHECK(handles[4].isValid());
+    JCORE_CHECK(atlas.getEvictionCount() == 1);
+    JCORE_CHECK(!atlas.contains(handles[1]));
+    JCORE_CHECK(atlas.getSprite(handles[1]) == nullptr);
+    JCORE_CHECK(!atlas.findByName("sprite1").isValid());
+    JCORE_CHECK(atlas.contains(handles[0]) && atlas.contains(handles[2]) && atlas.contains(handles[3]));
+    JCORE_CHECK(atlas.findByName("sprite4") == handles[4]);
+
+    //The new sprite took over the evicted one's pixels
+    JCORE_CHECK(countPixels(atlas, 2) == 0);
+    JCORE_CHECK(countPixels(atlas, 5) == 32 * 32);
+
+    handles[5] = atlas.add(sprites.images[5], "sprite5");
+    JCORE_CHECK(handles[5].isValid());
+    JCORE_CHECK(atlas.getEvictionCount() == 2);
+    JCORE_CHECK(!atlas.contains(handles[2]));
+    JCORE_CHECK(atlas.contains(handles[3]));
+
+    //Sprites used this frame are never evicted, even if that means the add fails
+    atlas.touch(handles[3]);
+    JCORE_CHECK(!atlas.add(sprites.images[1], "sprite1").isValid());
+    JCORE_CHECK(atlas.getSpriteCount() == 4);
+    JCORE_CHECK(atlas.getEvictionCount() == 2);
+
+    atlas.nextFrame();
+    JCORE_CHECK(atlas.add(sprites.images[1], "sprite1").isValid());
+    JCORE_CHECK(atlas.getEvictionCount() == 3);
+    return true;
+}
+
+JCORE_TEST(dynamicAtlasStaleHandles) {
+    DynamicAtlas atlas(64, 64, 0);
+    SpriteImages sprites(2, 16, 16);
+
+    const DynamicAtlas::Handle first = atlas.add(sprites.images[0], "first");
+    JCORE_CHECK(atlas.remove(first));
+    JCORE_CHECK(!atlas.remove(first));
+    JCORE_CHECK(!atlas.contains(first));
+    JCORE_CHECK(!atlas.findByName("first").isValid());
+
+    //The slot is reused, the old handle must not see the new sprite
+    const DynamicAtlas::Handle second = atlas.add(sprites.images[1], "second");
+    JCORE_CHECK(second.index == first.index);
+    JCORE_CHECK(second != first);
+    JCORE_CHECK(atlas.getSprite(first) == nullptr);
+    JCORE_CHECK(atlas.getSprite(second) != nullptr);
+    JCORE_CHECK(atlas.findByName("second") == second);
+    JCORE_CHECK(atlas.getSpriteCount() == 1);
+    return true;
+}
+
+JCORE_TEST(dynamicAtlasDirtyRects) {
+    //Sprites are 15 pixels, so with the padding every rect is 16 pixels
+    DynamicAtlas atlas(128, 128, 1);
+    SpriteImages small(2, 15, 15);
+    SpriteImages tall(1, 15, 31, 3);
+    JCORE_CHECK(atlas.getDirtyRects().size() == 0);
+
+    JCORE_CHECK(atlas.add(small.images[0]).isValid());
+    JCORE_CHECK(atlas.getDirtyRects().size() == 1);
+    const PackRect first = atlas.getDirtyRects()[0];
+    JCORE_CHECK(first.x == 0 && first.y == 0 && first.width == 16 && first.height == 16);
+
+    //Touching rects merge into their bounds
+    JCORE_CHECK(atlas.add(small.images[1]).isValid());
+    JCORE_CHECK(atlas.add(tall.images[0]).isValid());
+    JCORE_CHECK(atlas.getDirtyRects().size() == 1);
+    const PackRect merged = atlas.getDirtyRects()[0];
+    JCORE_CHECK(merged.x == 0 && merged.y == 0 && merged.width == 32 && merged.height == 48);
+
+    //Padding is cleared, only the sprites' own pixels are written
+    JCORE_CHECK(countPixels(atlas, 1) == 15 * 15);
+    JCORE_CHECK(countPixels(atlas, 2) == 15 * 15);
+    JCORE_CHECK(countPixels(atlas, 3) == 15 * 31);
+    JCORE_CHECK(countPixels(atlas, 0) == 128 * 128 - 2 * 15 * 15 - 15 * 31);
+    return true;
+}
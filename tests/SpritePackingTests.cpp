@@ -0,0 +1,147 @@
+#include "Tests.h"
+#include <J-Core/Rendering/SpritePacking.h>
+#include <random>
+
+using namespace JCore;
+
+namespace {
+    bool checkRect(const PackRect& rect, int32_t x, int32_t y, int32_t width, int32_t height) {
+        return rect.x == x && rect.y == y && rect.width == width && rect.height == height;
+    }
+}
+
+JCORE_TEST(shelfAllocatorAllocateFree) {
+    ShelfAllocator allocator(64, 64);
+    PackRect rect{};
+
+    //Same height rects share a shelf, left to right
+    uint32_t ids[5]{};
+    for (int32_t i = 0; i < 4; i++) {
+        ids[i] = allocator.allocate(16, 16, rect);
+        JCORE_CHECK(ids[i] != ShelfAllocator::INVALID_ID);
+        JCORE_CHECK(checkRect(rect, i * 16, 0, 16, 16));
+    }
+    JCORE_CHECK(allocator.getShelfCount() == 1);
+
+    ids[4] = allocator.allocate(16, 16, rect);
+    JCORE_CHECK(checkRect(rect, 0, 16, 16, 16));
+    JCORE_CHECK(allocator.getShelfCount() == 2);
+    JCORE_CHECK(allocator.getAllocationCount() == 5);
+    JCORE_CHECK(allocator.getUsedArea() == 5 * 16 * 16);
+
+    //Too big for the atlas or for what's left under the last shelf
+    JCORE_CHECK(allocator.allocate(65, 1, rect) == ShelfAllocator::INVALID_ID);
+    JCORE_CHECK(allocator.allocate(16, 40, rect) == ShelfAllocator::INVALID_ID);
+    JCORE_CHECK(allocator.allocate(0, 16, rect) == ShelfAllocator::INVALID_ID);
+
+    JCORE_CHECK(allocator.free(ids[1]));
+    JCORE_CHECK(!allocator.free(ids[1]));
+    JCORE_CHECK(!allocator.isAllocated(ids[1]));
+    JCORE_CHECK(!allocator.getRect(ids[1], rect));
+    JCORE_CHECK(!allocator.free(ShelfAllocator::INVALID_ID));
+    JCORE_CHECK(allocator.getUsedArea() == 4 * 16 * 16);
+
+    //Freed ids & their space are handed out again
+    const uint32_t reused = allocator.allocate(16, 16, rect);
+    JCORE_CHECK(reused == ids[1]);
+    JCORE_CHECK(checkRect(rect, 16, 0, 16, 16));
+    return true;
+}
+
+JCORE_TEST(shelfAllocatorCoalesce) {
+    ShelfAllocator allocator(64, 64);
+    PackRect rect{};
+
+    uint32_t ids[4]{};
+    for (auto& id : ids) {
+        id = allocator.allocate(16, 16, rect);
+    }
+
+    //Neighbouring free spans merge, so a rect as wide as both fits where they were
+    JCORE_CHECK(allocator.free(ids[0]));
+    JCORE_CHECK(allocator.free(ids[1]));
+    const uint32_t wide = allocator.allocate(32, 16, rect);
+    JCORE_CHECK(wide != ShelfAllocator::INVALID_ID);
+    JCORE_CHECK(checkRect(rect, 0, 0, 32, 16));
+
+    //Emptying every shelf gives the whole atlas back
+    JCORE_CHECK(allocator.free(wide));
+    JCORE_CHECK(allocator.free(ids[2]));
+    JCORE_CHECK(allocator.free(ids[3]));
+    JCORE_CHECK(allocator.getShelfCount() == 0);
+    JCORE_CHECK(allocator.getUsedArea() == 0);
+    JCORE_CHECK(allocator.getAllocationCount() == 0);
+
+    JCORE_CHECK(allocator.allocate(64, 64, rect) != ShelfAllocator::INVALID_ID);
+    JCORE_CHECK(checkRect(rect, 0, 0, 64, 64));
+    return true;
+}
+
+JCORE_TEST(shelfAllocatorSplitsEmptyShelves) {
+    ShelfAllocator allocator(64, 64);
+    PackRect rect{};
+
+    const uint32_t a = allocator.allocate(64, 16, rect);
+    const uint32_t b = allocator.allocate(64, 16, rect);
+    JCORE_CHECK(allocator.allocate(64, 8, rect) != ShelfAllocator::INVALID_ID);
+    JCORE_CHECK(allocator.getShelfCount() == 3);
+
+    //The two emptied shelves merge into one 32 pixels tall...
+    JCORE_CHECK(allocator.free(a));
+    JCORE_CHECK(allocator.free(b));
+    JCORE_CHECK(allocator.getShelfCount() == 2);
+
+    //...which can then be split for a height neither of them had
+    JCORE_CHECK(allocator.allocate(64, 24, rect) != ShelfAllocator::INVALID_ID);
+    JCORE_CHECK(checkRect(rect, 0, 0, 64, 24));
+    JCORE_CHECK(allocator.getShelfCount() == 3);
+    JCORE_CHECK(allocator.allocate(64, 8, rect) != ShelfAllocator::INVALID_ID);
+    JCORE_CHECK(checkRect(rect, 0, 24, 64, 8));
+    return true;
+}
+
+JCORE_TEST(shelfAllocatorRandom) {
+    ShelfAllocator allocator(256, 256);
+    std::mt19937 rng(7);
+    std::vector<uint32_t> live{};
+
+    for (int32_t i = 0; i < 20000; i++) {
+        PackRect rect{};
+        if (live.size() > 0 && (rng() & 1)) {
+            const size_t index = rng() % live.size();
+            JCORE_CHECK(allocator.free(live[index]));
+            live[index] = live.back();
+            live.pop_back();
+        }
+        else {
+            const uint32_t id = allocator.allocate(1 + int32_t(rng() % 40), 1 + int32_t(rng() % 40), rect);
+            if (id != ShelfAllocator::INVALID_ID) {
+                JCORE_CHECK(rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= 256 && rect.y + rect.height <= 256);
+                live.push_back(id);
+            }
+        }
+
+        if (i % 1000 != 0) { continue; }
+
+        uint64_t area = 0;
+        for (size_t j = 0; j < live.size(); j++) {
+            PackRect a{};
+            JCORE_CHECK(allocator.getRect(live[j], a));
+            area += uint64_t(a.width) * uint64_t(a.height);
+            for (size_t k = j + 1; k < live.size(); k++) {
+                PackRect b{};
+                allocator.getRect(live[k], b);
+                JCORE_CHECK(!a.overlaps(b));
+            }
+        }
+        JCORE_CHECK(area == allocator.getUsedArea());
+        JCORE_CHECK(live.size() == allocator.getAllocationCount());
+    }
+
+    for (uint32_t id : live) {
+        JCORE_CHECK(allocator.free(id));
+    }
+    JCORE_CHECK(allocator.getShelfCount() == 0);
+    JCORE_CHECK(allocator.getUsedArea() == 0);
+    return true;
+}
@@ -0,0 +1,30 @@
+#include "Tests.h"
+#include <J-Core/Log.h>
+#include <cstring>
+
+namespace JCore::Tests {
+    std::vector<TestCase>& getTests() {
+        static std::vector<TestCase> tests{};
+        return tests;
+    }
+}
+
+//Runs every test, or only the ones whose name contains the first argument
+int main(int argc, char** argv) {
+    JCore::Log::init();
+
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    size_t ran = 0, failed = 0;
+    for (const auto& test : JCore::Tests::getTests()) {
+        if (filter && !strstr(test.name, filter)) { continue; }
+
+        printf("[ RUN  ] %s\n", test.name);
+        const bool passed = test.func();
+        printf("[ %s ] %s\n", passed ? " OK " : "FAIL", test.name);
+        ran++;
+        failed += passed ? 0 : 1;
+    }
+
+    printf("%zu/%zu tests passed\n", ran - failed, ran);
+    return failed > 0 ? 1 : 0;
+}
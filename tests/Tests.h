@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+namespace JCore::Tests {
+    using TestFunc = bool(*)();
+
+    struct TestCase {
+        const char* name;
+        TestFunc func;
+    };
+
+    std::vector<TestCase>& getTests();
+
+    struct TestRegistrar {
+        TestRegistrar(const char* name, TestFunc func) { getTests().push_back({ name, func }); }
+    };
+}
+
+//Defines a test that returns true when it passes, tests register themselves before main runs
+#define JCORE_TEST(NAME) \
+    static bool NAME(); \
+    static ::JCore::Tests::TestRegistrar NAME##_registrar(#NAME, NAME); \
+    static bool NAME()
+
+#define JCORE_CHECK(CHECK) \
+    if (!(CHECK)) { \
+        printf("    %s:%d: check failed: %s\n", __FILE__, __LINE__, #CHECK); \
+        return false; \
+    }